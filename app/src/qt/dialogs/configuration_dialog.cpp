@@ -605,6 +605,11 @@ ConfigurationDialog::MindTab::MindTab(QWidget *parent)
     distributorSleepIntervalSpin->setMinimum(1);
     distributorSleepIntervalSpin->setMaximum(10000);
 
+    autolinkingTimeLimitLabel = new QLabel(tr("Autolinking time limit (0 - 60.000ms, 0 is unlimited)")+":", this);
+    autolinkingTimeLimitSpin = new QSpinBox(this);
+    autolinkingTimeLimitSpin->setMinimum(0);
+    autolinkingTimeLimitSpin->setMaximum(Configuration::MAX_AUTOLINKING_TIME_LIMIT);
+
     // assembly
     QVBoxLayout* pLayout = new QVBoxLayout{this};
     pLayout->addWidget(saveReadsMetadataCheck);
@@ -617,9 +622,16 @@ ConfigurationDialog::MindTab::MindTab(QWidget *parent)
     QGroupBox* nGroup = new QGroupBox{tr("Notifications"), this};
     nGroup->setLayout(nLayout);
 
+    QVBoxLayout* aLayout = new QVBoxLayout{this};
+    aLayout->addWidget(autolinkingTimeLimitLabel);
+    aLayout->addWidget(autolinkingTimeLimitSpin);
+    QGroupBox* aGroup = new QGroupBox{tr("Autolinking"), this};
+    aGroup->setLayout(aLayout);
+
     QVBoxLayout* boxesLayout = new QVBoxLayout{this};
     boxesLayout->addWidget(pGroup);
     boxesLayout->addWidget(nGroup);
+    boxesLayout->addWidget(aGroup);
     boxesLayout->addStretch();
     setLayout(boxesLayout);
 }
@@ -629,18 +641,22 @@ ConfigurationDialog::MindTab::~MindTab()
     delete saveReadsMetadataCheck;
     delete distributorSleepIntervalLabel;
     delete distributorSleepIntervalSpin;
+    delete autolinkingTimeLimitLabel;
+    delete autolinkingTimeLimitSpin;
 }
 
 void ConfigurationDialog::MindTab::refresh()
 {
     saveReadsMetadataCheck->setChecked(config.isSaveReadsMetadata());
     distributorSleepIntervalSpin->setValue(config.getDistributorSleepInterval());
+    autolinkingTimeLimitSpin->setValue(config.getAutolinkingTimeLimit());
 }
 
 void ConfigurationDialog::MindTab::save()
 {
     config.setSaveReadsMetadata(saveReadsMetadataCheck->isChecked());
     config.setDistributorSleepInterval(distributorSleepIntervalSpin->value());
+    config.setAutolinkingTimeLimit(autolinkingTimeLimitSpin->value());
 }
 
 /*
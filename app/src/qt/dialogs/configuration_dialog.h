@@ -81,6 +81,8 @@ private:
     QCheckBox* saveReadsMetadataCheck;
     QLabel* distributorSleepIntervalLabel;
     QSpinBox*  distributorSleepIntervalSpin;
+    QLabel* autolinkingTimeLimitLabel;
+    QSpinBox*  autolinkingTimeLimitSpin;
 
 public:
     explicit MindTab(QWidget* parent);
@@ -99,10 +99,13 @@ void AsyncTaskNotificationsDistributor::run()
             mwp->getMind()->meditateAssociations();
 
             /*
-             * AA FTS algorithm
+             * AA FTS and TF-IDF algorithms - SYNCHRONOUS
              */
 
-            if(Configuration::getInstance().getAaAlgorithm()==Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS) {
+            if(Configuration::getInstance().getAaAlgorithm()==Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS
+                 ||
+               Configuration::getInstance().getAaAlgorithm()==Configuration::AssociationAssessmentAlgorithm::TF_IDF)
+            {
 
                 if(Configuration::getInstance().getMindState()==Configuration::MindState::THINKING) {
 
@@ -82,6 +82,10 @@ MainMenuPresenter::MainMenuPresenter(MainWindowPresenter* mwp)
         view->actionMindExportCsv, SIGNAL(triggered()),
         mwp, SLOT(doActionMindCsvExport())
     );
+    QObject::connect(
+        view->actionMindExportHtml, SIGNAL(triggered()),
+        mwp, SLOT(doActionMindHtmlExport())
+    );
     QObject::connect(
         view->actionExit, SIGNAL(triggered()),
         mwp, SLOT(doActionExit())
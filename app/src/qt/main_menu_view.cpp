@@ -112,6 +112,9 @@ MainMenuView::MainMenuView(MainWindowView& mainWindowView)
     actionMindExportCsv = new QAction(tr("&CSV"), mainWindow);
     actionMindExportCsv->setStatusTip(tr("Export all Notebooks/Markdown files as a single CSV file"));
     submenuMindExport->addAction(actionMindExportCsv);
+    actionMindExportHtml = new QAction(tr("&HTML"), mainWindow);
+    actionMindExportHtml->setStatusTip(tr("Export all Notebooks/Markdown files to HTML files in a directory - only changed Notebooks are exported again"));
+    submenuMindExport->addAction(actionMindExportHtml);
 
     actionExit = new QAction(QIcon(":/menu-icons/exit.svg"), tr("E&xit"), mainWindow);
     actionExit->setShortcut(QKeySequence(Qt::CTRL+Qt::Key_Q));
@@ -83,6 +83,7 @@ public:
     QAction* actionMindPreferences;
     QMenu* submenuMindExport;
     QAction* actionMindExportCsv;
+    QAction* actionMindExportHtml;
     QAction* actionExit;
 
     // menu: Find
@@ -712,6 +712,26 @@ void MainWindowPresenter::doActionMindRelearn(QString path)
 
 void MainWindowPresenter::doActionExit()
 {
+    // barrier: wait for Os which are being written in background
+    vector<string> unsaved{};
+    if(!mind->remind().flush(&unsaved)) {
+        QString notebooks{};
+        for(const string& k:unsaved) {
+            notebooks += "\n";
+            notebooks += QString::fromStdString(k);
+        }
+        QMessageBox::StandardButton choice = QMessageBox::critical(
+            &view,
+            tr("Exit"),
+            tr("Unable to save the following notebooks - changes will be lost:\n%1\n\nDo you want to exit anyway?").arg(notebooks),
+            QMessageBox::Yes|QMessageBox::No,
+            QMessageBox::No);
+        if(choice != QMessageBox::Yes) {
+            // unsaved Os are dirty - user can fix the problem and save them again
+            return;
+        }
+    }
+
     QApplication::quit();
 }
 
@@ -2189,6 +2209,49 @@ void MainWindowPresenter::handleMindCsvExport()
     }
 }
 
+void MainWindowPresenter::doActionMindHtmlExport()
+{
+    QString homeDirectory
+        = QStandardPaths::locate(QStandardPaths::HomeLocation, QString(), QStandardPaths::LocateDirectory);
+
+    QFileDialog exportDialog{&view};
+    exportDialog.setWindowTitle(tr("Export to HTML Directory"));
+    exportDialog.setFileMode(QFileDialog::Directory);
+    exportDialog.setDirectory(homeDirectory);
+    exportDialog.setViewMode(QFileDialog::Detail);
+
+    if(exportDialog.exec() && exportDialog.selectedFiles().size()==1) {
+        string directory{exportDialog.selectedFiles()[0].toStdString()};
+        // exported HTML files must not be learned as a part of the memory
+        if(directory == config.getMemoryPath()
+           || stringStartsWith(directory, config.getMemoryPath()+FILE_PATH_SEPARATOR))
+        {
+            QMessageBox::critical(
+                &view,
+                tr("Export Error"),
+                tr("Notebooks cannot be exported to the memory directory!")
+            );
+            return;
+        }
+
+        // incremental - Os which were not changed since the last export to the directory are skipped
+        StatusBarProgressCallbackCtx callbackCtx{statusBar};
+        if(mind->remind().exportToHtml(directory, true, &callbackCtx)) {
+            statusBar->showInfo(
+                "Export to HTML directory '"
+                + directory
+                + "' successfully finished"
+            );
+        } else {
+            statusBar->showError(
+                "Export to HTML directory '"
+                + directory
+                + "' failed - some Notebooks could not be written"
+            );
+        }
+    } // else directory closed / nothing choosen
+}
+
 void MainWindowPresenter::doActionOutlineTWikiImport()
 {
     QString homeDirectory
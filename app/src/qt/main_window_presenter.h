@@ -208,6 +208,7 @@ public slots:
     void doActionMindSnapshot();
     void doActionMindCsvExport();
     void handleMindCsvExport();
+    void doActionMindHtmlExport();
     void doActionExit();
     // recall
     void doActionFts();
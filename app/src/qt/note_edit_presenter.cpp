@@ -91,9 +91,6 @@ void NoteEditPresenter::slotSaveNote()
             name.assign(view->getName().toStdString());
         }
 
-        // ensure autolinking indices are updated on N rename
-        mwp->getMind()->autolinkUpdate(currentNote->getName(), view->getName().toStdString());
-
         currentNote->setName(name);
 
         if(!view->isDescriptionEmpty()) {
@@ -18,6 +18,10 @@
 */
 #include "note_view.h"
 
+#ifndef MF_QT_WEB_ENGINE
+  #include <QWebFrame>
+#endif
+
 namespace m8r {
 
 using namespace std;
@@ -182,4 +186,20 @@ void NoteView::slotOpenEditor()
     emit signalOpenEditor();
 }
 
+void NoteView::patchHtml(const QString& javaScript)
+{
+#ifdef MF_QT_WEB_ENGINE
+    // WebEngine: JavaScript is evaluated asynchronously
+    noteViewer->page()->runJavaScript(javaScript, [this](const QVariant& result) {
+        if(!result.toBool()) {
+            emit signalPatchHtmlFailed();
+        }
+    });
+#else
+    if(!noteViewer->page()->mainFrame()->evaluateJavaScript(javaScript).toBool()) {
+        emit signalPatchHtmlFailed();
+    }
+#endif
+}
+
 } // m8r namespace
@@ -98,6 +98,12 @@ public:
     void setHtml(const QString& html, const QUrl& baseUrl = QUrl()) {
         noteViewer->setHtml(html, baseUrl);
     }
+    /**
+     * @brief Patch loaded HTML using JavaScript (evaluating to true on success).
+     *
+     * signalPatchHtmlFailed() is emitted if JavaScript cannot be applied.
+     */
+    void patchHtml(const QString& javaScript);
     void giveViewerFocus() {
         QMetaObject::invokeMethod(
             noteViewer, "setFocus",
@@ -112,6 +118,7 @@ private slots:
     void slotOpenEditor();
 
 signals:
+    void signalPatchHtmlFailed();
     void signalOpenEditor();
 };
 
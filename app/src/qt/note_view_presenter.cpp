@@ -42,6 +42,7 @@ NoteViewPresenter::NoteViewPresenter(NoteView* view, OrlojPresenter* orloj)
         = orloj->getMainPresenter()->getMarkdownRepresentation();
     this->htmlRepresentation
         = orloj->getMainPresenter()->getHtmlRepresentation();
+    this->livePreview = new HtmlLivePreview{*htmlRepresentation};
 
     this->currentNote = nullptr;
 
@@ -63,12 +64,16 @@ NoteViewPresenter::NoteViewPresenter(NoteView* view, OrlojPresenter* orloj)
     QObject::connect(
         view->getViever(), SIGNAL(signalFromViewNoteToOutlines()),
         orloj, SLOT(slotShowOutlines()));
+    QObject::connect(
+        view, SIGNAL(signalPatchHtmlFailed()),
+        this, SLOT(slotRefreshLivePreviewReload()));
 }
 
 NoteViewPresenter::~NoteViewPresenter()
 {
     if(markdownRepresentation) delete markdownRepresentation;
     if(htmlRepresentation) delete htmlRepresentation;
+    if(livePreview) delete livePreview;
 }
 
 void NoteViewPresenter::refreshLivePreview()
@@ -100,14 +105,17 @@ void NoteViewPresenter::refreshLivePreview()
     }
 #endif
 
-    // refresh N HTML view (autolinking intentionally disabled)
-    htmlRepresentation->to(
-        &auxNote,
-        &html,
-        false,
-        static_cast<int>(yScrollPct)
-    );
-    view->setHtml(QString::fromStdString(html));
+    // refresh N HTML view (autolinking intentionally disabled) - loaded page is patched
+    // w/ changed Markdown blocks only (no reload > no flickering, scroll position kept)
+    string js{};
+    if(livePreview->to(&auxNote, html, js, static_cast<int>(yScrollPct))) {
+        // WebEngine: patch scrolls the page (JavaScript), WebView: scrolled below
+        if(js.size()) {
+            view->patchHtml(QString::fromStdString(js));
+        }
+    } else {
+        view->setHtml(QString::fromStdString(html));
+    }
 
     // IMPROVE share code between O header and N
 #if !defined(_WIN32) && !defined(__APPLE__) && !defined(MF_QT_WEB_ENGINE)
@@ -135,13 +143,28 @@ void NoteViewPresenter::refresh(Note* note)
     this->currentNote = note;
 
     // HTML
+    const unsigned autolinkingIncomplete = htmlRepresentation->getAutolinkingIncompleteCount();
     htmlRepresentation->to(note, &html, Configuration::getInstance().isAutolinking());
+    livePreview->reset();
     view->setHtml(QString::fromStdString(html));
+    if(htmlRepresentation->getAutolinkingIncompleteCount() != autolinkingIncomplete) {
+        orloj->getMainPresenter()->getStatusBar()->showInfo(
+            tr("Autolinking time limit exceeded - only the beginning of the text was autolinked"));
+    }
 
     // leaderboard
     mind->associate();
 }
 
+void NoteViewPresenter::slotRefreshLivePreviewReload()
+{
+    MF_DEBUG("N HTML preview patch failed - reloading" << endl);
+    livePreview->reset();
+    if(currentNote) {
+        refreshLivePreview();
+    }
+}
+
 void NoteViewPresenter::slotLinkClicked(const QUrl& url)
 {
     orloj->getMainPresenter()->handleNoteViewLinkClicked(url);
@@ -20,6 +20,7 @@
 #define M8RUI_NOTE_VIEW_PRESENTER_H
 
 #include "../../lib/src/mind/mind.h"
+#include "../../lib/src/representations/html/html_live_preview.h"
 
 #include <QtWidgets>
 
@@ -52,6 +53,7 @@ private:
 
     MarkdownOutlineRepresentation* markdownRepresentation;
     HtmlOutlineRepresentation* htmlRepresentation;
+    HtmlLivePreview* livePreview;
 
     Note* currentNote;
 
@@ -81,6 +83,7 @@ public:
     void setSearchIgnoreCase(bool ignoreCase) { searchIgnoreCase = ignoreCase; }
 
 public slots:
+    void slotRefreshLivePreviewReload();
     void slotLinkClicked(const QUrl& url);
     void slotEditNote();
     void slotEditNoteDoubleClick();
@@ -881,7 +881,8 @@ void OrlojPresenter::slotGetLinksForPattern(const QString& pattern)
         &thingsNames,
         &prefix,
         ThingNameSerialization::LINK,
-        currentOutline);
+        currentOutline,
+        LINK_COMPLETION_LIMIT);
 
     vector<string>* links = new vector<string>{};
     *links = thingsNames;
@@ -97,6 +97,10 @@ class OrlojPresenter : public QObject
 {
     Q_OBJECT
 
+public:
+    // link completion popup shows only this many (name sorted) matches
+    static constexpr int LINK_COMPLETION_LIMIT = 100;
+
 private:
     MainWindowPresenter* mainPresenter;
 
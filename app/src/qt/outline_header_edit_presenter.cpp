@@ -88,9 +88,6 @@ void OutlineHeaderEditPresenter::slotSaveOutlineHeader()
             name.assign(view->getName().toStdString());
         }
 
-        // ensure autolinking indices are updated on O rename
-        mwp->getMind()->autolinkUpdate(currentOutline->getName(), view->getName().toStdString());
-
         currentOutline->setName(name);
 
         if(!view->isDescriptionEmpty()) {
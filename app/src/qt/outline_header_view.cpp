@@ -18,6 +18,10 @@
 */
 #include "outline_header_view.h"
 
+#ifndef MF_QT_WEB_ENGINE
+  #include <QWebFrame>
+#endif
+
 namespace m8r {
 
 using namespace std;
@@ -181,4 +185,20 @@ void OutlineHeaderView::slotOpenEditor()
     emit signalOpenEditor();
 }
 
+void OutlineHeaderView::patchHtml(const QString& javaScript)
+{
+#ifdef MF_QT_WEB_ENGINE
+    // WebEngine: JavaScript is evaluated asynchronously
+    headerViewer->page()->runJavaScript(javaScript, [this](const QVariant& result) {
+        if(!result.toBool()) {
+            emit signalPatchHtmlFailed();
+        }
+    });
+#else
+    if(!headerViewer->page()->mainFrame()->evaluateJavaScript(javaScript).toBool()) {
+        emit signalPatchHtmlFailed();
+    }
+#endif
+}
+
 } // m8r namespace
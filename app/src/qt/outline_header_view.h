@@ -99,6 +99,12 @@ public:
     void setHtml(const QString& html, const QUrl& baseUrl = QUrl()) {
         headerViewer->setHtml(html, baseUrl);
     }
+    /**
+     * @brief Patch loaded HTML using JavaScript (evaluating to true on success).
+     *
+     * signalPatchHtmlFailed() is emitted if JavaScript cannot be applied.
+     */
+    void patchHtml(const QString& javaScript);
     void giveViewerFocus() {
         QMetaObject::invokeMethod(
             headerViewer, "setFocus",
@@ -113,6 +119,7 @@ private slots:
     void slotOpenEditor();
 
 signals:
+    void signalPatchHtmlFailed();
     void signalOpenEditor();
 };
 
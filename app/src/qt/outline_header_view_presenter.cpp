@@ -33,6 +33,9 @@ OutlineHeaderViewPresenter::OutlineHeaderViewPresenter(
 
     this->htmlRepresentation
         = orloj->getMainPresenter()->getHtmlRepresentation();
+    this->livePreview = new HtmlLivePreview{*htmlRepresentation};
+
+    this->currentOutline = nullptr;
 
     // IMPORTANT: pre-allocate string using reserve() to ensure good append performance
     html = string{};
@@ -53,11 +56,19 @@ OutlineHeaderViewPresenter::OutlineHeaderViewPresenter(
     QObject::connect(
         view, SIGNAL(signalOpenEditor()),
         this, SLOT(slotEditOutlineHeader()));
+    QObject::connect(
+        view, SIGNAL(signalPatchHtmlFailed()),
+        this, SLOT(slotRefreshLivePreviewReload()));
     QObject::connect(
         view->getViever(), SIGNAL(signalFromViewOutlineHeaderToOutlines()),
         orloj, SLOT(slotShowOutlines()));
 }
 
+OutlineHeaderViewPresenter::~OutlineHeaderViewPresenter()
+{
+    if(livePreview) delete livePreview;
+}
+
 void OutlineHeaderViewPresenter::refreshLivePreview()
 {
     MF_DEBUG("Refreshing O header HTML preview from editor: " << currentOutline->getName() << endl);
@@ -88,17 +99,17 @@ void OutlineHeaderViewPresenter::refreshLivePreview()
     }
 #endif
 
-    // refresh O header HTML view (autolinking intentionally disabled)
-    htmlRepresentation->to(
-        &auxOutline,
-        &html,
-        false,
-        false,
-        false,
-        true,
-        static_cast<int>(yScrollPct)
-    );
-    view->setHtml(QString::fromStdString(html));
+    // refresh O header HTML view (autolinking intentionally disabled) - loaded page is patched
+    // w/ changed Markdown blocks only (no reload > no flickering, scroll position kept)
+    string js{};
+    if(livePreview->to(&auxOutline, html, js, static_cast<int>(yScrollPct))) {
+        // WebEngine: patch scrolls the page (JavaScript), WebView: scrolled below
+        if(js.size()) {
+            view->patchHtml(QString::fromStdString(js));
+        }
+    } else {
+        view->setHtml(QString::fromStdString(html));
+    }
 
     // IMPROVE share code between O header and N
 #if !defined(__APPLE__) && !defined(_WIN32) && !defined(MF_QT_WEB_ENGINE)
@@ -124,6 +135,7 @@ void OutlineHeaderViewPresenter::refresh(Outline* outline)
     currentOutline = outline;
 
     // IMPROVE consider TOC injection
+    const unsigned autolinkingIncomplete = htmlRepresentation->getAutolinkingIncompleteCount();
     htmlRepresentation->to(
         outline,
         &html,
@@ -134,11 +146,25 @@ void OutlineHeaderViewPresenter::refresh(Outline* outline)
     );
 
     view->setHtml(QString::fromStdString(html));
+    livePreview->reset();
+    if(htmlRepresentation->getAutolinkingIncompleteCount() != autolinkingIncomplete) {
+        orloj->getMainPresenter()->getStatusBar()->showInfo(
+            tr("Autolinking time limit exceeded - only the beginning of the text was autolinked"));
+    }
 
     // leaderboard
     orloj->getMind()->associate();
 }
 
+void OutlineHeaderViewPresenter::slotRefreshLivePreviewReload()
+{
+    MF_DEBUG("O header HTML preview patch failed - reloading" << endl);
+    livePreview->reset();
+    if(currentOutline) {
+        refreshLivePreview();
+    }
+}
+
 void OutlineHeaderViewPresenter::slotLinkClicked(const QUrl& url)
 {
     orloj->getMainPresenter()->handleNoteViewLinkClicked(url);
@@ -45,6 +45,7 @@ private:
     OutlineHeaderView* view;
     OrlojPresenter* orloj;
     HtmlOutlineRepresentation* htmlRepresentation;
+    HtmlLivePreview* livePreview;
 
 public:
     explicit OutlineHeaderViewPresenter(OutlineHeaderView* view, OrlojPresenter* orloj);
@@ -52,7 +53,7 @@ public:
     OutlineHeaderViewPresenter(const OutlineHeaderViewPresenter&&) = delete;
     OutlineHeaderViewPresenter &operator=(const OutlineHeaderViewPresenter&) = delete;
     OutlineHeaderViewPresenter &operator=(const OutlineHeaderViewPresenter&&) = delete;
-    ~OutlineHeaderViewPresenter() = default;
+    ~OutlineHeaderViewPresenter();
 
     /**
      * @brief Refresh live preview.
@@ -63,6 +64,7 @@ public:
     void refreshCurrent() { refresh(currentOutline); }
 
 public slots:
+    void slotRefreshLivePreviewReload();
     void slotLinkClicked(const QUrl& url);
     void slotEditOutlineHeader();
     void slotEditOutlineHeaderDoubleClick();
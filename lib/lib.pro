@@ -84,6 +84,9 @@ SOURCES += \
     ./src/model/stencil.cpp \
     ./src/model/tag.cpp \
     ./src/persistence/filesystem_persistence.cpp \
+    ./src/persistence/html_repository_export.cpp \
+    ./src/persistence/write_behind_queue.cpp \
+    ./src/representations/html/html_live_preview.cpp \
     ./src/representations/html/html_outline_representation.cpp \
     ./src/representations/markdown/markdown_ast_node.cpp \
     ./src/representations/markdown/markdown_lexem.cpp \
@@ -132,9 +135,17 @@ SOURCES += \
     src/mind/ai/nn/genann.c \
     src/mind/ai/nlp/word_frequency_list.cpp \
     src/gear/trie.cpp \
+    src/gear/aho_corasick.cpp \
+    src/gear/priority_executor.cpp \
+    src/gear/worker_pool.cpp \
+    src/gear/mapped_file.cpp \
     src/mind/ai/nlp/stemmer/stemmer.cpp \
+    src/mind/ai/aa_neighbor_store.cpp \
+    src/mind/ai/aa_minhash_lsh.cpp \
+    src/mind/ai/aa_bow_model.cpp \
     src/mind/ai/ai_aa_bow.cpp \
     src/mind/ai/ai_aa_weighted_fts.cpp \
+    src/mind/ai/ai_aa_tf_idf.cpp \
     src/mind/ai/aa_notes_feature.cpp \
     src/mind/ai/nlp/common_words_blacklist.cpp \
     src/mind/aspect/tag_scope_aspect.cpp \
@@ -149,7 +160,9 @@ SOURCES += \
     src/mind/ai/autolinking/naive_autolinking_preprocessor.cpp \
     src/representations/markdown/cmark_gfm_markdown_transcoder.cpp \
     src/mind/ai/autolinking/autolinking_mind.cpp \
+    src/mind/ai/autolinking/autolinking_index.cpp \
     src/mind/limbo.cpp \
+    src/mind/things_completion_index.cpp \
     src/representations/unicode.cpp
 
 !mfnomd2html {
@@ -189,7 +202,10 @@ HEADERS += \
     ./src/model/stencil.h \
     ./src/model/tag.h \
     ./src/persistence/filesystem_persistence.h \
+    ./src/persistence/html_repository_export.h \
     ./src/persistence/persistence.h \
+    ./src/persistence/write_behind_queue.h \
+    ./src/representations/html/html_live_preview.h \
     ./src/representations/html/html_outline_representation.h \
     ./src/representations/markdown/markdown_ast_node.h \
     ./src/representations/markdown/markdown_lexem.h \
@@ -246,6 +262,10 @@ HEADERS += \
     src/mind/ai/nn/genann.h \
     src/mind/ai/nlp/word_frequency_list.h \
     src/gear/trie.h \
+    src/gear/aho_corasick.h \
+    src/gear/priority_executor.h \
+    src/gear/worker_pool.h \
+    src/gear/mapped_file.h \
     src/mind/ai/nlp/char_provider.h \
     src/mind/ai/nlp/stemmer/stemmer.h \
     src/mind/ai/nlp/stemmer/stemming/danish_stem.h \
@@ -266,8 +286,12 @@ HEADERS += \
     src/mind/ai/nlp/stemmer/utilities/debug_logic.h \
     src/mind/ai/nlp/stemmer/utilities/safe_math.h \
     src/mind/ai/nlp/stemmer/utilities/utilities.h \
+    src/mind/ai/aa_neighbor_store.h \
+    src/mind/ai/aa_minhash_lsh.h \
+    src/mind/ai/aa_bow_model.h \
     src/mind/ai/ai_aa_bow.h \
     src/mind/ai/ai_aa_weighted_fts.h \
+    src/mind/ai/ai_aa_tf_idf.h \
     src/mind/ai/aa_model.h \
     src/mind/ai/aa_notes_feature.h \
     src/mind/ai/ai_aa.h \
@@ -287,7 +311,9 @@ HEADERS += \
     src/definitions.h \
     src/representations/markdown/cmark_gfm_markdown_transcoder.h \
     src/mind/ai/autolinking/autolinking_mind.h \
-    src/mind/limbo.h
+    src/mind/ai/autolinking/autolinking_index.h \
+    src/mind/limbo.h \
+    src/mind/things_completion_index.h
 
 !mfnomd2html {
     SOURCES += \
@@ -47,8 +47,12 @@ Configuration::Configuration()
       autolinking{DEFAULT_AUTOLINKING},
       autolinkingColonSplit{},
       autolinkingCaseInsensitive{},
+      autolinkingTimeLimit{DEFAULT_AUTOLINKING_TIME_LIMIT},
       md2HtmlOptions{},
       distributorSleepInterval{DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL},
+      aaWorkers{DEFAULT_AA_WORKERS},
+      aaLshBands{DEFAULT_AA_LSH_BANDS},
+      aaLshNotesThreshold{DEFAULT_AA_LSH_NOTES_THRESHOLD},
       markdownQuoteSections{},
       uiNerdTargetAudience{DEFAULT_UI_NERD_MENU},
       uiHtmlZoom{},
@@ -140,6 +144,7 @@ void Configuration::clear()
     autolinking = DEFAULT_AUTOLINKING;
     autolinkingColonSplit = DEFAULT_AUTOLINKING_COLON_SPLIT;
     autolinkingCaseInsensitive = DEFAULT_AUTOLINKING_CASE_INSENSITIVE;
+    autolinkingTimeLimit = DEFAULT_AUTOLINKING_TIME_LIMIT;
     timeScopeAsString.assign(DEFAULT_TIME_SCOPE);
     tagsScope.clear();
     markdownQuoteSections = DEFAULT_MD_QUOTE_SECTIONS;
@@ -160,9 +165,15 @@ void Configuration::clear()
     case AssociationAssessmentAlgorithm::BOW:
         asyncMindThreshold = DEFAULT_ASYNC_MIND_THRESHOLD_BOW;
         break;
+    case AssociationAssessmentAlgorithm::TF_IDF:
+        asyncMindThreshold = DEFAULT_ASYNC_MIND_THRESHOLD_TF_IDF;
+        break;
     }
 
     distributorSleepInterval = DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL;
+    aaWorkers = DEFAULT_AA_WORKERS;
+    aaLshBands = DEFAULT_AA_LSH_BANDS;
+    aaLshNotesThreshold = DEFAULT_AA_LSH_NOTES_THRESHOLD;
 
     // GUI
     uiNerdTargetAudience = false;
@@ -272,6 +283,8 @@ void Configuration::setActiveRepository(
             limboPath.clear();
             limboPath += activeRepository->getDir();
 
+            mindPath.clear();
+
             if(repository->getType()==Repository::RepositoryType::MINDFORGER
                  &&
                repository->getMode()==Repository::RepositoryMode::REPOSITORY)
@@ -283,6 +296,10 @@ void Configuration::setActiveRepository(
                 limboPath+=FILE_PATH_SEPARATOR;
                 limboPath+=DIRNAME_LIMBO;
 
+                mindPath += activeRepository->getDir();
+                mindPath += FILE_PATH_SEPARATOR;
+                mindPath += DIRNAME_MIND;
+
                 // setting ACTIVE repository means that repository SPECIFIC configuration must be loaded
                 this->initRepositoryConfiguration(EisenhowerMatrix::createEisenhowMatrixOrganizer());
                 persistence.load(*this);
@@ -57,6 +57,8 @@ constexpr const auto DIRNAME_LIMBO = "limbo";
 constexpr const auto DIRNAME_STENCILS = "stencils";
 constexpr const auto DIRNAME_OUTLINES = "notebooks";
 constexpr const auto DIRNAME_NOTES = "notes";
+// hidden repository directory w/ data derived from memory (learned models, ...)
+constexpr const auto DIRNAME_M8R_CACHE = ".mindforger";
 
 constexpr const auto UI_THEME_DARK = "dark";
 constexpr const auto UI_THEME_LIGHT = "light";
@@ -149,7 +151,8 @@ public:
 
     enum AssociationAssessmentAlgorithm {
         BOW,
-        WEIGHTED_FTS
+        WEIGHTED_FTS,
+        TF_IDF
     };
 
     enum JavaScriptLibSupport {
@@ -176,7 +179,18 @@ public:
 
     static constexpr const int DEFAULT_ASYNC_MIND_THRESHOLD_BOW = 200;
     static constexpr const int DEFAULT_ASYNC_MIND_THRESHOLD_WEIGHTED_FTS = 20000;
+    static constexpr const int DEFAULT_ASYNC_MIND_THRESHOLD_TF_IDF = 20000;
     static constexpr const int DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL = 500;
+    // 0 ~ number of AI workers derived from number of CPUs
+    static constexpr const int DEFAULT_AA_WORKERS = 0;
+    static constexpr const int MAX_AA_WORKERS = 256;
+    // MinHash LSH bands used to pick AA candidates on big repositories (0 ~ exact AA),
+    // 16 bands ~ recall@10 0.96 (Ns of the same O are always candidates)
+    static constexpr const int DEFAULT_AA_LSH_BANDS = 16;
+    static constexpr const int MAX_AA_LSH_BANDS = 256;
+    // repositories w/ more Ns assess AA of LSH candidates only (exact AA row is O(n))
+    static constexpr const int DEFAULT_AA_LSH_NOTES_THRESHOLD = 2000;
+    static constexpr const int MAX_AA_LSH_NOTES_THRESHOLD = 10000000;
 
     static const std::string DEFAULT_ACTIVE_REPOSITORY_PATH;
     static const std::string DEFAULT_TIME_SCOPE;
@@ -184,6 +198,8 @@ public:
     static constexpr const bool DEFAULT_AUTOLINKING = false;
     static constexpr const bool DEFAULT_AUTOLINKING_COLON_SPLIT = true;
     static constexpr const bool DEFAULT_AUTOLINKING_CASE_INSENSITIVE = true;
+    static constexpr const int DEFAULT_AUTOLINKING_TIME_LIMIT = 250;
+    static constexpr const int MAX_AUTOLINKING_TIME_LIMIT = 60000;
     static constexpr const bool DEFAULT_SAVE_READS_METADATA = true;
 
     static constexpr const bool UI_DEFAULT_NERD_TARGET_AUDIENCE = true;
@@ -239,6 +255,7 @@ private:
     // active repository memory, limbo, ... paths (efficiency)
     std::string memoryPath;
     std::string limboPath;
+    std::string mindPath; // learned AI data (MF repository only)
 
     // repository configuration (when in repository mode)
     RepositoryConfiguration* repositoryConfiguration;
@@ -249,12 +266,16 @@ private:
     bool autolinking; // enable MD autolinking
     bool autolinkingColonSplit;
     bool autolinkingCaseInsensitive;
+    int autolinkingTimeLimit; // autolinking latency budget per rendering in ms (0 ~ unlimited)
     TimeScope timeScope;
     std::string timeScopeAsString;
     std::vector<std::string> tagsScope;
     unsigned int md2HtmlOptions;
     AssociationAssessmentAlgorithm aaAlgorithm;
     int distributorSleepInterval;
+    int aaWorkers; // number of threads used by AA computations (0 ~ auto)
+    int aaLshBands; // AA recall/speed knob: more bands ~ higher recall (0 ~ exact)
+    int aaLshNotesThreshold; // LSH is used by repositories w/ more Ns
     bool markdownQuoteSections;
 
     // GUI configuration
@@ -322,6 +343,7 @@ public:
 
     const std::string& getMemoryPath() const { return memoryPath; }
     const std::string& getLimboPath() const { return limboPath; }
+    const std::string& getMindPath() const { return mindPath; }
     const char* getRepositoryPathFromEnv();
     /**
      * @brief Create empty Markdown file.
@@ -392,11 +414,19 @@ public:
     void setAutolinkingColonSplit(bool autolinkingColonSplit) { this->autolinkingColonSplit=autolinkingColonSplit; }
     bool isAutolinkingCaseInsensitive() const { return autolinkingCaseInsensitive; }
     void setAutolinkingCaseInsensitive(bool autolinkingCaseInsensitive) { this->autolinkingCaseInsensitive=autolinkingCaseInsensitive; }
+    int getAutolinkingTimeLimit() const { return autolinkingTimeLimit; }
+    void setAutolinkingTimeLimit(int autolinkingTimeLimit) { this->autolinkingTimeLimit = autolinkingTimeLimit; }
     unsigned int getMd2HtmlOptions() const { return md2HtmlOptions; }
     AssociationAssessmentAlgorithm getAaAlgorithm() const { return aaAlgorithm; }
     void setAaAlgorithm(AssociationAssessmentAlgorithm aaa) { aaAlgorithm = aaa; }
     int getDistributorSleepInterval() const { return distributorSleepInterval; }
     void setDistributorSleepInterval(int sleepInterval) { distributorSleepInterval = sleepInterval; }
+    int getAaWorkers() const { return aaWorkers; }
+    void setAaWorkers(int aaWorkers) { this->aaWorkers = aaWorkers; }
+    int getAaLshBands() const { return aaLshBands; }
+    void setAaLshBands(int aaLshBands) { this->aaLshBands = aaLshBands; }
+    int getAaLshNotesThreshold() const { return aaLshNotesThreshold; }
+    void setAaLshNotesThreshold(int aaLshNotesThreshold) { this->aaLshNotesThreshold = aaLshNotesThreshold; }
     bool isMarkdownQuoteSections() const { return markdownQuoteSections; }
     void setMarkdownQuoteSections(bool markdownQuoteSections) { this->markdownQuoteSections = markdownQuoteSections; }
 
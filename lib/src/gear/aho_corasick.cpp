@@ -0,0 +1,187 @@
+/*
+ aho_corasick.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "aho_corasick.h"
+
+#include <algorithm>
+#include <queue>
+
+namespace m8r {
+
+using namespace std;
+
+constexpr uint32_t AhoCorasick::ROOT;
+constexpr uint32_t AhoCorasick::NONE;
+constexpr uint32_t AhoCorasick::LINEAR_SEARCH_THRESHOLD;
+
+AhoCorasick::AhoCorasick()
+    : built{false}
+{
+    clear();
+}
+
+AhoCorasick::~AhoCorasick()
+{
+}
+
+void AhoCorasick::clear()
+{
+    edges.clear();
+    childrenOffsets.clear();
+    labels.clear();
+    targets.clear();
+    rootTransitions.clear();
+    failure.clear();
+    dictionary.clear();
+    outputOffsets.clear();
+    outputs.clear();
+    patternStates.clear();
+    patternLengths.clear();
+    built = false;
+
+    // root
+    edges.emplace_back();
+}
+
+int AhoCorasick::addPattern(const string& pattern)
+{
+    if(built || pattern.empty()) {
+        return -1;
+    }
+
+    uint32_t state = ROOT;
+    for(char ch:pattern) {
+        const unsigned char c = static_cast<unsigned char>(ch);
+        uint32_t next = NONE;
+        for(const pair<unsigned char,uint32_t>& e:edges[state]) {
+            if(e.first == c) {
+                next = e.second;
+                break;
+            }
+        }
+        if(next == NONE) {
+            next = static_cast<uint32_t>(edges.size());
+            edges[state].push_back(make_pair(c, next));
+            // emplace_back() reallocates edges > edges[state] reference must not be kept
+            edges.emplace_back();
+        }
+        state = next;
+    }
+
+    patternStates.push_back(state);
+    patternLengths.push_back(pattern.size());
+    return static_cast<int>(patternLengths.size()-1);
+}
+
+void AhoCorasick::build()
+{
+    if(built) {
+        return;
+    }
+
+    const size_t states = edges.size();
+
+    // children segments w/ sorted labels
+    childrenOffsets.assign(1, 0);
+    for(size_t s=0; s<states; s++) {
+        vector<pair<unsigned char,uint32_t>>& children = edges[s];
+        sort(children.begin(), children.end());
+        for(const pair<unsigned char,uint32_t>& e:children) {
+            labels.push_back(e.first);
+            targets.push_back(e.second);
+        }
+        childrenOffsets.push_back(static_cast<uint32_t>(labels.size()));
+    }
+    edges.clear();
+    edges.shrink_to_fit();
+
+    // own outputs of states
+    vector<uint32_t> stateOutputsCounts(states, 0);
+    for(uint32_t state:patternStates) {
+        stateOutputsCounts[state]++;
+    }
+    outputOffsets.assign(states+1, 0);
+    for(size_t s=0; s<states; s++) {
+        outputOffsets[s+1] = outputOffsets[s] + stateOutputsCounts[s];
+    }
+    outputs.resize(patternStates.size());
+    vector<uint32_t> cursors(outputOffsets.begin(), outputOffsets.end()-1);
+    for(size_t p=0; p<patternStates.size(); p++) {
+        outputs[cursors[patternStates[p]]++] = static_cast<int32_t>(p);
+    }
+    patternStates.clear();
+
+    // dense root row - missing edges lead back to root
+    rootTransitions.assign(256, ROOT);
+    for(uint32_t i=childrenOffsets[ROOT]; i<childrenOffsets[ROOT+1]; i++) {
+        rootTransitions[labels[i]] = targets[i];
+    }
+
+    // BFS: failure of a state is the longest proper suffix which is a state,
+    // dictionary link is the nearest state on the failure chain w/ outputs
+    failure.assign(states, ROOT);
+    dictionary.assign(states, NONE);
+    queue<uint32_t> q{};
+    for(uint32_t i=childrenOffsets[ROOT]; i<childrenOffsets[ROOT+1]; i++) {
+        q.push(targets[i]);
+    }
+    while(!q.empty()) {
+        uint32_t state = q.front();
+        q.pop();
+        for(uint32_t i=childrenOffsets[state]; i<childrenOffsets[state+1]; i++) {
+            const unsigned char c = labels[i];
+            const uint32_t child = targets[i];
+
+            uint32_t f = failure[state];
+            uint32_t next = NONE;
+            while(f != ROOT && (next = findChild(f, c)) == NONE) {
+                f = failure[f];
+            }
+            failure[child] = f == ROOT ? rootTransitions[c] : next;
+
+            const uint32_t fc = failure[child];
+            dictionary[child] = outputOffsets[fc]<outputOffsets[fc+1] ? fc : dictionary[fc];
+
+            q.push(child);
+        }
+    }
+
+    built = true;
+}
+
+size_t AhoCorasick::getFootprint() const
+{
+    return childrenOffsets.capacity()*sizeof(uint32_t)
+           + labels.capacity()*sizeof(unsigned char)
+           + targets.capacity()*sizeof(uint32_t)
+           + rootTransitions.capacity()*sizeof(uint32_t)
+           + failure.capacity()*sizeof(uint32_t)
+           + dictionary.capacity()*sizeof(uint32_t)
+           + outputOffsets.capacity()*sizeof(uint32_t)
+           + outputs.capacity()*sizeof(int32_t)
+           + patternLengths.capacity()*sizeof(size_t);
+}
+
+void AhoCorasick::count(const string& text, vector<int>& counts) const
+{
+    match(text, [&counts](int id, size_t) {
+        counts[id]++;
+    });
+}
+
+} // m8r namespace
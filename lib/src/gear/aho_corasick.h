@@ -0,0 +1,171 @@
+/*
+ aho_corasick.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_AHO_CORASICK_H
+#define M8R_AHO_CORASICK_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../debug.h"
+
+namespace m8r {
+
+/**
+ * @brief Aho-Corasick multi-pattern matching automaton.
+ *
+ * Patterns are compiled to trie w/ failure links (the longest proper suffix
+ * of state which is also a state) and dictionary links (the nearest state
+ * reachable by failure links which matches a pattern). Text is scanned in
+ * a single pass - cost is linear in text size (plus number of matches)
+ * regardless of the number of patterns. All (also overlapping) occurrences
+ * of all patterns are reported.
+ *
+ * Transitions are sparse: children of a state are a segment of sorted labels
+ * (scanned or binary searched), root has a dense transition table. Therefore
+ * memory is linear in total patterns size, which allows to compile thousands
+ * of patterns (e.g. all O/N names).
+ *
+ * Usage: add patterns, build() and match texts.
+ *
+ * See:
+ *   https://en.wikipedia.org/wiki/Aho%E2%80%93Corasick_algorithm
+ */
+class AhoCorasick
+{
+private:
+    static constexpr uint32_t ROOT = 0;
+    static constexpr uint32_t NONE = UINT32_MAX;
+    // states w/ more children are searched using binary search
+    static constexpr uint32_t LINEAR_SEARCH_THRESHOLD = 8;
+
+    // state -> children (label, state) - before build()
+    std::vector<std::vector<std::pair<unsigned char,uint32_t>>> edges;
+
+    // state -> children segment of labels/targets (CSR, labels sorted) - after build()
+    std::vector<uint32_t> childrenOffsets;
+    std::vector<unsigned char> labels;
+    std::vector<uint32_t> targets;
+    std::vector<uint32_t> rootTransitions;
+    std::vector<uint32_t> failure;
+    std::vector<uint32_t> dictionary;
+    // state -> pattern IDs which end in the state (CSR)
+    std::vector<uint32_t> outputOffsets;
+    std::vector<int32_t> outputs;
+
+    // pattern ID -> state
+    std::vector<uint32_t> patternStates;
+    std::vector<size_t> patternLengths;
+
+    bool built;
+
+public:
+    explicit AhoCorasick();
+    AhoCorasick(const AhoCorasick&) = delete;
+    AhoCorasick(const AhoCorasick&&) = delete;
+    AhoCorasick& operator=(const AhoCorasick&) = delete;
+    AhoCorasick& operator=(const AhoCorasick&&) = delete;
+    ~AhoCorasick();
+
+    /**
+     * @brief Add pattern - patterns can be added before build() only.
+     *
+     * @return pattern ID (patterns are numbered in order of addition) or -1 for empty pattern.
+     */
+    int addPattern(const std::string& pattern);
+
+    /**
+     * @brief Compile added patterns.
+     */
+    void build();
+
+    void clear();
+
+    size_t size() const { return patternLengths.size(); }
+    bool empty() const { return patternLengths.empty(); }
+    size_t getPatternLength(int id) const { return patternLengths[id]; }
+
+    /**
+     * @brief Call f(patternId, end) for every occurrence of every pattern in text.
+     *
+     * end is the position after the last char of the occurrence. Occurrences are
+     * reported by end position, the longest occurrence first.
+     */
+    template<typename F>
+    void match(const char* text, size_t length, F f) const {
+        if(!built || empty()) {
+            return;
+        }
+        uint32_t state = ROOT;
+        for(size_t i=0; i<length; i++) {
+            const unsigned char c = static_cast<unsigned char>(text[i]);
+            uint32_t next = NONE;
+            while(state != ROOT && (next = findChild(state, c)) == NONE) {
+                state = failure[state];
+            }
+            state = state == ROOT ? rootTransitions[c] : next;
+
+            for(uint32_t o = outputOffsets[state]<outputOffsets[state+1] ? state : dictionary[state];
+                o != NONE;
+                o = dictionary[o])
+            {
+                for(uint32_t p=outputOffsets[o]; p<outputOffsets[o+1]; p++) {
+                    f(outputs[p], i+1);
+                }
+            }
+        }
+    }
+    template<typename F>
+    void match(const std::string& text, F f) const {
+        match(text.data(), text.size(), f);
+    }
+
+    /**
+     * @brief Count occurrences of patterns in text - counts (indexed by pattern ID) are incremented.
+     */
+    void count(const std::string& text, std::vector<int>& counts) const;
+
+    /**
+     * @brief Get approximate memory footprint in bytes.
+     */
+    size_t getFootprint() const;
+
+private:
+    uint32_t findChild(uint32_t state, unsigned char c) const {
+        const unsigned char* begin = labels.data()+childrenOffsets[state];
+        const unsigned char* end = labels.data()+childrenOffsets[state+1];
+        if(end-begin <= LINEAR_SEARCH_THRESHOLD) {
+            for(const unsigned char* l=begin; l<end; l++) {
+                if(*l == c) {
+                    return targets[l-labels.data()];
+                }
+            }
+        } else {
+            const unsigned char* l = std::lower_bound(begin, end, c);
+            if(l<end && *l == c) {
+                return targets[l-labels.data()];
+            }
+        }
+        return NONE;
+    }
+};
+
+}
+#endif // M8R_AHO_CORASICK_H
@@ -18,8 +18,43 @@
 */
 #include "async_utils.h"
 
+#include "worker_pool.h"
+
 namespace m8r {
 
+using namespace std;
+
+unsigned int getDefaultWorkersCount()
+{
+    // hardware_concurrency() may return 0 if it's not computable
+    unsigned int hw = thread::hardware_concurrency();
+    return hw>2?hw/2:1;
+}
+
+unsigned int getWorkersCount(int configuredWorkers)
+{
+    return configuredWorkers>0?static_cast<unsigned int>(configuredWorkers):getDefaultWorkersCount();
+}
+
+void parallelForBlocks(
+        size_t size,
+        size_t blockSize,
+        unsigned int workers,
+        const function<void(unsigned int worker, size_t begin, size_t end)>& f)
+{
+    WorkerPool::getInstance().run(size, blockSize, workers, f);
+}
+
+void parallelForBlocks(
+        WorkerPool& pool,
+        size_t size,
+        size_t blockSize,
+        unsigned int workers,
+        const function<void(unsigned int worker, size_t begin, size_t end)>& f)
+{
+    pool.run(size, blockSize, workers, f);
+}
+
 ProgressCallbackCtx::ProgressCallbackCtx()
 {
 }
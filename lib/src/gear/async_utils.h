@@ -20,9 +20,57 @@
 #define M8R_ASYNC_UTILS_H
 
 #include <cmath>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <functional>
 
 namespace m8r {
 
+class WorkerPool;
+
+/**
+ * @brief Get default number of worker threads for CPU intensive computations.
+ *
+ * Half of the hardware threads is used to keep UI and other threads responsive.
+ */
+unsigned int getDefaultWorkersCount();
+
+/**
+ * @brief Get number of worker threads - configured number or default if not configured (<=0).
+ */
+unsigned int getWorkersCount(int configuredWorkers);
+
+/**
+ * @brief Process [0,size) interval in blocks using given number of workers.
+ *
+ * Workers (calling thread is one of them) claim blocks via shared atomic
+ * cursor until all blocks are processed - blocks of uneven cost are balanced
+ * dynamically. Worker index [0,workers) is passed to the function so that
+ * it can publish results to worker private data structures w/o locking.
+ * Method returns when all blocks are processed.
+ *
+ * Workers are persistent threads of the shared WorkerPool i.e. threads
+ * are NOT created per call.
+ */
+void parallelForBlocks(
+        size_t size,
+        size_t blockSize,
+        unsigned int workers,
+        const std::function<void(unsigned int worker, size_t begin, size_t end)>& f);
+/**
+ * @brief Process [0,size) interval in blocks using workers of given pool.
+ *
+ * Long running computations use their own pool so that they don't block
+ * (short) jobs of the shared pool.
+ */
+void parallelForBlocks(
+        WorkerPool& pool,
+        size_t size,
+        size_t blockSize,
+        unsigned int workers,
+        const std::function<void(unsigned int worker, size_t begin, size_t end)>& f);
+
 /**
  * @brief Progress callback context.
  */
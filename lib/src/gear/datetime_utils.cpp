@@ -99,7 +99,14 @@ char* datetimeTo(const struct tm* datetime, char* result)
 std::string datetimeToString(const time_t ts)
 {
     char to[50];
-    if(datetimeTo(localtime(&ts), to)) {
+    // localtime() is not reentrant - Os are serialized by multiple threads (HTML export)
+    tm datetime{};
+#ifndef _WIN32
+    tm* datetimePtr = localtime_r(&ts, &datetime);
+#else
+    tm* datetimePtr = localtime_s(&datetime, &ts) ? nullptr : &datetime;
+#endif
+    if(datetimeTo(datetimePtr, to)) {
         return string{to};
     }
     return "";
@@ -129,8 +136,16 @@ std::string datetimeToPrettyHtml(const time_t* seconds)
     time_t now;
     time(&now);
 
-    tm tsS = *localtime(seconds);
-    tm* nowS = localtime(&now);
+    tm tsS{};
+    tm nowTm{};
+#ifndef _WIN32
+    localtime_r(seconds, &tsS);
+    localtime_r(&now, &nowTm);
+#else
+    localtime_s(&tsS, seconds);
+    localtime_s(&nowTm, &now);
+#endif
+    const tm* nowS = &nowTm;
 
     Pretty pretty = Pretty::LONG_TIME_AGO;
 
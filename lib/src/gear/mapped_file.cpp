@@ -0,0 +1,88 @@
+/*
+ mapped_file.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "mapped_file.h"
+
+#ifdef _WIN32
+  #include <fstream>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace m8r {
+
+using namespace std;
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const string& path)
+    : bytes{nullptr},
+      length{0}
+{
+    ifstream in{path, ios::in|ios::binary|ios::ate};
+    if(in.is_open()) {
+        streamsize s = in.tellg();
+        if(s > 0) {
+            buffer.resize(static_cast<size_t>(s));
+            in.seekg(0, ios::beg);
+            if(in.read(buffer.data(), s)) {
+                bytes = buffer.data();
+                length = buffer.size();
+            }
+        }
+    }
+}
+
+MappedFile::~MappedFile()
+{
+}
+
+#else
+
+MappedFile::MappedFile(const string& path)
+    : bytes{nullptr},
+      length{0}
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd >= 0) {
+        struct stat st;
+        if(fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* m = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if(m != MAP_FAILED) {
+                bytes = static_cast<const char*>(m);
+                length = static_cast<size_t>(st.st_size);
+            }
+        }
+        // mapping stays valid after descriptor is closed
+        ::close(fd);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if(bytes) {
+        munmap(const_cast<char*>(bytes), length);
+    }
+}
+
+#endif
+
+} // m8r namespace
@@ -0,0 +1,56 @@
+/*
+ mapped_file.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_MAPPED_FILE_H
+#define M8R_MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Read only file mapped to memory.
+ *
+ * File is mapped using mmap() - pages are loaded lazily by OS and shared
+ * with page cache (no copy). On platforms w/o mmap() file is read to buffer.
+ */
+class MappedFile
+{
+private:
+    const char* bytes;
+    size_t length;
+#ifdef _WIN32
+    std::vector<char> buffer;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(const MappedFile&&) = delete;
+    MappedFile &operator=(const MappedFile&) = delete;
+    MappedFile &operator=(const MappedFile&&) = delete;
+    ~MappedFile();
+
+    bool isOpen() const { return bytes != nullptr; }
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+}
+#endif // M8R_MAPPED_FILE_H
@@ -0,0 +1,186 @@
+/*
+ priority_executor.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "priority_executor.h"
+
+namespace m8r {
+
+using namespace std;
+
+PriorityExecutor::PriorityExecutor(unsigned int threadsCount)
+    : sequence{0},
+      stopping{false}
+{
+    if(!threadsCount) threadsCount = 1;
+    for(unsigned int i=0; i<threadsCount; i++) {
+        threads.emplace_back(&PriorityExecutor::workerLoop, this);
+    }
+}
+
+PriorityExecutor::~PriorityExecutor()
+{
+    shutdown();
+}
+
+shared_future<bool> PriorityExecutor::submit(
+        const void* key,
+        int priority,
+        function<bool()> work,
+        bool* isNew)
+{
+    lock_guard<mutex> criticalSection{queueMutex};
+
+    if(stopping) {
+        if(isNew) *isNew = false;
+        promise<bool> p{};
+        p.set_value(false);
+        return shared_future<bool>(p.get_future());
+    }
+
+    auto i = inFlight.find(key);
+    if(i != inFlight.end()) {
+        if(isNew) *isNew = false;
+
+        // raise priority of queued task (set is ordered by priority > reinsert)
+        Task* t = i->second;
+        auto q = queue.find(t);
+        if(q != queue.end() && priority > t->priority) {
+            queue.erase(q);
+            t->priority = priority;
+            queue.insert(t);
+        }
+        return t->future;
+    }
+
+    Task* t = new Task{};
+    t->key = key;
+    t->priority = priority;
+    t->sequence = sequence++;
+    t->work = std::move(work);
+    t->future = t->promise.get_future().share();
+
+    queue.insert(t);
+    inFlight[key] = t;
+    if(isNew) *isNew = true;
+
+    queueCondition.notify_one();
+    return t->future;
+}
+
+bool PriorityExecutor::isInFlight(const void* key)
+{
+    lock_guard<mutex> criticalSection{queueMutex};
+    return inFlight.find(key) != inFlight.end();
+}
+
+bool PriorityExecutor::cancel(const void* key)
+{
+    lock_guard<mutex> criticalSection{queueMutex};
+
+    auto i = inFlight.find(key);
+    if(i != inFlight.end()) {
+        auto q = queue.find(i->second);
+        if(q != queue.end()) {
+            Task* t = *q;
+            queue.erase(q);
+            inFlight.erase(i);
+            t->promise.set_value(false);
+            delete t;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t PriorityExecutor::cancelPending(int maxPriority, const void* exceptKey)
+{
+    lock_guard<mutex> criticalSection{queueMutex};
+
+    size_t cancelled = 0;
+    for(auto q = queue.begin(); q != queue.end(); ) {
+        Task* t = *q;
+        if(t->priority <= maxPriority && t->key != exceptKey) {
+            q = queue.erase(q);
+            inFlight.erase(t->key);
+            t->promise.set_value(false);
+            delete t;
+            cancelled++;
+        } else {
+            ++q;
+        }
+    }
+    return cancelled;
+}
+
+void PriorityExecutor::shutdown()
+{
+    {
+        lock_guard<mutex> criticalSection{queueMutex};
+        if(stopping) {
+            return;
+        }
+        stopping = true;
+
+        for(Task* t:queue) {
+            inFlight.erase(t->key);
+            t->promise.set_value(false);
+            delete t;
+        }
+        queue.clear();
+    }
+    queueCondition.notify_all();
+
+    for(thread& t:threads) {
+        if(t.joinable()) {
+            t.join();
+        }
+    }
+}
+
+void PriorityExecutor::workerLoop()
+{
+    while(true) {
+        Task* t;
+        {
+            unique_lock<mutex> criticalSection{queueMutex};
+            queueCondition.wait(criticalSection, [this]{ return stopping || !queue.empty(); });
+            if(stopping && queue.empty()) {
+                return;
+            }
+            t = *queue.begin();
+            queue.erase(queue.begin());
+            // task stays in flight while running so that requests are deduplicated
+        }
+
+        bool result;
+        try {
+            result = t->work();
+        } catch(...) {
+            result = false;
+        }
+
+        {
+            lock_guard<mutex> criticalSection{queueMutex};
+            inFlight.erase(t->key);
+        }
+        t->promise.set_value(result);
+        delete t;
+    }
+}
+
+} // m8r namespace
@@ -0,0 +1,132 @@
+/*
+ priority_executor.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_PRIORITY_EXECUTOR_H
+#define M8R_PRIORITY_EXECUTOR_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Bounded executor w/ priority queue.
+ *
+ * Executor runs tasks using FIXED number of threads which are started on
+ * construction and joined on shutdown. Pending tasks are ordered by priority
+ * (higher first) and submission order.
+ *
+ * Every task is identified by a key (typically pointer to the Thing the task
+ * computes something for). Tasks are deduplicated - if a task with the same key
+ * is queued or running, then its future is returned (and queued task priority
+ * is raised if needed) instead of scheduling the work again.
+ *
+ * Queued tasks can be cancelled - future of a cancelled task becomes ready
+ * with false. Running tasks are never interrupted.
+ */
+class PriorityExecutor
+{
+public:
+    static constexpr int PRIORITY_LOW = 0;
+    static constexpr int PRIORITY_NORMAL = 1;
+    static constexpr int PRIORITY_HIGH = 2;
+
+private:
+    struct Task {
+        const void* key;
+        int priority;
+        unsigned long long sequence;
+        std::function<bool()> work;
+        std::promise<bool> promise;
+        std::shared_future<bool> future;
+    };
+
+    struct TaskComparator {
+        bool operator()(const Task* t1, const Task* t2) const {
+            return t1->priority!=t2->priority?t1->priority>t2->priority:t1->sequence<t2->sequence;
+        }
+    };
+
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+
+    std::set<Task*,TaskComparator> queue;
+    // key -> queued or running task
+    std::map<const void*,Task*> inFlight;
+    unsigned long long sequence;
+    bool stopping;
+
+    std::vector<std::thread> threads;
+
+public:
+    explicit PriorityExecutor(unsigned int threadsCount);
+    PriorityExecutor(const PriorityExecutor&) = delete;
+    PriorityExecutor(const PriorityExecutor&&) = delete;
+    PriorityExecutor &operator=(const PriorityExecutor&) = delete;
+    PriorityExecutor &operator=(const PriorityExecutor&&) = delete;
+    ~PriorityExecutor();
+
+    size_t getThreadsCount() const { return threads.size(); }
+
+    /**
+     * @brief Schedule task or join queued/running task w/ the same key.
+     *
+     * @param isNew  set to true if task was scheduled, false if existing task was joined.
+     */
+    std::shared_future<bool> submit(
+            const void* key,
+            int priority,
+            std::function<bool()> work,
+            bool* isNew=nullptr);
+
+    /**
+     * @brief Is there queued or running task w/ given key?
+     */
+    bool isInFlight(const void* key);
+
+    /**
+     * @brief Cancel queued task w/ given key.
+     *
+     * @return true if task was cancelled, false if it's running or unknown.
+     */
+    bool cancel(const void* key);
+
+    /**
+     * @brief Cancel queued tasks w/ priority lower or equal to given priority except given key.
+     *
+     * @return number of cancelled tasks.
+     */
+    size_t cancelPending(int maxPriority, const void* exceptKey=nullptr);
+
+    /**
+     * @brief Cancel all queued tasks, wait for running tasks and stop threads.
+     */
+    void shutdown();
+
+private:
+    void workerLoop();
+};
+
+}
+#endif // M8R_PRIORITY_EXECUTOR_H
@@ -22,54 +22,104 @@ namespace m8r {
 
 using namespace std;
 
+constexpr uint32_t Trie::ROOT;
+constexpr uint32_t Trie::NONE;
+constexpr uint16_t Trie::LINEAR_SEARCH_THRESHOLD;
+
 Trie::Trie()
+    : abandonedSlots{0}
 {
-    root = new Node();
+    nodes.push_back(Node{0, 0, 0, 0});
 }
 
 Trie::~Trie()
 {
-    // delete nodes using backtracking
-    destroy(root);
 }
 
-void Trie::destroy(Node* n)
-{    
-    for(Node* c:n->mChildren) {
-        destroy(c);
+uint32_t Trie::addChild(uint32_t node, char c)
+{
+    const unsigned char label = static_cast<unsigned char>(c);
+    uint32_t child = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(Node{0, 0, 0, 0});
+
+    Node& n = nodes[node];
+    if(n.childrenCount == n.childrenCapacity) {
+        // move children segment to the end w/ double capacity
+        uint16_t capacity = n.childrenCapacity ? n.childrenCapacity*2 : 1;
+        uint32_t children = static_cast<uint32_t>(labels.size());
+        labels.resize(labels.size()+capacity);
+        targets.resize(targets.size()+capacity);
+        std::copy(labels.begin()+n.children, labels.begin()+n.children+n.childrenCount, labels.begin()+children);
+        std::copy(targets.begin()+n.children, targets.begin()+n.children+n.childrenCount, targets.begin()+children);
+        abandonedSlots += n.childrenCapacity;
+        n.children = children;
+        n.childrenCapacity = capacity;
+    }
+
+    // keep labels sorted
+    unsigned char* begin = labels.data()+n.children;
+    size_t i = std::lower_bound(begin, begin+n.childrenCount, label) - begin;
+    for(size_t j=n.childrenCount; j>i; j--) {
+        labels[n.children+j] = labels[n.children+j-1];
+        targets[n.children+j] = targets[n.children+j-1];
+    }
+    labels[n.children+i] = label;
+    targets[n.children+i] = child;
+    n.childrenCount++;
+
+    return child;
+}
+
+void Trie::compact()
+{
+    MF_DEBUG("trie.compact(" << abandonedSlots << "/" << labels.size() << ")" << endl);
+
+    // children segments are copied w/ tight capacity (in node order)
+    vector<unsigned char> compactLabels{};
+    vector<uint32_t> compactTargets{};
+    compactLabels.reserve(labels.size()-abandonedSlots);
+    compactTargets.reserve(labels.size()-abandonedSlots);
+    for(Node& n:nodes) {
+        uint32_t children = static_cast<uint32_t>(compactLabels.size());
+        compactLabels.insert(compactLabels.end(), labels.begin()+n.children, labels.begin()+n.children+n.childrenCount);
+        compactTargets.insert(compactTargets.end(), targets.begin()+n.children, targets.begin()+n.children+n.childrenCount);
+        n.children = children;
+        n.childrenCapacity = n.childrenCount;
     }
-    delete n;
+    labels.swap(compactLabels);
+    targets.swap(compactTargets);
+    abandonedSlots = 0;
 }
 
 void Trie::addWord(const string& s)
 {
     //MF_DEBUG("trie.add(" << s << ")" << endl);
-    if(s.size()) {
-        Node* current = root;
 
-        if(!s.size()) {
-            // support of empty words is NOT desired
-            // current->setWordMarker();
-            return;
+    // support of empty words is NOT desired
+    if(s.size()) {
+        uint32_t current = ROOT;
+        for(char c:s) {
+            uint32_t child = findChild(current, c);
+            current = child != NONE ? child : addChild(current, c);
         }
+        nodes[current].refCount++;
 
-        for(size_t i=0; i<s.size(); i++) {
-            Node* child = current->findChild(s[i]);
-
-            if(child != nullptr) {
-                current = child;
-            } else {
-                Node* n = new Node();
-                n->setContent(s[i]);
-                current->appendChild(n);
-                current = n;
-            }
+        if(abandonedSlots > labels.size()/2) {
+            compact();
+        }
+    }
+}
 
-            if(i == s.size()-1) {
-                current->setWordMarker();
-            }
+uint32_t Trie::findNode(const string& s) const
+{
+    uint32_t current = ROOT;
+    for(char c:s) {
+        current = findChild(current, c);
+        if(current == NONE) {
+            return NONE;
         }
     }
+    return current;
 }
 
 /**
@@ -88,94 +138,54 @@ bool Trie::removeWord(const string& s, bool decRefCountOnly)
 {
     MF_DEBUG("trie.remove(" << s << ")" << endl);
     if(s.size()) {
-        if(root->children().empty()) {
-            return false;
-        } else {
-            Node* current = root;
-            while(current != nullptr) {
-                for(size_t i=0; i<s.size(); i++) {
-                    Node* n = current->findChild(s[i]);
-                    if(n == nullptr) {
-                        return false;
-                    }
-                    current = n;
-                }
-
-                if(current->wordMarker()) {
-                    if(decRefCountOnly) {
-                        current->decRefCount();
-                    } else {
-                        current->setRefCount(0);
-                    }
-                    return true;
-                }
+        uint32_t node = findNode(s);
+        if(node != NONE && nodes[node].refCount > 0) {
+            if(decRefCountOnly) {
+                nodes[node].refCount--;
+            } else {
+                nodes[node].refCount = 0;
             }
+            return true;
         }
     }
 
     return false;
 }
 
-bool Trie::findWord(string& s) const
+bool Trie::findWord(const string& s) const
 {
-    if(root->children().empty()) {
-        return false;
-    } else {
-        Node* current = root;
-        while(current != nullptr) {
-            for(size_t i=0; i<s.size(); i++) {
-                Node* n = current->findChild(s[i]);
-                if(n == nullptr) {
-                    return false;
-                }
-                current = n;
-            }
-
-            return current->wordMarker();
-        }
+    if(s.empty()) {
         return false;
     }
+    uint32_t node = findNode(s);
+    return node != NONE && nodes[node].refCount > 0;
 }
 
 bool Trie::findLongestPrefixWord(const string& s, string& r) const
 {
-    if(root->children().empty()) {
-        return false;
-    } else {
-        size_t longestWordSize{};
-
-        Node* current = root;
-        if(current != nullptr) {
-            for(size_t i=0; i<s.size(); i++) {
-                Node* n = current->findChild(s[i]);
-                if(n == nullptr) {
-                    // TODO make this method
-                    if(longestWordSize) {
-                        r = r.substr(0, longestWordSize);
-                        return true;
-                    } else {
-                        return false;
-                    }
-                }
-
-                current = n;
-                r += s[i];
-                if(current->wordMarker()) {
-                    longestWordSize = r.size();
-                }
-            }
-
-            // TODO make this method
-            if(longestWordSize) {
-                r = r.substr(0, longestWordSize);
-                return true;
-            } else {
-                return false;
-            }
-        } else {
-            return false;
+    size_t longestWordSize{};
+    size_t matched{};
+
+    uint32_t current = ROOT;
+    for(char c:s) {
+        current = findChild(current, c);
+        if(current == NONE) {
+            break;
+        }
+        matched++;
+        if(nodes[current].refCount > 0) {
+            longestWordSize = matched;
         }
     }
+
+    // matched chars are appended to r (longest word only if found)
+    if(longestWordSize) {
+        r.append(s, 0, longestWordSize);
+        return true;
+    } else {
+        r.append(s, 0, matched);
+        return false;
+    }
 }
 
 int Trie::print() const
@@ -183,29 +193,29 @@ int Trie::print() const
     MF_DEBUG("Trie:" << endl);
 
     int count = 1;
-    if(root->children().empty()) {
+    if(empty()) {
         MF_DEBUG("  EMPTY" << endl);
     } else {
         string prefix{};
-        count = resursivePrint(prefix, root, count);
+        count = resursivePrint(prefix, ROOT, count);
     }
 
     MF_DEBUG("Trie nodes: " << count << endl);
     return count;
 }
 
-int Trie::resursivePrint(string prefix, const Node* n, int count) const
+int Trie::resursivePrint(string& prefix, uint32_t node, int count) const
 {
+    const Node& n = nodes[node];
     MF_DEBUG(
-        (n->wordMarker()?" >":"  ") <<
+        (n.refCount>0?" >":"  ") <<
         "'" << prefix << "' " <<
-        (n->wordMarker()?std::to_string(n->refCount()):"") << endl);
+        (n.refCount>0?std::to_string(n.refCount):"") << endl);
 
-    std::vector<Node*> children = n->children();
-    for(Node* n:children) {
-        prefix += n->content();
-        count = resursivePrint(prefix, n, ++count);
-        prefix = prefix.substr(0, prefix.size()-1);
+    for(uint32_t i=n.children; i<n.children+n.childrenCount; i++) {
+        prefix += static_cast<char>(labels[i]);
+        count = resursivePrint(prefix, targets[i], ++count);
+        prefix.pop_back();
     }
 
     return count;
@@ -19,6 +19,8 @@
 #ifndef M8R_TRIE_H
 #define M8R_TRIE_H
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -29,48 +31,40 @@ namespace m8r {
 /**
  * @brief Trie.
  *
+ * Compact trie: nodes are kept in a single array and children of a node
+ * are a contiguous segment of (label, target) slot arrays - labels of a
+ * segment are sorted, therefore child is found by scanning few bytes or
+ * by binary search (nodes w/ many children). There are no per node
+ * allocations and traversal doesn't chase pointers across the heap.
+ *
+ * When a node gets more children than its segment capacity, the segment
+ * is moved to the end of slot arrays w/ double capacity - abandoned slots
+ * are reclaimed by compaction once they make the majority of slots.
+ *
  * This implementation has been inspired by an http://www.sourcetricks.com example.
  */
 class Trie
 {
 private:
-    class Node {
-        friend class Trie;
-
-    private:
-        char mContent;
+    static constexpr uint32_t ROOT = 0;
+    static constexpr uint32_t NONE = UINT32_MAX;
+    // nodes w/ more children are searched using binary search
+    static constexpr uint16_t LINEAR_SEARCH_THRESHOLD = 8;
+
+    struct Node {
+        // first child slot
+        uint32_t children;
+        uint16_t childrenCount;
+        uint16_t childrenCapacity;
         // >1 it is word with given references, 0 it's char inside a word
-        int mRefCount;
-        std::vector<Node*> mChildren;
-
-    public:
-        explicit Node() {
-            mContent = ' ';
-            mRefCount = 0;
-        }
-        ~Node() {}
-        char content() const { return mContent; }
-        void setContent(char c) { mContent = c; }
-        bool wordMarker() const { return mRefCount>0; }
-        int refCount() const { return mRefCount; }
-        int decRefCount() { if(mRefCount > 0) { mRefCount--; }; return mRefCount; }
-        void setRefCount(int refCount) { mRefCount=refCount; }
-        void setWordMarker() { ++mRefCount; }
-        void appendChild(Node* child) { mChildren.push_back(child); }
-        std::vector<Node*> children() const { return mChildren; }
-
-        // IMPROVE sort children once trie filled AND use binary search here O(n) -> O(log(n))
-        Node* findChild(char c) {
-            for(Node* n:mChildren) {
-                if(n->content()==c) {
-                    return n;
-                }
-            }
-            return nullptr;
-        }
+        int32_t refCount;
     };
 
-    Node* root;
+    std::vector<Node> nodes;
+    // child slots: label (char) and target (node index)
+    std::vector<unsigned char> labels;
+    std::vector<uint32_t> targets;
+    size_t abandonedSlots;
 
 public:
     explicit Trie();
@@ -80,13 +74,13 @@ public:
     Trie& operator=(const Trie&&) = delete;
     ~Trie();
 
-    bool empty() const { return root->children().empty(); }
+    bool empty() const { return nodes[ROOT].childrenCount == 0; }
 
     void addWord(const std::string& s);
     /**
      * @brief Is the word known to trie?
      */
-    bool findWord(std::string& s) const;
+    bool findWord(const std::string& s) const;
     /**
      * @brief Find longest word which is prefix of s.
      */
@@ -101,9 +95,45 @@ public:
      */
     int print() const;
 
+    /**
+     * @brief Get number of nodes (including root) - nodes of removed words are kept.
+     */
+    size_t size() const { return nodes.size(); }
+
+    /**
+     * @brief Get approximate memory footprint in bytes.
+     */
+    size_t getFootprint() const {
+        return nodes.capacity()*sizeof(Node)
+               + labels.capacity()*sizeof(unsigned char)
+               + targets.capacity()*sizeof(uint32_t);
+    }
+
 private:
-    int resursivePrint(std::string prefix, const Node* n, int count) const;
-    void destroy(Node* n);
+    uint32_t findChild(uint32_t node, char c) const {
+        const Node& n = nodes[node];
+        const unsigned char* begin = labels.data()+n.children;
+        const unsigned char* end = begin+n.childrenCount;
+        const unsigned char label = static_cast<unsigned char>(c);
+        if(n.childrenCount <= LINEAR_SEARCH_THRESHOLD) {
+            for(const unsigned char* l=begin; l<end; l++) {
+                if(*l == label) {
+                    return targets[n.children+(l-begin)];
+                }
+            }
+        } else {
+            const unsigned char* l = std::lower_bound(begin, end, label);
+            if(l<end && *l == label) {
+                return targets[n.children+(l-begin)];
+            }
+        }
+        return NONE;
+    }
+    uint32_t addChild(uint32_t node, char c);
+    uint32_t findNode(const std::string& s) const;
+    void compact();
+
+    int resursivePrint(std::string& prefix, uint32_t node, int count) const;
 };
 
 }
@@ -0,0 +1,139 @@
+/*
+ worker_pool.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "worker_pool.h"
+
+namespace m8r {
+
+using namespace std;
+
+// pool threads and callers running a job - nested job is processed by the calling thread
+static thread_local bool IN_WORKER_POOL_JOB = false;
+
+WorkerPool::WorkerPool()
+    : f{nullptr},
+      size{0},
+      blockSize{1},
+      blocks{0},
+      workers{0},
+      jobSequence{0},
+      cursor{0},
+      busy{0},
+      stopping{false}
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        lock_guard<mutex> criticalSection{poolMutex};
+        stopping = true;
+    }
+    jobStarted.notify_all();
+
+    for(thread& t:threads) {
+        t.join();
+    }
+}
+
+size_t WorkerPool::getThreadsCount()
+{
+    lock_guard<mutex> criticalSection{poolMutex};
+    return threads.size();
+}
+
+void WorkerPool::run(size_t size, size_t blockSize, unsigned int workers, const BlockFunction& f)
+{
+    if(!blockSize) blockSize = 1;
+    size_t blocks = (size+blockSize-1)/blockSize;
+    if(workers > blocks) workers = static_cast<unsigned int>(blocks);
+
+    if(workers <= 1 || IN_WORKER_POOL_JOB) {
+        if(size) f(0, 0, size);
+        return;
+    }
+
+    lock_guard<mutex> jobCriticalSection{jobMutex};
+    {
+        lock_guard<mutex> criticalSection{poolMutex};
+        // new threads must NOT take the job published below as already seen
+        while(threads.size() < workers-1) {
+            threads.emplace_back(
+                &WorkerPool::workerLoop,
+                this,
+                static_cast<unsigned int>(threads.size()+1),
+                jobSequence);
+        }
+
+        this->f = &f;
+        this->size = size;
+        this->blockSize = blockSize;
+        this->blocks = blocks;
+        this->workers = workers;
+        cursor.store(0, memory_order_relaxed);
+        busy = workers-1;
+        jobSequence++;
+    }
+    jobStarted.notify_all();
+
+    IN_WORKER_POOL_JOB = true;
+    processBlocks(0);
+    IN_WORKER_POOL_JOB = false;
+
+    unique_lock<mutex> criticalSection{poolMutex};
+    jobFinished.wait(criticalSection, [this]{ return busy == 0; });
+    this->f = nullptr;
+}
+
+void WorkerPool::processBlocks(unsigned int worker)
+{
+    size_t b;
+    while((b = cursor.fetch_add(1, memory_order_relaxed)) < blocks) {
+        size_t begin = b*blockSize;
+        (*f)(worker, begin, begin+blockSize<size?begin+blockSize:size);
+    }
+}
+
+void WorkerPool::workerLoop(unsigned int worker, unsigned long long seenJobSequence)
+{
+    IN_WORKER_POOL_JOB = true;
+
+    unique_lock<mutex> criticalSection{poolMutex};
+    while(true) {
+        jobStarted.wait(criticalSection, [this,seenJobSequence]{
+            return stopping || jobSequence != seenJobSequence;
+        });
+        if(stopping) {
+            return;
+        }
+        seenJobSequence = jobSequence;
+
+        // threads above the number of workers requested by the job sit it out
+        if(worker < workers) {
+            criticalSection.unlock();
+            processBlocks(worker);
+            criticalSection.lock();
+
+            if(--busy == 0) {
+                jobFinished.notify_one();
+            }
+        }
+    }
+}
+
+} // m8r namespace
@@ -0,0 +1,103 @@
+/*
+ worker_pool.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_WORKER_POOL_H
+#define M8R_WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Pool of persistent worker threads for data parallel computations.
+ *
+ * Unlike PriorityExecutor, which runs independent tasks, the pool runs one
+ * job at a time - interval processed in blocks by all the workers. Threads
+ * are started on demand (up to the largest number of workers requested so
+ * far) and reused by subsequent jobs, therefore short jobs (AA row) don't pay
+ * for thread creation. Jobs of concurrent callers are serialized. Job submitted
+ * from a running job (nested) is processed by the calling thread.
+ *
+ * Shared pool (singleton) is used by short AA jobs, long running computations
+ * (HTML export) use their own pool so that they don't block AA.
+ */
+class WorkerPool
+{
+public:
+    typedef std::function<void(unsigned int worker, size_t begin, size_t end)> BlockFunction;
+
+private:
+    // serializes jobs of concurrent callers
+    std::mutex jobMutex;
+
+    std::mutex poolMutex;
+    // workers are waiting for a job
+    std::condition_variable jobStarted;
+    // caller is waiting for workers to finish the job
+    std::condition_variable jobFinished;
+
+    // job
+    const BlockFunction* f;
+    size_t size;
+    size_t blockSize;
+    size_t blocks;
+    unsigned int workers;
+    unsigned long long jobSequence;
+    std::atomic<size_t> cursor;
+    // pool threads still working on the job
+    unsigned int busy;
+
+    bool stopping;
+    std::vector<std::thread> threads;
+
+public:
+    static WorkerPool& getInstance() {
+        static WorkerPool SINGLETON{};
+        return SINGLETON;
+    }
+
+    explicit WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool(const WorkerPool&&) = delete;
+    WorkerPool &operator=(const WorkerPool&) = delete;
+    WorkerPool &operator=(const WorkerPool&&) = delete;
+    ~WorkerPool();
+
+    size_t getThreadsCount();
+
+    /**
+     * @brief Process [0,size) interval in blocks using given number of workers.
+     *
+     * Calling thread is worker 0, pool threads are workers [1,workers).
+     *
+     * @see parallelForBlocks()
+     */
+    void run(size_t size, size_t blockSize, unsigned int workers, const BlockFunction& f);
+
+private:
+    void processBlocks(unsigned int worker);
+    void workerLoop(unsigned int worker, unsigned long long seenJobSequence);
+};
+
+}
+#endif // M8R_WORKER_POOL_H
@@ -0,0 +1,333 @@
+/*
+ aa_bow_model.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "aa_bow_model.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#ifdef _WIN32
+  #include <windows.h>
+#endif
+
+namespace m8r {
+
+using namespace std;
+
+const char AaBowModel::MAGIC[8] = {'M','8','R','A','A','B','O','W'};
+
+// sections are 8B aligned
+static uint64_t align(uint64_t offset) {
+    return (offset+7) & ~static_cast<uint64_t>(7);
+}
+
+AaBowModel::AaBowModel()
+    : file{nullptr},
+      header{nullptr},
+      words{nullptr},
+      wordChars{nullptr},
+      notes{nullptr},
+      keyChars{nullptr},
+      docs{nullptr},
+      rows{nullptr}
+{
+}
+
+AaBowModel::~AaBowModel()
+{
+    unload();
+}
+
+void AaBowModel::unload()
+{
+    header = nullptr;
+    if(file) {
+        delete file;
+        file = nullptr;
+    }
+}
+
+bool AaBowModel::load(const string& path)
+{
+    unload();
+
+    file = new MappedFile{path};
+    if(!file->isOpen() || file->size() < sizeof(Header)) {
+        unload();
+        return false;
+    }
+
+    const char* d = file->data();
+    header = reinterpret_cast<const Header*>(d);
+    if(memcmp(header->magic, MAGIC, sizeof(MAGIC))
+       || header->version != VERSION
+       || header->byteOrder != ENDIANNESS)
+    {
+        MF_DEBUG("AA.BoW.model: incompatible model " << path << endl);
+        unload();
+        return false;
+    }
+
+    if(!validate()) {
+        MF_DEBUG("AA.BoW.model: corrupted model " << path << endl);
+        unload();
+        return false;
+    }
+
+    words = reinterpret_cast<const WordRecord*>(d+header->wordsOffset);
+    wordChars = d+header->wordCharsOffset;
+    notes = reinterpret_cast<const NoteRecord*>(d+header->notesOffset);
+    keyChars = d+header->keyCharsOffset;
+    docs = reinterpret_cast<const DocEntry*>(d+header->docsOffset);
+    rows = reinterpret_cast<const AaNeighborStore::Neighbor*>(d+header->rowsOffset);
+
+    return true;
+}
+
+bool AaBowModel::validate() const
+{
+    const uint64_t size = file->size();
+    auto within = [size](uint64_t offset, uint64_t bytes) {
+        return offset%8 == 0 && offset <= size && bytes <= size-offset;
+    };
+
+    const uint64_t k = header->k;
+    const uint64_t wordsCount = header->wordsCount;
+    const uint64_t notesCount = header->notesCount;
+    if(!within(header->wordsOffset, wordsCount*sizeof(WordRecord))
+       || !within(header->wordCharsOffset, header->wordCharsSize)
+       || !within(header->notesOffset, notesCount*sizeof(NoteRecord))
+       || !within(header->keyCharsOffset, header->keyCharsSize)
+       || !within(header->docsOffset, header->docsCount*sizeof(DocEntry))
+       || !within(header->rowsOffset, notesCount*k*sizeof(AaNeighborStore::Neighbor)))
+    {
+        return false;
+    }
+
+    const char* d = file->data();
+    const WordRecord* w = reinterpret_cast<const WordRecord*>(d+header->wordsOffset);
+    for(uint64_t i=0; i<wordsCount; i++) {
+        if(static_cast<uint64_t>(w[i].chars)+w[i].length > header->wordCharsSize) {
+            return false;
+        }
+    }
+
+    const NoteRecord* n = reinterpret_cast<const NoteRecord*>(d+header->notesOffset);
+    const DocEntry* e = reinterpret_cast<const DocEntry*>(d+header->docsOffset);
+    const AaNeighborStore::Neighbor* r = reinterpret_cast<const AaNeighborStore::Neighbor*>(d+header->rowsOffset);
+    for(uint64_t i=0; i<notesCount; i++) {
+        if(static_cast<uint64_t>(n[i].key)+n[i].keyLength > header->keyCharsSize
+           || n[i].docBegin > n[i].docEnd
+           || n[i].docEnd > header->docsCount
+           || n[i].rowSize > k)
+        {
+            return false;
+        }
+        // doc vector must be sorted by word ID
+        for(uint32_t j=n[i].docBegin; j<n[i].docEnd; j++) {
+            if(e[j].id < 0 || static_cast<uint64_t>(e[j].id) >= wordsCount
+               || e[j].frequency <= 0
+               || (j>n[i].docBegin && e[j-1].id >= e[j].id))
+            {
+                return false;
+            }
+        }
+        for(uint32_t j=0; j<n[i].rowSize; j++) {
+            if(r[i*k+j].note < 0 || static_cast<uint64_t>(r[i*k+j].note) >= notesCount) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// FNV-1a
+static void digestString(uint64_t& h, const string& s)
+{
+    for(char c:s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001B3ULL;
+    }
+    // separator ~ "ab"+"c" differs from "a"+"bc"
+    h ^= 0xFF;
+    h *= 0x100000001B3ULL;
+}
+
+uint64_t AaBowModel::digest(const Note* note)
+{
+    uint64_t h = 0xCBF29CE484222325ULL;
+    digestString(h, note->getName());
+    for(const string* l:note->getDescription()) {
+        if(l) {
+            digestString(h, *l);
+        }
+    }
+    if(note->getType()) {
+        digestString(h, note->getType()->getName());
+    }
+    if(note->getTags()) {
+        for(const Tag* t:*note->getTags()) {
+            digestString(h, t->getName());
+        }
+    }
+    return h;
+}
+
+bool AaBowModel::save(
+        const string& path,
+        const Lexicon& lexicon,
+        const vector<Note*>& notes,
+        const vector<string>& keys,
+        const vector<uint64_t>& digests,
+        BagOfWords& bow,
+        const AaNeighborStore& store)
+{
+    // build sections in memory - words of forgotten docs are dropped > word IDs are compacted
+    vector<int32_t> ids(lexicon.size(), -1);
+    vector<WordRecord> wordRecords{};
+    string wordCharsSection{};
+    for(size_t id=0; id<lexicon.size(); id++) {
+        const Lexicon::WordEmbedding* e = lexicon.get(static_cast<int>(id));
+        if(e->frequency > 0) {
+            ids[id] = static_cast<int32_t>(wordRecords.size());
+            wordRecords.push_back(WordRecord{
+                static_cast<uint32_t>(wordCharsSection.size()),
+                static_cast<uint32_t>(e->word.size())});
+            wordCharsSection += e->word;
+        }
+    }
+
+    // deleted Ns are skipped > learned N index to model N index
+    vector<int32_t> indices(notes.size(), -1);
+    int32_t notesCount = 0;
+    for(size_t i=0; i<notes.size(); i++) {
+        if(notes[i]) {
+            indices[i] = notesCount++;
+        }
+    }
+
+    const size_t k = store.getK();
+    vector<NoteRecord> noteRecords(notesCount);
+    string keyCharsSection{};
+    vector<DocEntry> docsSection{};
+    vector<AaNeighborStore::Neighbor> rowsSection(static_cast<size_t>(notesCount)*k, AaNeighborStore::Neighbor{0,0.f});
+    for(size_t i=0; i<notes.size(); i++) {
+        if(indices[i] < 0) {
+            continue;
+        }
+        NoteRecord& r = noteRecords[indices[i]];
+        memset(&r, 0, sizeof(NoteRecord));
+        r.key = static_cast<uint32_t>(keyCharsSection.size());
+        r.keyLength = static_cast<uint32_t>(keys[i].size());
+        keyCharsSection += keys[i];
+        r.digest = digests[i];
+
+        r.docBegin = static_cast<uint32_t>(docsSection.size());
+        WordFrequencyList* wfl = bow.get(notes[i]);
+        if(wfl) {
+            for(auto& w:wfl->iterable()) {
+                if(ids[w.id] >= 0) {
+                    docsSection.push_back(DocEntry{ids[w.id], w.frequency});
+                }
+            }
+        }
+        r.docEnd = static_cast<uint32_t>(docsSection.size());
+
+        if(i < store.size()) {
+            // row which lost deleted N is not complete
+            bool complete = store.isRowComputed(i);
+            const AaNeighborStore::Neighbor* row = store.getRow(i);
+            AaNeighborStore::Neighbor* persisted = &rowsSection[indices[i]*k];
+            for(size_t j=0; j<store.getRowSize(i); j++) {
+                if(indices[row[j].note] >= 0) {
+                    persisted[r.rowSize++] = AaNeighborStore::Neighbor{indices[row[j].note], row[j].aa};
+                } else {
+                    complete = false;
+                }
+            }
+            if(complete) {
+                r.flags |= FLAG_COMPUTED;
+            }
+        }
+    }
+
+    Header h;
+    memset(&h, 0, sizeof(Header));
+    memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.byteOrder = ENDIANNESS;
+    h.k = static_cast<uint32_t>(k);
+    h.wordsCount = static_cast<uint32_t>(wordRecords.size());
+    h.notesCount = static_cast<uint32_t>(noteRecords.size());
+    h.wordsOffset = align(sizeof(Header));
+    h.wordCharsOffset = align(h.wordsOffset + wordRecords.size()*sizeof(WordRecord));
+    h.wordCharsSize = wordCharsSection.size();
+    h.notesOffset = align(h.wordCharsOffset + h.wordCharsSize);
+    h.keyCharsOffset = align(h.notesOffset + noteRecords.size()*sizeof(NoteRecord));
+    h.keyCharsSize = keyCharsSection.size();
+    h.docsOffset = align(h.keyCharsOffset + h.keyCharsSize);
+    h.docsCount = docsSection.size();
+    h.rowsOffset = align(h.docsOffset + docsSection.size()*sizeof(DocEntry));
+
+    // write to temporary file and replace model (readers never see partial file)
+    string tmpPath{path};
+    tmpPath += ".tmp";
+    {
+        ofstream out{tmpPath, ios::out|ios::binary|ios::trunc};
+        if(!out.is_open()) {
+            MF_DEBUG("AA.BoW.model: unable to write " << tmpPath << endl);
+            return false;
+        }
+
+        uint64_t written = 0;
+        auto write = [&out,&written](uint64_t offset, const void* data, uint64_t bytes) {
+            static const char padding[8] = {0,0,0,0,0,0,0,0};
+            out.write(padding, static_cast<streamsize>(offset-written));
+            out.write(static_cast<const char*>(data), static_cast<streamsize>(bytes));
+            written = offset+bytes;
+        };
+        write(0, &h, sizeof(Header));
+        write(h.wordsOffset, wordRecords.data(), wordRecords.size()*sizeof(WordRecord));
+        write(h.wordCharsOffset, wordCharsSection.data(), wordCharsSection.size());
+        write(h.notesOffset, noteRecords.data(), noteRecords.size()*sizeof(NoteRecord));
+        write(h.keyCharsOffset, keyCharsSection.data(), keyCharsSection.size());
+        write(h.docsOffset, docsSection.data(), docsSection.size()*sizeof(DocEntry));
+        write(h.rowsOffset, rowsSection.data(), rowsSection.size()*sizeof(AaNeighborStore::Neighbor));
+        if(!out.good()) {
+            out.close();
+            remove(tmpPath.c_str());
+            return false;
+        }
+    }
+
+    // model file must not be mapped (loaded) - mapped file cannot be replaced on Windows
+#ifdef _WIN32
+    if(!MoveFileExA(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING|MOVEFILE_WRITE_THROUGH)) {
+#else
+    if(rename(tmpPath.c_str(), path.c_str())) {
+#endif
+        remove(tmpPath.c_str());
+        return false;
+    }
+
+    MF_DEBUG("AA.BoW.model: saved " << noteRecords.size() << " Ns and " << wordRecords.size() << " words to " << path << endl);
+    return true;
+}
+
+} // m8r namespace
@@ -0,0 +1,187 @@
+/*
+ aa_bow_model.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_AA_BOW_MODEL_H
+#define M8R_AA_BOW_MODEL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../debug.h"
+#include "../../gear/mapped_file.h"
+#include "../../model/note.h"
+#include "aa_neighbor_store.h"
+#include "./nlp/bag_of_words.h"
+#include "./nlp/lexicon.h"
+
+namespace m8r {
+
+constexpr const auto FILENAME_AA_BOW_MODEL = "aa-bow.model";
+
+/**
+ * @brief Persisted BoW associations assessment model.
+ *
+ * Learned AA state is saved to a versioned binary file so that Mind can start
+ * THINKING immediately after restart - only Ns which changed since the model
+ * was saved must be learned again.
+ *
+ * File is little/big endian specific (byte order marker is checked) and it
+ * consists of header and 8B aligned sections:
+ *
+ *   - words      ... lexicon words (index is word ID - frequencies are sums of docs)
+ *   - word chars ... word strings
+ *   - notes      ... N records (index is N index in the model) w/ digest of N
+ *                    content when it was learned - used to detect changed Ns
+ *   - key chars  ... N keys (O path relative to memory + N name)
+ *   - docs       ... N doc vectors (word ID, frequency) sorted by word ID
+ *   - rows       ... AA store rows (N index in the model, AA) - k per N
+ *
+ * Model is read using mmap() and it's validated on load - sections and records
+ * must be within the file, therefore corrupted file is rejected (and model is
+ * learned from scratch).
+ */
+class AaBowModel
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    struct WordRecord {
+        uint32_t chars;
+        uint32_t length;
+    };
+
+    // N's AA row was fully computed
+    static constexpr uint32_t FLAG_COMPUTED = 1;
+
+    struct NoteRecord {
+        uint32_t key;
+        uint32_t keyLength;
+        uint32_t flags;
+        uint32_t rowSize;
+        uint64_t digest;
+        uint32_t docBegin;
+        uint32_t docEnd;
+    };
+
+    struct DocEntry {
+        int32_t id;
+        int32_t frequency;
+    };
+
+private:
+    static constexpr uint32_t ENDIANNESS = 0x01020304;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t k;
+        uint32_t wordsCount;
+        uint32_t notesCount;
+        uint32_t reserved;
+        uint64_t wordsOffset;
+        uint64_t wordCharsOffset;
+        uint64_t wordCharsSize;
+        uint64_t notesOffset;
+        uint64_t keyCharsOffset;
+        uint64_t keyCharsSize;
+        uint64_t docsOffset;
+        uint64_t docsCount;
+        uint64_t rowsOffset;
+    };
+
+    static const char MAGIC[8];
+
+    MappedFile* file;
+
+    const Header* header;
+    const WordRecord* words;
+    const char* wordChars;
+    const NoteRecord* notes;
+    const char* keyChars;
+    const DocEntry* docs;
+    const AaNeighborStore::Neighbor* rows;
+
+public:
+    explicit AaBowModel();
+    AaBowModel(const AaBowModel&) = delete;
+    AaBowModel(const AaBowModel&&) = delete;
+    AaBowModel &operator=(const AaBowModel&) = delete;
+    AaBowModel &operator=(const AaBowModel&&) = delete;
+    ~AaBowModel();
+
+    /**
+     * @brief Map model file to memory and validate it.
+     *
+     * @return false if file doesn't exist, has different version or it's corrupted.
+     */
+    bool load(const std::string& path);
+    bool isLoaded() const { return header != nullptr; }
+    /**
+     * @brief Unmap model file - it must be unloaded before the model is saved.
+     */
+    void unload();
+
+    size_t getK() const { return header->k; }
+
+    size_t getWordsCount() const { return header->wordsCount; }
+    const WordRecord& getWord(size_t id) const { return words[id]; }
+    std::string getWordString(size_t id) const {
+        return std::string{wordChars+words[id].chars, words[id].length};
+    }
+
+    size_t getNotesCount() const { return header->notesCount; }
+    const NoteRecord& getNote(size_t i) const { return notes[i]; }
+    std::string getNoteKey(size_t i) const {
+        return std::string{keyChars+notes[i].key, notes[i].keyLength};
+    }
+    const DocEntry* getDoc(size_t i) const { return docs+notes[i].docBegin; }
+    size_t getDocSize(size_t i) const { return notes[i].docEnd-notes[i].docBegin; }
+    const AaNeighborStore::Neighbor* getRow(size_t i) const { return rows+i*header->k; }
+    size_t getRowSize(size_t i) const { return notes[i].rowSize; }
+
+    /**
+     * @brief Get digest of N content which is learned (name, description, type and tags).
+     */
+    static uint64_t digest(const Note* note);
+
+    /**
+     * @brief Save model - file is written to temporary file and then renamed (atomic replace).
+     *
+     * Model file being replaced must not be loaded by any AaBowModel.
+     *
+     * @param notes      learned Ns - deleted Ns are nullptr (they are skipped).
+     * @param keys       unique N keys - same order as notes.
+     * @param digests    digests of Ns when they were learned.
+     */
+    static bool save(
+            const std::string& path,
+            const Lexicon& lexicon,
+            const std::vector<Note*>& notes,
+            const std::vector<std::string>& keys,
+            const std::vector<uint64_t>& digests,
+            BagOfWords& bow,
+            const AaNeighborStore& store);
+
+private:
+    bool validate() const;
+};
+
+}
+#endif // M8R_AA_BOW_MODEL_H
@@ -0,0 +1,163 @@
+/*
+ aa_minhash_lsh.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "aa_minhash_lsh.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace m8r {
+
+using namespace std;
+
+constexpr int64_t MinHashLsh::NO_GROUP;
+
+MinHashLsh::MinHashLsh(size_t bands, size_t rows)
+    : bands(bands?bands:1),
+      rows(rows?rows:1)
+{
+    // deterministic seeds > the same signatures across runs
+    seeds.resize(this->bands*this->rows);
+    for(size_t i=0; i<seeds.size(); i++) {
+        seeds[i] = mix(i+1);
+    }
+    buckets.resize(this->bands);
+}
+
+MinHashLsh::~MinHashLsh()
+{
+}
+
+void MinHashLsh::reset(size_t notesCount)
+{
+    signatures.assign(notesCount*seeds.size(), UINT32_MAX);
+    indexed.assign(notesCount, false);
+    for(auto& b:buckets) {
+        b.clear();
+    }
+    noteGroups.assign(notesCount, NO_GROUP);
+    groups.clear();
+}
+
+void MinHashLsh::resize(size_t notesCount)
+{
+    if(notesCount > indexed.size()) {
+        signatures.resize(notesCount*seeds.size(), UINT32_MAX);
+        indexed.resize(notesCount, false);
+        noteGroups.resize(notesCount, NO_GROUP);
+    }
+}
+
+void MinHashLsh::remove(size_t note)
+{
+    if(noteGroups[note] != NO_GROUP) {
+        auto group = groups.find(noteGroups[note]);
+        vector<int32_t>& ns = group->second;
+        ns.erase(std::remove(ns.begin(), ns.end(), static_cast<int32_t>(note)), ns.end());
+        if(ns.empty()) {
+            groups.erase(group);
+        }
+        noteGroups[note] = NO_GROUP;
+    }
+    if(!indexed[note]) {
+        return;
+    }
+
+    for(size_t b=0; b<bands; b++) {
+        auto bucket = buckets[b].find(bandHash(note, b));
+        if(bucket != buckets[b].end()) {
+            vector<int32_t>& ns = bucket->second;
+            ns.erase(std::remove(ns.begin(), ns.end(), static_cast<int32_t>(note)), ns.end());
+            if(ns.empty()) {
+                buckets[b].erase(bucket);
+            }
+        }
+    }
+
+    std::fill(signatures.begin()+note*seeds.size(), signatures.begin()+(note+1)*seeds.size(), UINT32_MAX);
+    indexed[note] = false;
+}
+
+void MinHashLsh::add(size_t note, const vector<WeightedTerm>& terms, int64_t group)
+{
+    remove(note);
+    if(group != NO_GROUP) {
+        noteGroups[note] = group;
+        groups[group].push_back(static_cast<int32_t>(note));
+    }
+    if(terms.empty()) {
+        return;
+    }
+
+    uint32_t* signature = &signatures[note*seeds.size()];
+    for(const WeightedTerm& t:terms) {
+        long copies = lround(t.second*WEIGHT_QUANTS);
+        for(long c=0; c<(copies>0?copies:1); c++) {
+            uint64_t h = mix(t.first ^ mix(static_cast<uint64_t>(c)));
+            for(size_t i=0; i<seeds.size(); i++) {
+                uint32_t v = static_cast<uint32_t>(mix(h ^ seeds[i]));
+                if(v < signature[i]) {
+                    signature[i] = v;
+                }
+            }
+        }
+    }
+    indexed[note] = true;
+
+    for(size_t b=0; b<bands; b++) {
+        buckets[b][bandHash(note, b)].push_back(static_cast<int32_t>(note));
+    }
+}
+
+uint64_t MinHashLsh::bandHash(size_t note, size_t band) const
+{
+    const uint32_t* signature = &signatures[note*seeds.size()+band*rows];
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for(size_t r=0; r<rows; r++) {
+        h = mix(h ^ signature[r]);
+    }
+    return h;
+}
+
+void MinHashLsh::getCandidates(size_t note, vector<int32_t>& candidates) const
+{
+    candidates.clear();
+    if(note >= indexed.size()) {
+        return;
+    }
+
+    if(noteGroups[note] != NO_GROUP) {
+        const vector<int32_t>& ns = groups.find(noteGroups[note])->second;
+        candidates.insert(candidates.end(), ns.begin(), ns.end());
+    }
+    for(size_t b=0; indexed[note] && b<bands; b++) {
+        auto bucket = buckets[b].find(bandHash(note, b));
+        if(bucket != buckets[b].end()) {
+            candidates.insert(candidates.end(), bucket->second.begin(), bucket->second.end());
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    auto self = std::lower_bound(candidates.begin(), candidates.end(), static_cast<int32_t>(note));
+    if(self != candidates.end() && *self == static_cast<int32_t>(note)) {
+        candidates.erase(self);
+    }
+}
+
+} // m8r namespace
@@ -0,0 +1,126 @@
+/*
+ aa_minhash_lsh.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_AA_MINHASH_LSH_H
+#define M8R_AA_MINHASH_LSH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "../../debug.h"
+
+namespace m8r {
+
+/**
+ * @brief MinHash signatures w/ LSH banding - AA candidates generator.
+ *
+ * Every N is represented by a set of weighted terms (relevant words, title words, tags, ...),
+ * term is hashed as many times as given by its quantized weight (weighted MinHash).
+ * MinHash signature of bands*rows hashes estimates Jaccard similarity of term sets,
+ * LSH splits signature to bands and Ns whose signatures match in at least one band
+ * share a bucket - such Ns are AA candidates. Probability that Ns w/ similarity s
+ * become candidates is 1-(1-s^rows)^bands:
+ *
+ *   - more bands ... higher recall, more candidates (slower)
+ *   - more rows  ... lower recall, less candidates (faster)
+ *
+ * Ns w/o terms are not indexed (they would all share the same bucket). Ns of the same
+ * group (O) are always candidates as AA bonus for the same O is not an LSH term.
+ *
+ * Index can be updated incrementally - changed N is removed from its buckets and added again.
+ */
+class MinHashLsh
+{
+public:
+    static constexpr size_t DEFAULT_BANDS = 16;
+    static constexpr size_t DEFAULT_ROWS = 2;
+    static constexpr int64_t NO_GROUP = -1;
+    // term weight (0,1] is quantized to this number of term copies
+    static constexpr unsigned WEIGHT_QUANTS = 4;
+
+    // term ID and its weight in (0,1]
+    typedef std::pair<uint64_t,float> WeightedTerm;
+
+private:
+    size_t bands;
+    size_t rows;
+
+    // hash function seeds - bands*rows
+    std::vector<uint64_t> seeds;
+    // N index -> signature (bands*rows hashes)
+    std::vector<uint32_t> signatures;
+    std::vector<bool> indexed;
+    // band -> band hash -> N indices
+    std::vector<std::unordered_map<uint64_t,std::vector<int32_t>>> buckets;
+    // N index -> group, group -> N indices (Ns of the same group are always candidates)
+    std::vector<int64_t> noteGroups;
+    std::unordered_map<int64_t,std::vector<int32_t>> groups;
+
+public:
+    explicit MinHashLsh(size_t bands=DEFAULT_BANDS, size_t rows=DEFAULT_ROWS);
+    MinHashLsh(const MinHashLsh&) = delete;
+    MinHashLsh(const MinHashLsh&&) = delete;
+    MinHashLsh &operator=(const MinHashLsh&) = delete;
+    MinHashLsh &operator=(const MinHashLsh&&) = delete;
+    ~MinHashLsh();
+
+    size_t getBands() const { return bands; }
+    size_t getRows() const { return rows; }
+    size_t size() const { return indexed.size(); }
+
+    /**
+     * @brief Drop index and prepare it for given number of Ns.
+     */
+    void reset(size_t notesCount);
+    void clear() { reset(0); }
+
+    /**
+     * @brief Grow index to given number of Ns (new Ns are not indexed).
+     */
+    void resize(size_t notesCount);
+
+    /**
+     * @brief Compute N signature from its terms and add N to LSH buckets and its group (if >=0).
+     */
+    void add(size_t note, const std::vector<WeightedTerm>& terms, int64_t group=NO_GROUP);
+
+    /**
+     * @brief Remove N from LSH buckets (e.g. before it's added w/ changed terms).
+     */
+    void remove(size_t note);
+
+    /**
+     * @brief Get Ns of N's group and Ns sharing at least one bucket w/ N (N itself excluded), sorted by index.
+     */
+    void getCandidates(size_t note, std::vector<int32_t>& candidates) const;
+
+private:
+    static uint64_t mix(uint64_t x) {
+        // splitmix64 finalizer
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+    uint64_t bandHash(size_t note, size_t band) const;
+};
+
+}
+#endif // M8R_AA_MINHASH_LSH_H
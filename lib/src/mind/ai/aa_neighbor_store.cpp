@@ -0,0 +1,178 @@
+/*
+ aa_neighbor_store.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "aa_neighbor_store.h"
+
+#include <algorithm>
+
+namespace m8r {
+
+using namespace std;
+
+AaNeighborStore::AaNeighborStore(size_t k)
+    : k(k),
+      n(0),
+      clock(0)
+{
+}
+
+AaNeighborStore::~AaNeighborStore()
+{
+}
+
+void AaNeighborStore::reset(size_t notesCount)
+{
+    // keep allocated memory if store doesn't get smaller (re-dream of the same memory),
+    // release it otherwise (amnesia, forgotten Os)
+    const bool shrink = notesCount < n;
+    n = notesCount;
+
+    neighbors.resize(n*k);
+    counts.assign(n, 0);
+    referrers.clear();
+    referrers.resize(n, Referrers{{}, 2*k});
+    clock = 0;
+    computedAt.assign(n, 0);
+    changedAt.assign(n, 0);
+    if(shrink) {
+        neighbors.shrink_to_fit();
+        counts.shrink_to_fit();
+        referrers.shrink_to_fit();
+        computedAt.shrink_to_fit();
+        changedAt.shrink_to_fit();
+    }
+}
+
+void AaNeighborStore::resize(size_t notesCount)
+{
+    if(notesCount <= n) {
+        return;
+    }
+
+    n = notesCount;
+    neighbors.resize(n*k);
+    counts.resize(n, 0);
+    referrers.resize(n, Referrers{{}, 2*k});
+    computedAt.resize(n, 0);
+    changedAt.resize(n, 0);
+}
+
+void AaNeighborStore::invalidate(size_t note)
+{
+    dropRow(note);
+    changedAt[note] = ++clock;
+
+    Referrers& rs = referrers[note];
+    for(int32_t r:rs.rows) {
+        bool full = counts[r] == k;
+        if(remove(r, static_cast<int32_t>(note)) && full && computedAt[r]) {
+            // the best neighbor outside of top-k is not known
+            dropRow(r);
+            changedAt[r] = ++clock;
+        }
+    }
+    rs.rows.clear();
+    rs.limit = 2*k;
+}
+
+bool AaNeighborStore::contains(size_t row, int32_t note) const
+{
+    const Neighbor* r = &neighbors[row*k];
+    for(size_t i=0; i<counts[row]; i++) {
+        if(r[i].note == note) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AaNeighborStore::addReferrer(int32_t note, size_t row)
+{
+    Referrers& rs = referrers[note];
+    rs.rows.push_back(static_cast<int32_t>(row));
+    if(rs.rows.size() > rs.limit) {
+        // drop duplicates and rows which don't contain N anymore (dropped rows, N pushed out)
+        std::sort(rs.rows.begin(), rs.rows.end());
+        rs.rows.erase(std::unique(rs.rows.begin(), rs.rows.end()), rs.rows.end());
+        size_t live = 0;
+        for(int32_t r:rs.rows) {
+            if(contains(r, note)) {
+                rs.rows[live++] = r;
+            }
+        }
+        rs.rows.resize(live);
+        rs.limit = std::max(2*k, 2*live);
+    }
+}
+
+void AaNeighborStore::dropRow(size_t row)
+{
+    counts[row] = 0;
+    computedAt[row] = 0;
+}
+
+bool AaNeighborStore::remove(size_t row, int32_t note)
+{
+    Neighbor* r = &neighbors[row*k];
+    size_t c = counts[row];
+    for(size_t i=0; i<c; i++) {
+        if(r[i].note == note) {
+            for(size_t j=i+1; j<c; j++) {
+                r[j-1] = r[j];
+            }
+            counts[row] = static_cast<uint16_t>(c-1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void AaNeighborStore::offer(size_t row, int32_t note, float aa)
+{
+    // N already in row (offered again) > replace it
+    bool referred = remove(row, note);
+
+    Neighbor* r = &neighbors[row*k];
+    size_t c = counts[row];
+
+    // find insert position: AA descending, lower N index wins tie
+    size_t i = c;
+    while(i>0 && (r[i-1].aa < aa || (r[i-1].aa == aa && r[i-1].note > note))) {
+        i--;
+    }
+    if(i >= k) {
+        // worse than all k neighbors
+        return;
+    }
+
+    // shift worse neighbors (the last one drops out if row is full)
+    size_t last = c<k ? c : k-1;
+    for(size_t j=last; j>i; j--) {
+        r[j] = r[j-1];
+    }
+    r[i].note = note;
+    r[i].aa = aa;
+    if(c<k) {
+        counts[row] = static_cast<uint16_t>(c+1);
+    }
+    if(!referred) {
+        addReferrer(note, row);
+    }
+}
+
+} // m8r namespace
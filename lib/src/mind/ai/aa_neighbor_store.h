@@ -0,0 +1,172 @@
+/*
+ aa_neighbor_store.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_AA_NEIGHBOR_STORE_H
+#define M8R_AA_NEIGHBOR_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef DO_MF_DEBUG
+#include <iostream>
+#endif
+
+#include "../../debug.h"
+
+namespace m8r {
+
+/**
+ * @brief Sparse associations assessment store.
+ *
+ * Replacement of dense Ns x Ns AA matrix - only top-k associations (neighbors)
+ * are kept for every N. Neighbors are stored in a single flat array of N*k slots
+ * (row per N), each row is sorted by AA descending (lower N index wins ties).
+ * Rows which were fully computed (N was assessed w/ all other Ns) are stamped
+ * with logical clock.
+ *
+ * Being associated is symmetric relation: add(x,y) offers the AA to both
+ * row x and row y. When row y is computed, then Ns whose rows were computed
+ * after y's last change can be skipped - their AA w/ y has been already
+ * offered to y (see isAaOffered()). Offers are idempotent - offering AA of
+ * a N which is already in the row updates it.
+ *
+ * When N changes, it's invalidated: its row is dropped and N is removed from
+ * other rows. Full rows which lost N are dropped too as their (k+1)th best
+ * neighbor is not known. Rows which contain N are found using reverse index
+ * (referrers) therefore invalidation is O(in-degree * k), not O(N * k).
+ *
+ * Memory: O(N*k) instead of O(N^2).
+ */
+class AaNeighborStore
+{
+public:
+    struct Neighbor {
+        int32_t note;
+        float aa;
+    };
+
+private:
+    size_t k;
+    size_t n;
+
+    std::vector<Neighbor> neighbors;
+    std::vector<uint16_t> counts;
+    // N -> rows which (might) contain N: superset which is compacted when it doubles
+    struct Referrers {
+        std::vector<int32_t> rows;
+        size_t limit;
+    };
+    std::vector<Referrers> referrers;
+    // logical clock stamps: row computation (0 ~ not computed) and N's last change
+    uint32_t clock;
+    std::vector<uint32_t> computedAt;
+    std::vector<uint32_t> changedAt;
+
+public:
+    explicit AaNeighborStore(size_t k);
+    AaNeighborStore(const AaNeighborStore&) = delete;
+    AaNeighborStore(const AaNeighborStore&&) = delete;
+    AaNeighborStore &operator=(const AaNeighborStore&) = delete;
+    AaNeighborStore &operator=(const AaNeighborStore&&) = delete;
+    ~AaNeighborStore();
+
+    /**
+     * @brief Drop all associations and prepare store for given number of Ns.
+     */
+    void reset(size_t notesCount);
+    void clear() { reset(0); }
+
+    /**
+     * @brief Grow store to given number of Ns keeping associations (new Ns are not computed).
+     */
+    void resize(size_t notesCount);
+
+    size_t size() const { return n; }
+    size_t getK() const { return k; }
+
+    bool isRowComputed(size_t row) const { return computedAt[row] != 0; }
+    void setRowComputed(size_t row) { computedAt[row] = ++clock; }
+
+    /**
+     * @brief Has AA of (x,y) been offered by computation of row x?
+     */
+    bool isAaOffered(size_t x, size_t y) const { return computedAt[x] > changedAt[y]; }
+
+    /**
+     * @brief Drop associations of changed N - row must be computed again.
+     */
+    void invalidate(size_t note);
+
+    /**
+     * @brief Indicate that AA of N (which is in no row) is not known by rows computed so far.
+     */
+    void touch(size_t note) { changedAt[note] = ++clock; }
+
+    /**
+     * @brief Offer AA of (x,y) tuple to both x and y rows.
+     */
+    void add(size_t x, size_t y, float aa) {
+        offer(x, static_cast<int32_t>(y), aa);
+        offer(y, static_cast<int32_t>(x), aa);
+    }
+
+    /**
+     * @brief Get row neighbors sorted by AA (descending) - use getRowSize() to iterate.
+     */
+    const Neighbor* getRow(size_t row) const { return &neighbors[row*k]; }
+    size_t getRowSize(size_t row) const { return counts[row]; }
+
+    /**
+     * @brief Get approximate memory footprint in bytes.
+     */
+    size_t getFootprint() const {
+        size_t footprint = neighbors.capacity()*sizeof(Neighbor) + counts.capacity()*sizeof(uint16_t)
+               + computedAt.capacity()*sizeof(uint32_t) + changedAt.capacity()*sizeof(uint32_t)
+               + referrers.capacity()*sizeof(Referrers);
+        for(const Referrers& r:referrers) {
+            footprint += r.rows.capacity()*sizeof(int32_t);
+        }
+        return footprint;
+    }
+
+private:
+    void offer(size_t row, int32_t note, float aa);
+    bool remove(size_t row, int32_t note);
+    void dropRow(size_t row);
+    bool contains(size_t row, int32_t note) const;
+    void addReferrer(int32_t note, size_t row);
+
+public:
+#ifdef DO_MF_DEBUG
+    void print() const {
+        std::cout << "AA top-" << k << " neighbors[" << n << "]:" << std::endl;
+        for(size_t r=0; r<n; r++) {
+            std::cout << "AA[" << r << "]" << (computedAt[r]?"*":" ") << " = ";
+            const Neighbor* row = getRow(r);
+            for(size_t i=0; i<counts[r]; i++) {
+                std::cout << row[i].note << ":" << row[i].aa << " ";
+            }
+            std::cout << std::endl;
+        }
+    }
+#endif
+};
+
+}
+#endif // M8R_AA_NEIGHBOR_STORE_H
@@ -34,6 +34,9 @@ Ai::Ai(Memory& memory, Mind& mind)
     case Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS:
         aa = new AiAaWeightedFts{memory,mind};
         break;
+    case Configuration::AssociationAssessmentAlgorithm::TF_IDF:
+        aa = new AiAaTfIdf{memory,mind};
+        break;
     default:
         aa = nullptr;
     }
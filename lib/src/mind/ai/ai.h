@@ -29,6 +29,7 @@
 #include "./aa_model.h"
 #include "./ai_aa_weighted_fts.h"
 #include "./ai_aa_bow.h"
+#include "./ai_aa_tf_idf.h"
 #ifdef MF_NER
     #include "./nlp/named_entity_recognition.h"
 #endif
@@ -127,6 +128,15 @@ public:
         return aa->getAssociatedNotes(words, associations, self);
     }
 
+    /**
+     * @brief Learn remembered O incrementally.
+     *
+     * Synchronized by caller ~ Mind.
+     */
+    std::shared_future<bool> remember(Outline* outline) {
+        return aa->remember(outline);
+    }
+
 #ifdef MF_NER
     bool isNerInitialized() const { return ner.isInitialized(); }
 
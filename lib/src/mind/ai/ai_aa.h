@@ -73,6 +73,19 @@ public:
      */
     virtual std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, const Note* self) = 0;
 
+    /**
+     * @brief Learn new and changed Ns of remembered (saved) O incrementally.
+     *
+     * @return future which is false if O was not learned (full learning is needed).
+     */
+    virtual std::shared_future<bool> remember(Outline* outline) {
+        UNUSED_ARG(outline);
+
+        std::promise<bool> p{};
+        p.set_value(false);
+        return std::shared_future<bool>(p.get_future());
+    }
+
     /**
      * @brief Clear.
      */
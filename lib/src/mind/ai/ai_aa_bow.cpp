@@ -18,43 +18,58 @@
 */
 #include "ai_aa_bow.h"
 
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../../gear/async_utils.h"
+
 namespace m8r {
 
 using namespace std;
 
+constexpr float AiAaBoW::AA_NOT_SET;
+
 AiAaBoW::AiAaBoW(Memory& memory, Mind& mind)
     : mind(mind),
       memory(memory),
       lexicon{},
       wordBlacklist{},
-      tokenizer{lexicon,wordBlacklist}
+      tokenizer{lexicon,wordBlacklist},
+      titlesLexicon{},
+      titlesTokenizer{titlesLexicon,wordBlacklist},
+      workers{1},
+      generation{0},
+      aaStore{AA_LEADERBOARD_SIZE},
+      aaCandidates{nullptr},
+      liveNotesWatermark{0},
+      modelPath{},
+      memoryPath{},
+      lastMindDeleteWatermark{0},
+      modelDirty{false},
+      modelSave{},
+      executor{EXECUTOR_THREADS}
 {
 }
 
 AiAaBoW::~AiAaBoW()
 {
-    // delete dead threads
-    auto zombieIterator
-        = std::remove_if(runningWorkers.begin(),
-                         runningWorkers.end(),
-                         [](const thread* t) { if(!t->joinable()) { delete t; return true; } else return false; });
-    runningWorkers.erase(zombieIterator, runningWorkers.end());
-}
-
-void AiAaBoW::addWorkerAndCleanZombies(thread* t)
-{
-    lock_guard<mutex> criticalSection{runningWorkersMutex};
-    MF_DEBUG("AA.BoW: workers+zombies " << runningWorkers.size() << endl);
-
-    // IMPROVE: if zombies is erased > future/promise is deleted as well > frontend that has future calls a method on it > crash
-    //   - temporal SOLUTION: threads are deleted on MF exit (i.e. finished threads are kept in memory for whole MF run)
-    //     (see destructor for dead threads code to move in here)
-    //   - IDEA: frontend could use a thread hook to indicate that it got future and t can be freed
-
-    // add new one
-    runningWorkers.push_back(t);
-
-    MF_DEBUG("AA.BoW: workers " << runningWorkers.size() << endl);
+    // pending tasks are not needed anymore (except model save queued by sleep)
+    executor.cancelPending(PriorityExecutor::PRIORITY_HIGH, &modelPath);
+    // model is saved by executor after the running task - Ns are not modified while waiting
+    executor.submit(
+        &modelPath,
+        PriorityExecutor::PRIORITY_HIGH,
+        [this]() {
+            vector<Note*> live{};
+            vector<string> keys{};
+            return isModelDirty() && getModelNotes(live, keys) && saveModelSync(live, keys);
+        }).wait();
+
+    // stop threads - before data they use are destroyed
+    executor.shutdown();
+
+    delete aaCandidates;
 }
 
 // it's presumed that caller ensures the correct Mind state & synchronization
@@ -63,48 +78,81 @@ shared_future<bool> AiAaBoW::dream() {
         MF_DEBUG("AA.BoW: ASYNC dream..." << endl);
         mind.incActiveProcesses();
 
-        // packaged task is parametrized by function/method signature (not return type)
-        std::packaged_task<bool (AiAaBoW*,thread*)> learnMemoryTask([](AiAaBoW* a,thread* t) { return a->learnMemorySync(t); });
-        future<bool> result = learnMemoryTask.get_future(); // move
-        thread* t = new thread{};
-        *t = thread(std::move(learnMemoryTask), this, t);
-        addWorkerAndCleanZombies(t);
+        bool isNew;
+        shared_future<bool> result = executor.submit(
+            this,
+            PriorityExecutor::PRIORITY_HIGH,
+            [this]() {
+                bool status = learnMemorySync();
+                mind.decActiveProcesses();
+                return status;
+            },
+            &isNew);
+        if(!isNew) {
+            mind.decActiveProcesses();
+        }
 
-        return shared_future<bool>(std::move(result));
+        return result;
     } else {
         MF_DEBUG("AA.BoW: SYNC dream..." << endl);
+        // ASYNC dream is queued after model save
+        waitForModelSave();
         promise<bool> p{};
         bool status = learnMemorySync();
         p.set_value(status);
 
-        mind.persistMindState(Configuration::MindState::THINKING);
-
         return shared_future<bool>(p.get_future());
     }
 }
 
-bool AiAaBoW::learnMemorySync(thread* t)
+bool AiAaBoW::learnMemorySync()
 {
     MF_DEBUG("AA.BoW: LEARNING memory to BoW..." << endl);
+    generation = mind.getGeneration();
     notes.clear();
     memory.getAllNotes(notes);
-    // let N know it's indexed in AI
+    noteIndices.clear();
     for(size_t i=0; i<notes.size(); i++) {
-        notes[i]->setAiAaMatrixIndex(static_cast<int>(i));
+        noteIndices[notes[i]] = i;
     }
 
-    // build lexicon and BoW
+    lastMindDeleteWatermark = mind.getDeleteWatermark();
+    memoryPath = Configuration::getInstance().getMemoryPath();
+    modelPath = getModelPath();
+    digests.resize(notes.size());
+    for(size_t i=0; i<notes.size(); i++) {
+        digests[i] = AaBowModel::digest(notes[i]);
+    }
+
+    // build lexicon and BoW - Ns which didn't change since model was saved are restored
     lexicon.clear();
     bow.clear();
-    for(Note* n:notes) {
-        NoteCharProvider chars{n};
-        WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
-        tokenizer.tokenize(chars, *wfl);
-        bow.add(n, wfl);
+    AaBowModel model{};
+    vector<int> modelIndices(notes.size(), -1);
+    size_t restored = 0;
+    bool loaded = !modelPath.empty() && model.load(modelPath);
+    if(loaded) {
+        restored = restoreDocsSync(model, modelIndices);
+    }
+    // model is saved only if learning changed it (new, changed or deleted Ns)
+    modelDirty = !loaded || restored != notes.size() || restored != model.getNotesCount();
+    for(size_t i=0; i<notes.size(); i++) {
+        if(modelIndices[i] < 0) {
+            WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
+            tokenizer.tokenize(notes[i], *wfl);
+            bow.add(notes[i], wfl);
+        }
     }
+    MF_DEBUG("AA.BoW: " << restored << " Ns restored from model, " << (notes.size()-restored) << " Ns tokenized" << endl);
     // prepare DATA to quickly create association assessment features
     lexicon.recalculateWeights();
-    bow.reorderDocVectorsByWeight();
+    bow.reorderDocVectorsByWeight(AA_WORD_RELEVANCY_THRESHOLD);
+    calculateFeatures();
+    revisions.resize(notes.size());
+    for(size_t i=0; i<notes.size(); i++) {
+        revisions[i] = notes[i]->getRevision();
+    }
+    dirtyRows.clear();
 
 #ifdef DO_MF_DEBUG
     lexicon.print();
@@ -112,23 +160,21 @@ bool AiAaBoW::learnMemorySync(thread* t)
 #endif
 
     // AA to be built incrementally - just initialize it
-    if(notes.size() != aaMatrix.size()) {
-        aaMatrix.clear();
-        aaMatrix.resize(notes.size());
-        for(size_t i=0; i<aaMatrix.size(); ++i) {
-            aaMatrix[i].resize(aaMatrix.size(),(float)AiAaBoW::AA_NOT_SET); // C++ :-Z constexpr w/ internal linkage does NOT have to be solved in compile time > workaround via temporary var
-        }
-    } else {
-        for(size_t i=0; i<aaMatrix.size(); ++i) {
-            std::fill(aaMatrix[i].begin(), aaMatrix[i].end(), (float)AiAaBoW::AA_NOT_SET); // C++ :-Z constexpr w/ internal linkage does NOT have to be solved in compile time > workaround via temporary var
-        }
+    workers = getWorkersCount(Configuration::getInstance().getAaWorkers());
+    aaStore.reset(notes.size());
+    MF_DEBUG("AA.BoW: AA store footprint " << aaStore.getFootprint() << "B, workers " << workers << endl);
+    calculateCandidates();
+    if(restored) {
+        restoreAaSync(model, modelIndices);
     }
+    // model file is replaced when model is saved
+    model.unload();
 
     // NN to be trained on demand - just initialize it
 
+    clearLeaderboards();
+
     mind.persistMindState(Configuration::MindState::THINKING);
-    mind.decActiveProcesses();
-    if(t) t->detach(); // indicate that thread finished
 
     MF_DEBUG("AA.BoW: memory LEARNED!" << endl);
     return true;
@@ -136,393 +182,863 @@ bool AiAaBoW::learnMemorySync(thread* t)
 
 // it's presumed that caller ensures the correct Mind state & synchronization
 shared_future<bool> AiAaBoW::getAssociatedNotes(const Note* note, vector<pair<Note*,float>>& associations) {
-    auto cachedLeaderboard = leaderboardCache.find(note);
-    if(cachedLeaderboard != leaderboardCache.end()) {
-        MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << note->getName() << "'" << endl);
-        // copy leaderboard to ENSURE it's validity even if Mind/AI will be cleared/asleep/...
-        for(auto p:cachedLeaderboard->second) {
-            associations.push_back(p);
-        }
-        // indicate that it's immediately available
-        promise<bool> p{};
-        p.set_value(true);
-        return shared_future<bool>(p.get_future());
-    } else {        
-        MF_DEBUG("AA.BoW: ASYNC leaderboard calculation for '" << note->getName() << "'" << endl);
-        if(leaderboardWip.find(note) != leaderboardWip.end()) {
-            // calculation WIP & future OWNER will update what needs to be updated -> intentionally NOT sharing futures
+    {
+        // Ns deleted > AI must forget them first (async) - cached leaderboards might contain them
+        lock_guard<mutex> criticalSection{leaderboardCacheMutex};
+        auto cachedLeaderboard = leaderboardCache.find(note);
+        if(cachedLeaderboard != leaderboardCache.end()
+           && cachedLeaderboard->second.revision == note->getRevision()
+           && lastMindDeleteWatermark == mind.getDeleteWatermark())
+        {
+            MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << note->getName() << "'" << endl);
+            // copy leaderboard to ENSURE it's validity even if Mind/AI will be cleared/asleep/...
+            for(auto p:cachedLeaderboard->second.leaderboard) {
+                associations.push_back(p);
+            }
+            // indicate that it's immediately available
             promise<bool> p{};
-            p.set_value(false);
-            MF_DEBUG("AA.BoW: leaderboard WIP for '" << note->getName() << "'" << endl);
-            return p.get_future(); // move
-        } else {
-            mind.incActiveProcesses();
-            MF_DEBUG("AA.BoW: starting THREAD for '" << note->getName() << "'" << endl);
+            p.set_value(true);
+            return shared_future<bool>(p.get_future());
+        }
+    }
+
+    MF_DEBUG("AA.BoW: ASYNC leaderboard calculation for '" << note->getName() << "'" << endl);
 
-            // packaged task is parametrized by function/method signature (not return type)
-            packaged_task<bool (AiAaBoW*,const Note*,thread*)> calculateLeaderboardTask([](AiAaBoW* a, const Note* n, thread* t) { return a->calculateLeaderboardSync(n,t); });
-            future<bool> result = calculateLeaderboardTask.get_future(); // move
-            thread* t = new thread{};
-            *t = thread(std::move(calculateLeaderboardTask), this, note, t); // run task w/ handle to self thread
-            addWorkerAndCleanZombies(t);
+    // user navigated to N > pending leaderboards of Ns visited before are not needed anymore
+    for(size_t c=executor.cancelPending(PriorityExecutor::PRIORITY_NORMAL, note); c>0; c--) {
+        mind.decActiveProcesses();
+    }
 
-            return shared_future<bool>(std::move(result));
+    // calculation WIP > caller gets the same future (no duplicate calculation)
+    captureLiveNotes();
+    const u_int32_t revision = note->getRevision();
+    mind.incActiveProcesses();
+    bool isNew;
+    shared_future<bool> result = executor.submit(
+        note,
+        PriorityExecutor::PRIORITY_NORMAL,
+        [this,note,revision]() {
+            bool status = calculateLeaderboardSync(note, revision);
+            mind.decActiveProcesses();
+            return status;
+        },
+        &isNew);
+    if(!isNew) {
+        MF_DEBUG("AA.BoW: leaderboard WIP for '" << note->getName() << "'" << endl);
+        mind.decActiveProcesses();
+    }
+
+    return result;
+}
+
+// it's presumed that caller ensures the correct Mind state & synchronization
+shared_future<bool> AiAaBoW::remember(Outline* outline)
+{
+    MF_DEBUG("AA.BoW: ASYNC learning of remembered O '" << outline->getName() << "'" << endl);
+
+    // Ns are copied under Mind lock - UI may modify Ns while executor learns them
+    captureLiveNotes();
+    shared_ptr<OutlineSnapshot> snapshot = make_shared<OutlineSnapshot>();
+    snapshot->notes.reserve(outline->getNotesCount());
+    for(Note* n:outline->getNotes()) {
+        Note* copy = new Note{*n};
+        copy->setOutline(n->getOutline());
+        snapshot->notes.push_back(std::make_pair(n, copy));
+    }
+    {
+        lock_guard<mutex> criticalSection{snapshotMutex};
+        latestSnapshots[outline] = snapshot;
+    }
+
+    // learned data are modified > serialized w/ dream and leaderboards by executor
+    // (task per snapshot - task of O which is running must not be joined)
+    mind.incActiveProcesses();
+    bool isNew;
+    shared_future<bool> result = executor.submit(
+        snapshot.get(),
+        PriorityExecutor::PRIORITY_HIGH,
+        [this,outline,snapshot]() {
+            bool status = true;
+            bool latest;
+            {
+                lock_guard<mutex> criticalSection{snapshotMutex};
+                auto l = latestSnapshots.find(outline);
+                latest = l != latestSnapshots.end() && l->second == snapshot;
+                if(latest) {
+                    latestSnapshots.erase(l);
+                }
+            }
+            // O remembered again > the newer snapshot is learned by its task
+            if(latest) {
+                status = learnOutlineSync(*snapshot);
+            }
+            mind.decActiveProcesses();
+            return status;
+        },
+        &isNew);
+    if(!isNew) {
+        mind.decActiveProcesses();
+    }
+
+    return result;
+}
+
+size_t AiAaBoW::restoreDocsSync(const AaBowModel& model, vector<int>& modelIndices)
+{
+    // persisted word IDs are kept > restored doc vectors are used as they are
+    for(size_t id=0; id<model.getWordsCount(); id++) {
+        if(!lexicon.restore(model.getWordString(id))) {
+            MF_DEBUG("AA.BoW: model lexicon is corrupted - learning from scratch" << endl);
+            lexicon.clear();
+            return 0;
         }
     }
+
+    unordered_map<string,size_t> modelKeys{};
+    for(size_t m=0; m<model.getNotesCount(); m++) {
+        modelKeys[model.getNoteKey(m)] = m;
+    }
+
+    vector<string> keys{};
+    getNoteKeys(notes, keys);
+    size_t restored = 0;
+    for(size_t i=0; i<notes.size(); i++) {
+        auto m = modelKeys.find(keys[i]);
+        if(m != modelKeys.end() && model.getNote(m->second).digest == digests[i]) {
+            WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
+            const AaBowModel::DocEntry* doc = model.getDoc(m->second);
+            for(size_t j=0; j<model.getDocSize(m->second); j++) {
+                wfl->append(doc[j].id, doc[j].frequency);
+                // lexicon frequency is the sum of doc frequencies
+                lexicon.add(doc[j].id, doc[j].frequency);
+            }
+            bow.add(notes[i], wfl);
+            modelIndices[i] = static_cast<int>(m->second);
+            restored++;
+        }
+    }
+
+    return restored;
 }
 
-// Pre-calculate/calculate code CANNOT be reused as pre-calculate relies on rows w/ lower index
-// to fill the beginning of the line.
-// This is a private method called from AI ~ AI state/async/critical sections handled by caller.
-void AiAaBoW::calculateAaRow(size_t y)
+void AiAaBoW::restoreAaSync(const AaBowModel& model, const vector<int>& modelIndices)
 {
-    MF_DEBUG("AA.BoW: Calculating AA row " << y << "..." << endl);
-    // calculate row and column that cross diagonal on [y][y]
+    // model N index -> N index
+    vector<int> indices(model.getNotesCount(), -1);
+    for(size_t i=0; i<notes.size(); i++) {
+        if(modelIndices[i] >= 0) {
+            indices[modelIndices[i]] = static_cast<int>(i);
+        }
+    }
 
-    // check diagonal to find out whether the cross has been already calculated
-    if(aaMatrix[y][y] == 1.f) {
-        return;
+    for(size_t i=0; i<notes.size(); i++) {
+        if(modelIndices[i] >= 0) {
+            size_t m = static_cast<size_t>(modelIndices[i]);
+            // row which lost a neighbor (changed or deleted N) must be computed again
+            bool complete = model.getNote(m).flags & AaBowModel::FLAG_COMPUTED;
+            const AaNeighborStore::Neighbor* row = model.getRow(m);
+            for(size_t j=0; j<model.getRowSize(m); j++) {
+                int x = indices[row[j].note];
+                if(x >= 0) {
+                    aaStore.add(i, static_cast<size_t>(x), row[j].aa);
+                } else {
+                    complete = false;
+                }
+            }
+            if(complete) {
+                aaStore.setRowComputed(i);
+            }
+        }
     }
 
-    float aa;
-    AssociationAssessmentNotesFeature aaFeature{};
+    // new and changed Ns are not known by restored rows
+    for(size_t i=0; i<notes.size(); i++) {
+        if(modelIndices[i] < 0) {
+            aaStore.touch(i);
+            dirtyRows.insert(i);
+        }
+    }
+}
+
+bool AiAaBoW::getModelNotes(vector<Note*>& live, vector<string>& keys)
+{
+    if(modelPath.empty() || notes.empty() || features.size() != notes.size()) {
+        return false;
+    }
 
-    notes[y]->setAiAaMatrixIndex(y);
-    for(size_t x=0; x<aaMatrix.size(); x++) {
-        // set diagonal at the end
-        if(x!=y) {
-            // skip if value has been already calculated
-            if(aaMatrix[y][x] == AA_NOT_SET) {
-                Note* n1 = notes[x];
-                Note* n2 = notes[y];
-
-                aaFeature.setHaveMutualRel(false); // TODO
-                aaFeature.setTypeMatches(n1->getType()==n2->getType());
-                aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
-                aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
-                aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(n1->getName(),n2->getName()));
-                aaFeature.setSimilarityByDescription(calculateSimilarityByWords(*bow.get(n1),*bow.get(n2),AA_WORD_RELEVANCY_THRESHOLD));
-                aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
-
-                aa = aaFeature.areNotesAssociatedMetric();
-
-                // set AA ranking both below and above diagonal - detection will be faster later (no check x>y needed)
-                aaMatrix[x][y] = aa;
-                aaMatrix[y][x] = aa;
+    // Ns deleted since learning are not persisted
+    live = notes;
+    if(lastMindDeleteWatermark != mind.getDeleteWatermark()) {
+        vector<Note*> memoryNotes{};
+        memory.getAllNotes(memoryNotes);
+        unordered_set<const Note*> existing{memoryNotes.begin(), memoryNotes.end()};
+        for(Note*& n:live) {
+            if(!existing.count(n)) {
+                n = nullptr;
             }
         }
     }
 
-    // set diagonal at the end to indicate calculation is done (consider reentrancy)
-    aaMatrix[y][y] = 1.;
+    getNoteKeys(live, keys);
+    return true;
+}
 
-#ifdef DO_MF_DEBUG
-    MF_DEBUG("AA.BoW: AA row calculated!" << endl);
-    //printAa();
-    //assertAaSymmetry();
-#endif
+bool AiAaBoW::saveModelSync(const vector<Note*>& live, const vector<string>& keys)
+{
+    string directory{}, file{};
+    pathToDirectoryAndFile(modelPath, directory, file);
+    if(!isDirectory(directory.c_str()) && !createDirectory(directory)) {
+        return false;
+    }
+
+    if(AaBowModel::save(modelPath, lexicon, live, keys, digests, bow, aaStore)) {
+        modelDirty = false;
+        return true;
+    }
+    return false;
 }
 
-// This is a private method called from AI ~ AI state/async/critical sections handled by caller.
-void AiAaBoW::precalculateAa()
+bool AiAaBoW::isModelDirty() const
 {
-#ifdef DO_MF_DEBUG
-    static const float UNIQUE_AA_CELLS = (float)(notes.size()*notes.size()/2.+notes.size()/2.);
-    MF_DEBUG("  Building AA matrix w/ " << UNIQUE_AA_CELLS << " UNIQUE rankings..." << endl);
-    float c=0;
-    float p;
-#endif
+    return modelDirty || lastMindDeleteWatermark != mind.getDeleteWatermark();
+}
 
-    // calculate FULL matrix of Ns associativity assessment for every N1 and N2 tuple
-    float aa;
-    AssociationAssessmentNotesFeature aaFeature{};
-    for(size_t y=0; y<aaMatrix.size(); y++) {
-        notes[y]->setAiAaMatrixIndex(y); // sets index for ALL notes in notes vector
+void AiAaBoW::waitForModelSave()
+{
+    if(modelSave.valid()) {
+        modelSave.wait();
+    }
+}
 
-#ifdef DO_MF_DEBUG
-        p = c/(UNIQUE_AA_CELLS/100.);
-        MF_DEBUG("    " << (int)p << "% AA matrix rankings for '" << notes[y]->getName() << "'" << endl);
-#endif
+string AiAaBoW::getModelPath()
+{
+    // model is kept by MF repositories only
+    Configuration& config = Configuration::getInstance();
+    if(config.getMindPath().empty() || !config.getActiveRepository()) {
+        return string{};
+    }
 
-        // calculate only values ABOVE diagonal i.e. initialize x=y
-        for(size_t x=y; x<aaMatrix.size(); x++) {
-#ifdef DO_MF_DEBUG
-            c++;
-#endif
+    string path{config.getActiveRepository()->getDir()};
+    path += FILE_PATH_SEPARATOR;
+    path += DIRNAME_M8R_CACHE;
+    path += FILE_PATH_SEPARATOR;
+    path += FILENAME_AA_BOW_MODEL;
+    return path;
+}
 
-            if(x==y) {
-                aaMatrix[x][y] = 1.;
-            } else {
-                Note* n1 = notes[x];
-                Note* n2 = notes[y];
-
-                aaFeature.setHaveMutualRel(false); // TODO
-                aaFeature.setTypeMatches(n1->getType()==n2->getType());
-                aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
-                aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
-                aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(n1->getName(),n2->getName()));
-                aaFeature.setSimilarityByDescription(calculateSimilarityByWords(*bow.get(n1),*bow.get(n2),AA_WORD_RELEVANCY_THRESHOLD));
-                aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
-
-                aa = aaFeature.areNotesAssociatedMetric();
-
-                // set AA ranking both below and above diagonal - detection will be faster later (no check x>y needed)
-                aaMatrix[x][y] = aa;
-                aaMatrix[y][x] = aa;
+void AiAaBoW::getNoteKeys(const vector<Note*>& notes, vector<string>& keys) const
+{
+    // N keys are not unique (Ns w/ the same name in O) > occurrence is appended
+    unordered_map<string,int> occurrences{};
+    keys.resize(notes.size());
+    for(size_t i=0; i<notes.size(); i++) {
+        keys[i].clear();
+        if(notes[i]) {
+            string key{notes[i]->getKey()};
+            if(stringStartsWith(key, memoryPath)) {
+                key.erase(0, memoryPath.size());
             }
+            int occurrence = occurrences[key]++;
+            if(occurrence) {
+                key += "#";
+                key += std::to_string(occurrence);
+            }
+            keys[i] = key;
         }
     }
+}
 
-#ifdef DO_MF_DEBUG
-    MF_DEBUG("  AA matrix built!" << endl);
-    //printAa();
-    assertAaSymmetry();
-#endif
+void AiAaBoW::captureLiveNotes()
+{
+    const int deleteWatermark = mind.getDeleteWatermark();
+    lock_guard<mutex> criticalSection{snapshotMutex};
+    if(liveNotesWatermark != deleteWatermark) {
+        vector<Note*> memoryNotes{};
+        memory.getAllNotes(memoryNotes);
+        liveNotes.clear();
+        liveNotes.insert(memoryNotes.begin(), memoryNotes.end());
+        liveNotesWatermark = deleteWatermark;
+    }
 }
 
-float AiAaBoW::calculateSimilarityByTitles(const string& t1, const string& t2)
+void AiAaBoW::synchronizeSync()
 {
-    StringCharProvider cp1{t1};
-    WordFrequencyList v1{&lexicon};
-    tokenizer.tokenize(cp1, v1, false, true, false);
-    StringCharProvider cp2{t2};
-    WordFrequencyList v2{&lexicon};
-    tokenizer.tokenize(cp2, v2, false, true, false);
+    u_int32_t mindGeneration = mind.getGeneration();
+    if(generation == mindGeneration) {
+        return;
+    }
 
-    // calculate overlap
-    if(!v1.size() || !v2.size()) {
-        return 0.;
-    } else {
-        // direct access for efficiency
-        WordFrequencyList intersection{&lexicon};
-        float iWeight=0, uWeight=0;
+    // changed and moved Ns are learned by remember() - deleted Ns are those which
+    // are not in memory captured after delete (memory learned later is newer)
+    {
+        lock_guard<mutex> criticalSection{snapshotMutex};
+        if(liveNotesWatermark > lastMindDeleteWatermark) {
+            unordered_set<const Note*> dirtyLeaderboards{};
+            for(size_t i=0; i<notes.size(); i++) {
+                if(notes[i] && !liveNotes.count(notes[i])) {
+                    forgetNoteSync(i, dirtyLeaderboards);
+                }
+            }
+            liveNotes.clear();
 
-        for(auto& e:v1.iterable()) {
-            uWeight += 1;
-            if(v2.contains(e.first)) {
-                iWeight += 1;
-                intersection.add(e.first);
+            // leaderboards: only those touched by deleted Ns are evicted
+            lock_guard<mutex> cacheCriticalSection{leaderboardCacheMutex};
+            for(const Note* d:dirtyLeaderboards) {
+                evictLeaderboard(d);
             }
+            // cached leaderboards are valid again
+            lastMindDeleteWatermark = liveNotesWatermark;
         }
+    }
+
+    generation = mindGeneration;
+}
+
+void AiAaBoW::forgetNoteSync(size_t i, unordered_set<const Note*>& dirtyLeaderboards)
+{
+    MF_DEBUG("AA.BoW: forgetting deleted N " << i << endl);
+
+    // deleted N must NOT be dereferenced
+    const Note* note = notes[i];
+    notes[i] = nullptr;
+    noteIndices.erase(note);
+
+    WordFrequencyList* old = bow.get(const_cast<Note*>(note));
+    if(old) {
+        bool recalculateAllWeights = false;
+        for(auto& w:old->iterable()) {
+            recalculateAllWeights |= lexicon.remove(w.id, w.frequency);
+        }
+        if(recalculateAllWeights) {
+            lexicon.recalculateWeights();
+        } else {
+            for(auto& w:old->iterable()) {
+                lexicon.recalculateWeight(w.id);
+            }
+        }
+        bow.remove(const_cast<Note*>(note));
+    }
+    features[i] = NoteFeatures{-1, -1, {}, {}, nullptr};
+    if(aaCandidates) {
+        aaCandidates->remove(i);
+    }
+
+    aaStore.invalidate(i);
+    dirtyRows.erase(i);
+    modelDirty = true;
+
+    lock_guard<mutex> criticalSection{leaderboardCacheMutex};
+    getTouchedLeaderboards(note, dirtyLeaderboards);
+}
+
+void AiAaBoW::getTouchedLeaderboards(const Note* note, unordered_set<const Note*>& dirtyLeaderboards) const
+{
+    if(leaderboardCache.count(note)) {
+        dirtyLeaderboards.insert(note);
+    }
+    auto with = leaderboardsWith.find(note);
+    if(with != leaderboardsWith.end()) {
+        dirtyLeaderboards.insert(with->second.begin(), with->second.end());
+    }
+}
 
-        for(auto& e:v2.iterable()) {
-            if(!intersection.contains(e.first)) {
-                uWeight += 1;
-                if(v1.contains(e.first)) {
-                    iWeight += 1;
-                    // no need to update iVector as it won't be needed
+void AiAaBoW::cacheLeaderboard(const Note* note, u_int32_t revision, const vector<pair<Note*,float>>& leaderboard)
+{
+    evictLeaderboard(note);
+    leaderboardCache[note] = CachedLeaderboard{revision, leaderboard};
+    for(auto& a:leaderboard) {
+        leaderboardsWith[a.first].insert(note);
+    }
+}
+
+void AiAaBoW::evictLeaderboard(const Note* note)
+{
+    auto cachedLeaderboard = leaderboardCache.find(note);
+    if(cachedLeaderboard != leaderboardCache.end()) {
+        for(auto& a:cachedLeaderboard->second.leaderboard) {
+            auto with = leaderboardsWith.find(a.first);
+            if(with != leaderboardsWith.end()) {
+                with->second.erase(note);
+                if(with->second.empty()) {
+                    leaderboardsWith.erase(with);
                 }
             }
         }
+        leaderboardCache.erase(cachedLeaderboard);
+    }
+}
 
-        //MF_DEBUG("  titleSimilarity = "<<iWeight<<" / "<<uWeight << endl);
-        // intersection % of union
-        return (iWeight/(uWeight/100.))/100;
+void AiAaBoW::clearLeaderboards()
+{
+    lock_guard<mutex> criticalSection{leaderboardCacheMutex};
+    leaderboardCache.clear();
+    leaderboardsWith.clear();
+}
+
+bool AiAaBoW::learnOutlineSync(const OutlineSnapshot& snapshot)
+{
+    if(features.size() != notes.size() || notes.empty()) {
+        // memory not learned (yet) - everything will be learned by dream
+        return false;
     }
+
+    synchronizeSync();
+
+    for(const pair<Note*,Note*>& n:snapshot.notes) {
+        int i = getNoteIndex(n.first);
+        // N moved from other O (refactoring) has the same revision
+        auto o = outlineIds.find(n.second->getOutline());
+        if(i < 0
+           || revisions[i] != n.second->getRevision()
+           || o == outlineIds.end()
+           || o->second != features[i].outline)
+        {
+            learnNoteSync(n.first, n.second);
+        }
+    }
+
+    return true;
 }
 
-// algorithm is based on similarity by words (for now there are no weights - might be added later if needed by other lib functions)
-float AiAaBoW::calculateSimilarityByTags(const vector<const Tag*>* t1, const vector<const Tag*>* t2)
+void AiAaBoW::learnNoteSync(Note* note, const Note* copy)
 {
-    if(!t1->size()) {
-        if(!t2->size()) {
-            return 1.;
-        } else {
-            return 0.;
+    MF_DEBUG("AA.BoW: learning N '" << copy->getName() << "'" << endl);
+    modelDirty = true;
+
+    int index = getNoteIndex(note);
+    size_t i;
+    if(index < 0) {
+        // new N
+        i = notes.size();
+        notes.push_back(note);
+        noteIndices[note] = i;
+        features.emplace_back();
+        revisions.push_back(0);
+        digests.push_back(0);
+        aaStore.resize(notes.size());
+        if(aaCandidates) {
+            aaCandidates->resize(notes.size());
         }
     } else {
-        // direct access for efficiency
-        vector<const Tag*> intersection{};
-        float iWeight=0, uWeight=0;
+        i = static_cast<size_t>(index);
+    }
+    revisions[i] = copy->getRevision();
+    digests[i] = AaBowModel::digest(copy);
+
+    // lexicon: subtract old doc vector, add new one
+    int maxFrequency = lexicon.getMaxFrequency();
+    bool recalculateAllWeights = false;
+    WordFrequencyList* old = bow.get(note);
+    if(old) {
+        for(auto& w:old->iterable()) {
+            recalculateAllWeights |= lexicon.remove(w.id, w.frequency);
+        }
+    }
+    WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
+    tokenizer.tokenize(copy, *wfl);
+    recalculateAllWeights |= maxFrequency != lexicon.getMaxFrequency();
+
+    // weights: ordering of other docs' words is kept (relevant words of other docs are
+    // NOT re-picked - it would be O(repository) ~ dream fixes the drift)
+    if(recalculateAllWeights) {
+        lexicon.recalculateWeights();
+    } else {
+        if(old) {
+            for(auto& w:old->iterable()) {
+                lexicon.recalculateWeight(w.id);
+            }
+        }
+        for(auto& w:wfl->iterable()) {
+            lexicon.recalculateWeight(w.id);
+        }
+    }
+    wfl->sort(AA_WORD_RELEVANCY_THRESHOLD);
+    bow.add(note, wfl); // old doc vector deleted
+
+    calculateNoteFeatures(i, copy);
+    if(aaCandidates) {
+        vector<MinHashLsh::WeightedTerm> terms{};
+        getCandidateTerms(i, terms);
+        aaCandidates->add(i, terms, features[i].outline);
+    }
+
+    // associations: only N's row and rows which contained N are invalidated
+    aaStore.invalidate(i);
+    dirtyRows.insert(i);
 
-        // iterate at most *threshold* words from v1: all + to UNION, matching + to INTERSECTION
-        for(auto& t:*t1) {
-            uWeight += 1;
-            if(std::find(t2->begin(),t2->end(),t) != t2->end()) {
-                iWeight += 1;
-                intersection.push_back(t);
+    // leaderboards: drop N's leaderboard, those which contain N and which N can newly enter
+    lock_guard<mutex> criticalSection{leaderboardCacheMutex};
+    unordered_set<const Note*> dirtyLeaderboards{};
+    getTouchedLeaderboards(note, dirtyLeaderboards);
+    AssociationAssessmentNotesFeature aaFeature{};
+    for(auto& c:leaderboardCache) {
+        const vector<pair<Note*,float>>& leaderboard = c.second.leaderboard;
+        if(!dirtyLeaderboards.count(c.first)) {
+            int x = getNoteIndex(c.first);
+            if(x < 0
+               || leaderboard.size() < static_cast<size_t>(AA_LEADERBOARD_SIZE)
+               || calculateAa(features[x], features[i], aaFeature) >= leaderboard.back().second)
+            {
+                dirtyLeaderboards.insert(c.first);
             }
         }
-        // uWeight contains weight of v1's tags, iWeight weight of v1 intersection v2
-
-        // iterate tags from v2: w in intersection HANDLED both u&i, w in v2&v1 > intersection else union
-        for(auto& t:*t2) {
-            if(std::find(intersection.begin(),intersection.end(),t) == intersection.end()) {
-                uWeight += 1;
-                if(std::find(t1->begin(),t1->end(),t) != t1->end()) {
-                    iWeight += 1;
-                    // no need to update iVector as it won't be needed
+    }
+    for(const Note* d:dirtyLeaderboards) {
+        evictLeaderboard(d);
+    }
+}
+
+void AiAaBoW::calculateFeatures()
+{
+    outlineIds.clear();
+    typeIds.clear();
+    tagIds.clear();
+
+    titlesLexicon.clear();
+    features.clear();
+    features.resize(notes.size());
+    for(size_t i=0; i<notes.size(); i++) {
+        calculateNoteFeatures(i, notes[i]);
+    }
+}
+
+void AiAaBoW::calculateNoteFeatures(size_t i, const Note* n)
+{
+    NoteFeatures& f = features[i];
+    f.tags.clear();
+    f.titleWords.clear();
+
+    f.outline = outlineIds.emplace(n->getOutline(), static_cast<int>(outlineIds.size())).first->second;
+    f.type = typeIds.emplace(n->getType(), static_cast<int>(typeIds.size())).first->second;
+
+    for(const Tag* t:*n->getTags()) {
+        f.tags.push_back(tagIds.emplace(t, static_cast<int>(tagIds.size())).first->second);
+    }
+    std::sort(f.tags.begin(), f.tags.end());
+    f.tags.erase(std::unique(f.tags.begin(), f.tags.end()), f.tags.end());
+
+    // tokenize title once (lowercase, no stemming, no blacklist)
+    WordFrequencyList titleWords{&titlesLexicon};
+    titlesTokenizer.tokenize(n->getName(), titleWords, false, true, false);
+    for(auto& w:titleWords.iterable()) {
+        f.titleWords.push_back(w.id);
+    }
+
+    f.words = bow.get(notes[i]);
+}
+
+int AiAaBoW::getNoteIndex(const Note* note) const
+{
+    auto i = noteIndices.find(note);
+    if(i != noteIndices.end()) {
+        return static_cast<int>(i->second);
+    }
+    return -1;
+}
+
+void AiAaBoW::calculateCandidates()
+{
+    delete aaCandidates;
+    aaCandidates = nullptr;
+
+    Configuration& config = Configuration::getInstance();
+    int bands = config.getAaLshBands();
+    if(bands<=0 || static_cast<int>(notes.size())<=config.getAaLshNotesThreshold()) {
+        return;
+    }
+
+    MF_DEBUG("AA.BoW: indexing " << notes.size() << " Ns to LSH w/ " << bands << " bands..." << endl);
+    aaCandidates = new MinHashLsh{static_cast<size_t>(bands), AA_LSH_ROWS};
+    aaCandidates->reset(notes.size());
+
+    vector<MinHashLsh::WeightedTerm> terms{};
+    for(size_t i=0; i<features.size(); i++) {
+        getCandidateTerms(i, terms);
+        aaCandidates->add(i, terms, features[i].outline);
+    }
+}
+
+// N terms: relevant description words (lexicon weight), title words and tags - kinds in disjoint ranges
+void AiAaBoW::getCandidateTerms(size_t i, vector<MinHashLsh::WeightedTerm>& terms) const
+{
+    const NoteFeatures& f = features[i];
+    terms.clear();
+    if(f.words) {
+        for(auto& w:f.words->getRelevantWords()) {
+            terms.push_back(std::make_pair(static_cast<uint64_t>(w.id), lexicon.getWeight(w.id)));
+        }
+    }
+    for(int w:f.titleWords) {
+        terms.push_back(std::make_pair(1ULL<<32 | static_cast<uint64_t>(w), 1.f));
+    }
+    for(int t:f.tags) {
+        terms.push_back(std::make_pair(2ULL<<32 | static_cast<uint64_t>(t), 1.f));
+    }
+}
+
+float AiAaBoW::calculateAa(const NoteFeatures& n1, const NoteFeatures& n2, AssociationAssessmentNotesFeature& aaFeature)
+{
+    aaFeature.setHaveMutualRel(false); // TODO
+    aaFeature.setTypeMatches(n1.type==n2.type);
+    aaFeature.setSimilaritySameOutline(n1.outline==n2.outline);
+    aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1.tags,n2.tags));
+    aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(n1.titleWords,n2.titleWords));
+    aaFeature.setSimilarityByDescription(calculateSimilarityByWords(*n1.words,*n2.words));
+    aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
+
+    return aaFeature.areNotesAssociatedMetric();
+}
+
+// This is a private method called from AI ~ AI state/async/critical sections handled by caller.
+void AiAaBoW::calculateAaRow(size_t y)
+{
+    MF_DEBUG("AA.BoW: Calculating AA row " << y << "..." << endl);
+
+    // check bitmap to find out whether the row has been already calculated
+    if(aaStore.isRowComputed(y)) {
+        return;
+    }
+
+    // big repository: assess LSH candidates only - candidacy is symmetric, therefore
+    // skipping Ns w/ calculated row below stays valid
+    vector<int32_t> candidates{};
+    if(aaCandidates) {
+        aaCandidates->getCandidates(y, candidates);
+        MF_DEBUG("AA.BoW: " << candidates.size() << " LSH candidates" << endl);
+    }
+    size_t columns = aaCandidates?candidates.size():aaStore.size();
+
+    // workers publish AA to disjoint slots > no locking
+    vector<float> row(columns, AA_NOT_SET);
+    parallelForBlocks(
+        columns,
+        AA_COLUMNS_BLOCK_SIZE,
+        workers,
+        [this,y,&row,&candidates](unsigned int, size_t begin, size_t end) {
+            AssociationAssessmentNotesFeature aaFeature{};
+            for(size_t c=begin; c<end; c++) {
+                size_t x = aaCandidates?static_cast<size_t>(candidates[c]):c;
+                // skip self, deleted Ns and Ns w/ calculated row - their AA w/ y has been already offered to y
+                if(x!=y && notes[x] && !aaStore.isAaOffered(x, y)) {
+                    row[c] = calculateAa(features[x], features[y], aaFeature);
                 }
             }
+        });
+
+    for(size_t c=0; c<row.size(); c++) {
+        if(row[c] != AA_NOT_SET) {
+            aaStore.add(aaCandidates?static_cast<size_t>(candidates[c]):c, y, row[c]);
         }
+    }
 
-        //MF_DEBUG("  tagSimilarity = "<<iWeight<<" / "<<uWeight << endl);
-        // intersection % of union
-        return (iWeight/(uWeight/100.))/100;
+    // mark row at the end to indicate calculation is done (consider reentrancy)
+    aaStore.setRowComputed(y);
+    dirtyRows.erase(y);
+    modelDirty = true;
+
+#ifdef DO_MF_DEBUG
+    MF_DEBUG("AA.BoW: AA row calculated!" << endl);
+    //printAa();
+#endif
+}
+
+// Jaccard index of sorted ID sets - merge-join w/o allocations
+static float calculateIdSetsJaccard(const vector<int>& s1, const vector<int>& s2)
+{
+    float iWeight=0, uWeight=0;
+    auto i1 = s1.begin(), e1 = s1.end();
+    auto i2 = s2.begin(), e2 = s2.end();
+    while(i1!=e1 && i2!=e2) {
+        uWeight += 1;
+        if(*i1 < *i2) {
+            ++i1;
+        } else if(*i2 < *i1) {
+            ++i2;
+        } else {
+            iWeight += 1;
+            ++i1;
+            ++i2;
+        }
     }
+    uWeight += (e1-i1) + (e2-i2);
+
+    // intersection % of union
+    return (iWeight/(uWeight/100.))/100;
 }
 
-// consider ONLY most valuable words via threshold - many irrelevat words would kill the score (irrelevant words make noise)
-float AiAaBoW::calculateSimilarityByWords(WordFrequencyList& v1, WordFrequencyList& v2, int threshold)
+float AiAaBoW::calculateSimilarityByTitles(const vector<int>& t1, const vector<int>& t2)
+{
+    // calculate overlap
+    if(!t1.size() || !t2.size()) {
+        return 0.;
+    } else {
+        return calculateIdSetsJaccard(t1, t2);
+    }
+}
+
+// algorithm is based on similarity by words (for now there are no weights - might be added later if needed by other lib functions)
+float AiAaBoW::calculateSimilarityByTags(const vector<int>& t1, const vector<int>& t2)
+{
+    if(!t1.size()) {
+        if(!t2.size()) {
+            return 1.;
+        } else {
+            return 0.;
+        }
+    } else {
+        return calculateIdSetsJaccard(t1, t2);
+    }
+}
+
+// consider ONLY most valuable words (picked on learning) - many irrelevat words would kill the score (irrelevant words make noise)
+float AiAaBoW::calculateSimilarityByWords(const WordFrequencyList& v1, const WordFrequencyList& v2)
 {
     if(!v1.size() || !v2.size()) {
         return 0.;
     } else {
-        // direct access for efficiency
-        WordFrequencyList intersection{&lexicon};
+        // all vectors are sorted by word ID > merge-joins w/o lookups and allocations
+        const vector<float>& weights = lexicon.getWeights();
+        const vector<WordFrequencyList::WordFrequency>& r1 = v1.getRelevantWords();
+        const vector<WordFrequencyList::WordFrequency>& r2 = v2.getRelevantWords();
+        const vector<WordFrequencyList::WordFrequency>& a1 = v1.iterable();
+        const vector<WordFrequencyList::WordFrequency>& a2 = v2.iterable();
         float iWeight=0, uWeight=0;
-        int t=0;
 
-        // iterate at most *threshold* words from v1: all + to UNION, matching + to INTERSECTION
-        for(auto& e:v1.iterable()) {
-            if(t++>=threshold) break;
-
-            float w = lexicon.get(e.first)->weight;
+        // relevant words from v1: all + to UNION, words in v2 + to INTERSECTION
+        auto j = a2.begin();
+        for(auto& e:r1) {
+            float w = weights[e.id];
             uWeight += w;
-            if(v2.contains(e.first)) {
+            while(j!=a2.end() && j->id < e.id) ++j;
+            if(j!=a2.end() && j->id == e.id) {
                 iWeight += w;
-                intersection.add(e.first);
             }
         }
-        // uWeight contains weight of 1st 10 v1's words, iWeight weight of v1 intersection v2
-
-        // iterate at most *threshold* words from v2: w in intersection HANDLED both u&i, w in v2&v1 > intersection else union
-        t=0;
-        for(auto& e:v2.iterable()) {
-            // consider at most threshold words from v2
-            if(++t>=threshold) break;
-
-            if(!intersection.contains(e.first)) {
-                float w = lexicon.get(e.first)->weight;
-                uWeight += w;
-                if(v1.contains(e.first)) {
-                    iWeight += w;
-                    // no need to update iVector as it won't be needed
-                }
+        // uWeight contains weight of v1's relevant words, iWeight weight of v1 relevant intersection v2
+
+        // relevant words from v2: w in v1's relevant HANDLED both u&i, w in v1 > intersection else union
+        auto k = r1.begin();
+        j = a1.begin();
+        for(auto& e:r2) {
+            while(k!=r1.end() && k->id < e.id) ++k;
+            if(k!=r1.end() && k->id == e.id) {
+                continue;
+            }
+            float w = weights[e.id];
+            uWeight += w;
+            while(j!=a1.end() && j->id < e.id) ++j;
+            if(j!=a1.end() && j->id == e.id) {
+                iWeight += w;
             }
         }
 
         // intersection % of union
         float result = (iWeight/(uWeight/100.))/100;
-        //MF_DEBUG("  wordSimilarity = "<<iWeight<<" / "<<uWeight <<" (t="<<t<<") -> " << result << endl);
+        //MF_DEBUG("  wordSimilarity = "<<iWeight<<" / "<<uWeight <<" -> " << result << endl);
         return result;
     }
 }
 
-bool AiAaBoW::calculateLeaderboardSync(const Note* n, thread* t)
+bool AiAaBoW::calculateLeaderboardSync(const Note* n, u_int32_t revision)
 {
-    MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << n->getName() << "' in thread " << t << endl);
+    synchronizeSync();
 
     // If N was REMOVED, then nobody will ask for leaderboard.
-    // If N was MODIFIED, then leaderboard will not be accurate (but it's not critical).
-    // If N was ADDED, then I don't have data - no leaderboard provided.
-    if(n->getAiAaMatrixIndex() != AA_NOT_SET) {
-        // check cache
-        auto cachedLeaderboard = leaderboardCache.find(n);
-        if(cachedLeaderboard != leaderboardCache.end()) {
-            return true;
-        }
-
-        // calculate row/column of AA matrix & build leaderboard
-        calculateAaRow(n->getAiAaMatrixIndex());
-
-        int aaLeaderboard[AA_LEADERBOARD_SIZE][2];
-        for(int i=0; i<AA_LEADERBOARD_SIZE; i++) {
-            aaLeaderboard[i][0] = aaLeaderboard[i][1] = AA_NOT_SET;
+    // If N was MODIFIED, then it's learned by remember() - leaderboard is calculated again.
+    // If N was ADDED, then it's learned by remember() - no leaderboard until then.
+    // N is used as key only - it might have been deleted (dangling) since the task was queued
+    int index = getNoteIndex(n);
+    if(index >= 0) {
+        size_t y = static_cast<size_t>(index);
+        MF_DEBUG("AA.BoW: SYNC leaderboard calculation for N " << y << endl);
+        // check cache - entries affected by Mind changes were evicted by synchronization
+        {
+            lock_guard<mutex> criticalSection{leaderboardCacheMutex};
+            auto cachedLeaderboard = leaderboardCache.find(n);
+            if(cachedLeaderboard != leaderboardCache.end() && cachedLeaderboard->second.revision == revision) {
+                return true;
+            }
         }
 
-        float aa;
-        for(size_t x=0, y=n->getAiAaMatrixIndex(); x<notes.size(); x++) {
-            if(x==y) continue; // self on diagonal
-
-            aa = aaMatrix[x][y];
-
-            if(aa > aaLeaderboard[AA_LEADERBOARD_SIZE-1][0]) { // covers also lb[][]==NOT_SET (== -1)
-                // find target leaderboard row
-                size_t target;
-                for(target=0; target<AA_LEADERBOARD_SIZE; target++) {
-                    if(aaLeaderboard[target][0] == AA_NOT_SET) {
-                        break; // fill empty row -> no shift needed
-                    } else {
-                        if(aa > aaMatrix[aaLeaderboard[target][0]][aaLeaderboard[target][1]]) {
-                            break;
-                        }
-                    }
-                }
-
-                /// empty row > no shift needed
-                if(aaLeaderboard[target][0] != AA_NOT_SET) {
-                    // shift leaderboard
-                    int sx = aaLeaderboard[target][0];
-                    int sy = aaLeaderboard[target][1];
-                    for(size_t ll=target; ll<AA_LEADERBOARD_SIZE; ll++) {
-                        if(aaLeaderboard[ll][0]!=AA_NOT_SET) {
-                            int tx=aaLeaderboard[ll][0];
-                            int ty=aaLeaderboard[ll][1];
-                            aaLeaderboard[ll][0]=sx;
-                            aaLeaderboard[ll][1]=sy;
-                            sx=tx;
-                            sy=ty;
-                        } else {
-                            aaLeaderboard[ll][0]=sx;
-                            aaLeaderboard[ll][1]=sy;
-                            break;
-                        }
-                    }
-                }
-
-                // assign value
-                aaLeaderboard[target][0]=x;
-                aaLeaderboard[target][1]=y;
+        // calculate row of AA store - it's the leaderboard (sorted by AA)
+        calculateAaRow(y);
+        // changed Ns were not offered to computed rows yet
+        if(!dirtyRows.empty()) {
+            AssociationAssessmentNotesFeature aaFeature{};
+            for(size_t d:dirtyRows) {
+                aaStore.add(y, d, calculateAa(features[y], features[d], aaFeature));
             }
         }
 
-        MF_DEBUG("Leaderboard of " << n->getName() << " (" << n->getOutline()->getName() << "):" << endl);
+        // Ns are not dereferenced - UI may modify them
+        MF_DEBUG("Leaderboard of N " << y << ":" << endl);
         vector<pair<Note*,float>> leaderboard{};
-        for(int i=0; i<AA_LEADERBOARD_SIZE && aaLeaderboard[i][0]!=AA_NOT_SET; i++) {
-            MF_DEBUG("  #" << i << " " <<
-                     notes[aaLeaderboard[i][0]]->getName() << " (" << notes[aaLeaderboard[i][0]]->getOutline()->getName() << ")" <<
-                     " ~ " << aaMatrix[aaLeaderboard[i][0]][aaLeaderboard[i][1]] << endl);
-            leaderboard.push_back(std::make_pair(notes[aaLeaderboard[i][0]],aaMatrix[aaLeaderboard[i][0]][aaLeaderboard[i][1]]));
+        const AaNeighborStore::Neighbor* row = aaStore.getRow(y);
+        for(size_t i=0; i<aaStore.getRowSize(y); i++) {
+            MF_DEBUG("  #" << i << " N " << row[i].note << " ~ " << row[i].aa << endl);
+            leaderboard.push_back(std::make_pair(notes[row[i].note],row[i].aa));
         }
 
         // cache leaderboard (copied)
-        leaderboardCache[n] = leaderboard;
+        lock_guard<mutex> criticalSection{leaderboardCacheMutex};
+        cacheLeaderboard(n, revision, leaderboard);
     }
 
-    leaderboardWip.erase(n);
-    mind.decActiveProcesses();
-    if(t) t->detach(); // indicate that thread finished
     return true;
 }
 
-void AiAaBoW::assertAaSymmetry()
-{
-    MF_DEBUG("AI: checking AA symmetry..." << endl);
-    for(size_t i=0; i<aaMatrix.size(); ++i) {
-        for(size_t j=0; i<aaMatrix.size(); ++i) {
-            if(aaMatrix[i][j] != aaMatrix[j][i]) {
-                MF_DEBUG("  Symmetry ERROR: aa["<<i<<"]["<<j<<"]" << endl);
-            }
-        }
+// it's presumed that caller ensures the correct Mind state & synchronization
+bool AiAaBoW::sleep() {
+    // learned data of the previous sleep might be still saved
+    waitForModelSave();
+
+    clearLeaderboards();
+
+    // model is saved by executor - Ns are dereferenced now as memory may be forgotten
+    // before the save (learned data are dropped after the save)
+    shared_ptr<vector<Note*>> live = make_shared<vector<Note*>>();
+    shared_ptr<vector<string>> keys = make_shared<vector<string>>();
+    if(isModelDirty() && getModelNotes(*live, *keys)) {
+        modelSave = executor.submit(
+            &modelPath,
+            PriorityExecutor::PRIORITY_HIGH,
+            [this,live,keys]() {
+                bool status = saveModelSync(*live, *keys);
+                clearSync();
+                return status;
+            });
+    } else {
+        clearSync();
     }
-    MF_DEBUG("AI: AA symmetry checked!" << endl);
+
+    return true;
 }
 
-// it's presumed that caller ensures the correct Mind state & synchronization
-bool AiAaBoW::sleep() {
+void AiAaBoW::clearSync()
+{
     lexicon.clear();
+    titlesLexicon.clear();
+    features.clear();
+    revisions.clear();
+    digests.clear();
+    outlineIds.clear();
+    typeIds.clear();
+    tagIds.clear();
+    dirtyRows.clear();
     notes.clear();
+    noteIndices.clear();
     outlines.clear();
     bow.clear();
-
-    return true;
+    modelDirty = false;
 }
 
 // it's presumed that caller ensures the correct Mind state & synchronization
 bool AiAaBoW::amnesia() {
     sleep();
-    aaMatrix.clear();
+    waitForModelSave();
+    aaStore.clear();
+    delete aaCandidates;
+    aaCandidates = nullptr;
 
     return true;
 }
@@ -19,10 +19,21 @@
 #ifndef M8R_AI_ASSOCIATIONS_ASSESSMENT_BOW_H
 #define M8R_AI_ASSOCIATIONS_ASSESSMENT_BOW_H
 
+#include <atomic>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "../mind.h"
+#include "../../gear/priority_executor.h"
 #include "ai_aa.h"
+#include "aa_neighbor_store.h"
+#include "aa_minhash_lsh.h"
+#include "aa_bow_model.h"
+#include "aa_notes_feature.h"
 #include "./nlp/markdown_tokenizer.h"
 #include "./nlp/note_char_provider.h"
 #include "./nlp/bag_of_words.h"
@@ -41,10 +52,13 @@ class Mind;
 class AiAaBoW : public AiAssociationsAssessment
 {
 private:
-    static constexpr int THREAD_POOL_SIZE = 2; // IMPROVE thread pool size to be either configured OR #CPU detected and 1/2 or 1/3 used
+    // columns of AA row claimed by AA workers at once
+    static constexpr size_t AA_COLUMNS_BLOCK_SIZE = 256;
+    static constexpr unsigned int EXECUTOR_THREADS = 1;
     static constexpr float AA_NOT_SET = -1.f;
     static constexpr int AA_WORD_RELEVANCY_THRESHOLD = 10; // use 10 words w/ highest weight from vectors (and ignore others - irrelevant can bring noice with volume)
     static constexpr float AA_TITLE_WORD_BONUS = 0.2f;
+    static constexpr size_t AA_LSH_ROWS = MinHashLsh::DEFAULT_ROWS;
 
 private:
     Mind& mind;
@@ -54,6 +68,12 @@ private:
     CommonWordsBlacklist wordBlacklist;
     BagOfWords bow;
     MarkdownTokenizer tokenizer;
+    // N titles tokenized once on learning - AA workers must NOT modify shared lexicon
+    Lexicon titlesLexicon;
+    MarkdownTokenizer titlesTokenizer;
+
+    // number of threads used to calculate AA
+    unsigned int workers;
 
     /*
      * Data sets
@@ -61,8 +81,33 @@ private:
 
     // Os - vector index is used as ID through other data structures like similarity matrices
     std::vector<Outline*> outlines; // IMPROVE make O* pair where .second is O embedding w/ classifications/attributes
-    // Ns - vector index is used as ID through other data structures
+    // Ns - vector index is used as ID through other data structures (deleted Ns are nullptr)
     std::vector<Note*> notes; // IMPROVE make N* pair where .second is N embedding w/ classifications/attributes
+    // N -> index in notes vector (owned by executor - N is key only, never dereferenced)
+    std::unordered_map<const Note*,size_t> noteIndices;
+
+    /**
+     * @brief N features computed once per dream - AA kernel just combines them.
+     *
+     * Things are represented by dense IDs assigned on learning, ID sets are sorted.
+     */
+    struct NoteFeatures {
+        int outline;
+        int type;
+        std::vector<int> titleWords;
+        std::vector<int> tags;
+        const WordFrequencyList* words;
+    };
+    // N index (in notes vector) -> features
+    std::vector<NoteFeatures> features;
+    // N index -> N revision when it was learned (changed Ns are learned incrementally)
+    std::vector<u_int32_t> revisions;
+    // N index -> digest of N content when it was learned (persisted model)
+    std::vector<uint64_t> digests;
+    // dense IDs of Things shared by Ns
+    std::map<const Outline*,int> outlineIds;
+    std::map<const NoteType*,int> typeIds;
+    std::map<const Tag*,int> tagIds;
 
     /*
      * Associations
@@ -70,16 +115,80 @@ private:
 
     // associate Ns as you READ: N -> O/N
     // IMPROVE thing*,float - both O and N to be association
-    std::map<const Note*,std::vector<std::pair<Note*,float>>> leaderboardCache;
-    std::set<const Note*> leaderboardWip;
+    // leaderboards are calculated by executor thread and read by the caller's thread
+    struct CachedLeaderboard {
+        // N revision when leaderboard was calculated
+        u_int32_t revision;
+        std::vector<std::pair<Note*,float>> leaderboard;
+    };
+    // entries touched by changed/deleted Ns are evicted when AI learns/forgets these Ns,
+    // therefore entry is valid if N revision matches and deleted Ns were forgotten
+    std::unordered_map<const Note*,CachedLeaderboard> leaderboardCache;
+    // N -> Ns whose cached leaderboard contains N (leaderboards touched by N change)
+    std::unordered_map<const Note*,std::unordered_set<const Note*>> leaderboardsWith;
+    std::mutex leaderboardCacheMutex;
+    // Mind generation AI is synchronized with (changes were processed)
+    std::atomic<u_int32_t> generation;
 
     // associate as you WRITE: word(s) -> O/N
     // IMPROVE std::map<const Note*,std::vector<std::pair<string*,float>>> leaderboardCache;
 
-    // Associations assessment matrix w/ rankings for any N1/N2 tuple (diagonal symmetry).
-    // Changed from float** to vector<vector>> to enable row/col extension on new N/O
-    // (keep & avoid realloc)
-    std::vector<std::vector<float>> aaMatrix; // IMPROVE: notesAA and outlinesAA ~ Notes assocications assessment
+    // Associations assessment store w/ top-k rankings for every N (row index is N index
+    // in notes vector) - dense Ns x Ns matrix does NOT scale to bigger repositories.
+    AaNeighborStore aaStore; // IMPROVE: notesAA and outlinesAA ~ Notes assocications assessment
+
+    // AA candidates generator - nullptr if AA is assessed for all Ns (small repository/disabled)
+    MinHashLsh* aaCandidates;
+
+    // changed Ns w/ invalidated AA row which was not computed yet - other rows miss their AA
+    std::set<size_t> dirtyRows;
+
+    /*
+     * Executor must NOT read Ns and memory which are modified by the caller's (UI) thread:
+     * remembered O's Ns are copied and (after deletes) Ns in memory are captured by the
+     * caller's thread under Mind lock, executor learns these snapshots only.
+     */
+    struct OutlineSnapshot {
+        // live N (key of learned data, never dereferenced by executor) -> N copy w/ N's O
+        std::vector<std::pair<Note*,Note*>> notes;
+
+        explicit OutlineSnapshot() {}
+        OutlineSnapshot(const OutlineSnapshot&) = delete;
+        OutlineSnapshot(const OutlineSnapshot&&) = delete;
+        OutlineSnapshot &operator=(const OutlineSnapshot&) = delete;
+        OutlineSnapshot &operator=(const OutlineSnapshot&&) = delete;
+        ~OutlineSnapshot() {
+            for(auto& n:notes) {
+                delete n.second;
+            }
+        }
+    };
+    std::mutex snapshotMutex;
+    // O -> the latest snapshot (older snapshots of O are skipped)
+    std::map<const Outline*,std::shared_ptr<OutlineSnapshot>> latestSnapshots;
+    // Ns in memory captured when Mind delete watermark changed
+    int liveNotesWatermark;
+    std::unordered_set<const Note*> liveNotes;
+
+    /*
+     * Learned model is persisted to MF repository so that Ns which didn't change
+     * are NOT learned again after restart (paths are captured on learning).
+     */
+    std::string modelPath;
+    std::string memoryPath;
+    // learned Ns might have been deleted since learning (pointers would dangle)
+    std::atomic<int> lastMindDeleteWatermark;
+    // learned data changed since model was loaded/saved (owned by executor)
+    bool modelDirty;
+    // model is saved by executor on sleep - learned data are dropped after save
+    std::shared_future<bool> modelSave;
+
+    /*
+     * Async work (dream, leaderboards) is run by executor w/ fixed number of threads:
+     * one thread serializes access to AA store and learned data, CPU intensive AA
+     * computations are parallelized by AA workers.
+     */
+    PriorityExecutor executor;
 
 public:
     explicit AiAaBoW(Memory& memory, Mind& mind);
@@ -121,36 +230,135 @@ public:
         return std::shared_future<bool>(p.get_future());
     }
 
+    virtual std::shared_future<bool> remember(Outline* outline);
+
     virtual bool sleep();
 
     virtual bool amnesia();
 
 private:
 
-    /*
-     * Worker threads:
-     *  1. packaged task is assigned to thread
-     *  2. thread performs the task and calls detach() on self when finishes
-     *     to indicate that it's ready to be deleted
-     *  3. if main thread detects that !thread.joinable(), then it can be deleted;
-     *     cleanup is done on any new thread launch AND/OR by this class destructor.
+    /**
+     * @brief Learn Memory to start thinking.
+     */
+    bool learnMemorySync();
+
+    /**
+     * @brief Restore lexicon and doc vectors of Ns which didn't change since model was saved.
+     *
+     * @param modelIndices  N index -> model N index (-1 if N must be learned).
+     * @return number of restored Ns.
      */
+    size_t restoreDocsSync(const AaBowModel& model, std::vector<int>& modelIndices);
 
-    // IMPROVE introduce a LIMIT on number of running threads in configuration
-    std::vector<std::thread*> runningWorkers;
-    std::mutex runningWorkersMutex;
+    /**
+     * @brief Restore AA rows of Ns restored from model - rows are computed if no neighbor is lost.
+     */
+    void restoreAaSync(const AaBowModel& model, const std::vector<int>& modelIndices);
 
-private:
+    /**
+     * @brief Get learned Ns to be saved (deleted Ns are nullptr) and their keys - Ns are dereferenced.
+     *
+     * @return false if model cannot be saved.
+     */
+    bool getModelNotes(std::vector<Note*>& live, std::vector<std::string>& keys);
 
     /**
-     * @brief Learn Memory to start thinking.
+     * @brief Save learned model (if repository allows it) - Ns deleted since learning are skipped.
      */
-    bool learnMemorySync(std::thread* t = nullptr);
+    bool saveModelSync(const std::vector<Note*>& live, const std::vector<std::string>& keys);
+
+    /**
+     * @brief Has learned model changed since it was loaded/saved (deleted Ns included)?
+     */
+    bool isModelDirty() const;
+
+    /**
+     * @brief Wait for model save queued by sleep() - learned data must not be touched until then.
+     */
+    void waitForModelSave();
+
+    /**
+     * @brief Drop learned data (AA store is kept).
+     */
+    void clearSync();
+
+    /**
+     * @brief Get path of persisted model or empty string if active repository cannot keep it.
+     */
+    static std::string getModelPath();
+
+    /**
+     * @brief Get unique keys of Ns which are stable across restarts (relative to memory path).
+     */
+    void getNoteKeys(const std::vector<Note*>& notes, std::vector<std::string>& keys) const;
+
+    /**
+     * @brief Capture Ns in memory if Ns were deleted since the last capture (caller's thread).
+     */
+    void captureLiveNotes();
+
+    /**
+     * @brief Process Mind changes since the last synchronization - deleted Ns are forgotten
+     * and cached leaderboards they touch are evicted.
+     */
+    void synchronizeSync();
+
+    /**
+     * @brief Forget deleted N - N's associations are invalidated and N index is kept w/ nullptr.
+     *
+     * @param dirtyLeaderboards  Ns whose cached leaderboards are touched by N (to be evicted).
+     */
+    void forgetNoteSync(size_t i, std::unordered_set<const Note*>& dirtyLeaderboards);
+
+    /**
+     * @brief Get Ns whose cached leaderboards are touched by N change - N's leaderboard and
+     * leaderboards which contain N (caller holds leaderboard cache lock).
+     */
+    void getTouchedLeaderboards(const Note* note, std::unordered_set<const Note*>& dirtyLeaderboards) const;
+
+    /**
+     * @brief Cache N's leaderboard (caller holds leaderboard cache lock).
+     */
+    void cacheLeaderboard(const Note* note, u_int32_t revision, const std::vector<std::pair<Note*,float>>& leaderboard);
+
+    /**
+     * @brief Evict N's cached leaderboard (caller holds leaderboard cache lock).
+     */
+    void evictLeaderboard(const Note* note);
+
+    /**
+     * @brief Drop all cached leaderboards.
+     */
+    void clearLeaderboards();
+
+    /**
+     * @brief Learn new, changed (by revision) and moved Ns of O snapshot incrementally.
+     */
+    bool learnOutlineSync(const OutlineSnapshot& snapshot);
+
+    /**
+     * @brief Replace N's doc vector and features and invalidate N's associations.
+     *
+     * Complexity:
+     * - doc vector and lexicon: O(N size) - frequencies are adjusted by the difference,
+     *   new max frequency is found in lexicon histogram, word weights are recalculated
+     *   for N's words only (unless max frequency changes ~ O(lexicon))
+     * - AA store: O(in-degree * k) - rows which contain N are found by reverse index
+     * - leaderboard cache: O(cached leaderboards) AA assessments - cached leaderboards
+     *   which N can newly enter are dropped (cache has leaderboards of visited Ns only)
+     *
+     * @param note  live N - key of learned data.
+     * @param copy  snapshot of N - the only N data read.
+     */
+    void learnNoteSync(Note* note, const Note* copy);
 
     /**
      * @brief Calculate leaderboard and indicate that it has been stored to cache.
+     *
+     * @param revision  N revision captured by the caller's thread.
      */
-    bool calculateLeaderboardSync(const Note* n, std::thread* t = nullptr);
+    bool calculateLeaderboardSync(const Note* n, u_int32_t revision);
 
     /**
      * @brief Initialize blacklist using common words.
@@ -161,11 +369,11 @@ private:
     void initializeWordBlacklist();
 
     /**
-     * @brief Precalculate entire AA.
+     * @brief Calculate AA of N1/N2 tuple.
      *
-     * LONG running method.
+     * Method is reentrant - it reads learned data only, therefore it can be called by AA workers.
      */
-    void precalculateAa();
+    float calculateAa(const NoteFeatures& n1, const NoteFeatures& n2, AssociationAssessmentNotesFeature& aaFeature);
 
     /**
      * @brief Calculate AA row/column cross i.e. associations of N with *all* other Ns.
@@ -175,50 +383,50 @@ private:
     void calculateAaRow(size_t y);
 
     /**
-     * @brief Calculate similarity of two word vectors.
+     * @brief Calculate similarity of two word vectors using their relevant words.
      */
-    float calculateSimilarityByWords(WordFrequencyList& v1, WordFrequencyList& v2, int threshold=1000);
+    float calculateSimilarityByWords(const WordFrequencyList& v1, const WordFrequencyList& v2);
 
     /**
-     * @brief Calculate similarity of two tag lists.
+     * @brief Calculate similarity of two tag ID sets.
      */
-    float calculateSimilarityByTags(const std::vector<const Tag*>* t1, const std::vector<const Tag*>* t2);
+    static float calculateSimilarityByTags(const std::vector<int>& t1, const std::vector<int>& t2);
 
     /**
-     * @brief Calculate similarity of two N/O names.
+     * @brief Calculate similarity of two N/O names represented by title word ID sets.
      */
-    float calculateSimilarityByTitles(const std::string& t1, const std::string& t2);
+    static float calculateSimilarityByTitles(const std::vector<int>& t1, const std::vector<int>& t2);
 
     /**
-     * @brief Check AA matrix symmetry.
+     * @brief Calculate features of all Ns.
      */
-    void assertAaSymmetry();
+    void calculateFeatures();
+    void calculateNoteFeatures(size_t i, const Note* n);
 
     /**
-     * @brief Get AA leaderboard from cache.
+     * @brief Get N index in notes vector or -1 if N is not learned.
      */
-    bool getCachedLeaderboard(const Note* n, std::vector<std::pair<Note*,float>>& leaderboard);
+    int getNoteIndex(const Note* note) const;
+
+    /**
+     * @brief Get N terms used by LSH.
+     */
+    void getCandidateTerms(size_t i, std::vector<MinHashLsh::WeightedTerm>& terms) const;
 
     /**
-     * @brief Remove finished workers and add new one.
+     * @brief Index Ns features to LSH to get AA candidates (big repositories only).
      */
-    void addWorkerAndCleanZombies(std::thread* t);
+    void calculateCandidates();
+
+    /**
+     * @brief Get AA leaderboard from cache.
+     */
+    bool getCachedLeaderboard(const Note* n, std::vector<std::pair<Note*,float>>& leaderboard);
 
 public:
 #ifdef DO_MF_DEBUG
     void printAa() {
-        std::cout << "AA Matrix:" << std::endl;
-        for(size_t i=0; i<aaMatrix.size(); i++) {
-            std::cout << "AA[" << i << "] = ";
-            for(size_t j=0; j<aaMatrix.size(); j++) {
-                if(aaMatrix[i][j] == -1) {
-                    std::cout << "_ ";
-                } else {
-                    std::cout << aaMatrix[i][j] << " ";
-                }
-            }
-            std::cout << std::endl;
-        }
+        aaStore.print();
     }
 #endif
 };
@@ -0,0 +1,402 @@
+/*
+ ai_aa_tf_idf.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "ai_aa_tf_idf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace m8r {
+
+using namespace std;
+
+AiAaTfIdf::AiAaTfIdf(Memory& memory, Mind& mind)
+    : mind(mind),
+      memory(memory),
+      lexicon{},
+      wordBlacklist{},
+      tokenizer{lexicon,wordBlacklist},
+      queryLexicon{},
+      queryTokenizer{queryLexicon,wordBlacklist},
+      patchedRows{0}
+{
+    lastMindDeleteWatermark = mind.getDeleteWatermark();
+    lastMindGeneration = mind.getGeneration();
+}
+
+AiAaTfIdf::~AiAaTfIdf()
+{
+}
+
+shared_future<bool> AiAaTfIdf::dream()
+{
+    MF_DEBUG("AA.TF-IDF: LEARNING memory..." << endl);
+
+    bool status = learnMemorySync();
+    mind.persistMindState(Configuration::MindState::THINKING);
+
+    return toFuture(status);
+}
+
+bool AiAaTfIdf::learnMemorySync()
+{
+#ifdef DO_MF_DEBUG
+    auto begin = chrono::high_resolution_clock::now();
+#endif
+
+    lastMindDeleteWatermark = mind.getDeleteWatermark();
+    lastMindGeneration = mind.getGeneration();
+    patchedRows = 0;
+    notes.clear();
+    // O descriptors are learned too - O is queried using its descriptor
+    memory.getAllNotes(notes, false, true);
+    revisions.resize(notes.size());
+
+    // tokenize Ns (term frequencies) and count document frequencies
+    lexicon.clear();
+    vector<WordFrequencyList*> docs{};
+    docs.reserve(notes.size());
+    for(size_t i=0; i<notes.size(); i++) {
+        notes[i]->setAiAaMatrixIndex(static_cast<int>(i));
+        revisions[i] = notes[i]->getRevision();
+        WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
+        tokenizer.tokenize(notes[i], *wfl);
+        docs.push_back(wfl);
+    }
+    vector<int> dfs(lexicon.size(), 0);
+    size_t nnz = 0;
+    for(WordFrequencyList* wfl:docs) {
+        for(auto& w:wfl->iterable()) {
+            dfs[w.id]++;
+        }
+        nnz += wfl->size();
+    }
+
+    // smoothed IDF: words occuring in every N still have (small) weight
+    idfs.resize(lexicon.size());
+    for(size_t id=0; id<idfs.size(); id++) {
+        idfs[id] = log((1.f+notes.size())/(1.f+dfs[id])) + 1.f;
+    }
+
+    // CSR: sublinear TF x IDF, rows L2 normalized ~ dot product is cosine similarity
+    rowOffsets.clear();
+    rowOffsets.reserve(notes.size()+1);
+    columns.clear();
+    columns.reserve(nnz);
+    values.clear();
+    values.reserve(nnz);
+    rowOffsets.push_back(0);
+    for(WordFrequencyList* wfl:docs) {
+        appendRow(*wfl);
+        delete wfl;
+    }
+
+    query.assign(lexicon.size(), 0.f);
+
+#ifdef DO_MF_DEBUG
+    auto end = chrono::high_resolution_clock::now();
+    MF_DEBUG("AA.TF-IDF: " << notes.size() << " Ns, " << lexicon.size() << " words, " << values.size() << " non-zeros ("
+             << getFootprint() << "B) learned in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
+#endif
+
+    return true;
+}
+
+void AiAaTfIdf::appendRow(const WordFrequencyList& wfl)
+{
+    size_t rowBegin = values.size();
+    float norm = 0.f;
+    for(auto& w:wfl.iterable()) {
+        float v = (1.f+log(static_cast<float>(w.frequency))) * idfs[w.id];
+        columns.push_back(w.id);
+        values.push_back(v);
+        norm += v*v;
+    }
+    if(norm > 0.f) {
+        norm = sqrt(norm);
+        for(size_t j=rowBegin; j<values.size(); j++) {
+            values[j] /= norm;
+        }
+    }
+    rowOffsets.push_back(static_cast<uint32_t>(values.size()));
+}
+
+void AiAaTfIdf::refreshNotes()
+{
+    if(lastMindDeleteWatermark != mind.getDeleteWatermark()) {
+        MF_DEBUG("AA.TF-IDF: Ns deleted > learning memory again" << endl);
+        learnMemorySync();
+        return;
+    }
+    if(lastMindGeneration == mind.getGeneration()) {
+        return;
+    }
+    lastMindGeneration = mind.getGeneration();
+
+    vector<Note*> current{};
+    memory.getAllNotes(current, false, true);
+    vector<Note*> changed{};
+    for(Note* n:current) {
+        int row = getRow(n);
+        if(row < 0 || revisions[row] != n->getRevision()) {
+            changed.push_back(n);
+        }
+    }
+    if(changed.empty()) {
+        return;
+    }
+
+    // IDFs of patched rows drift from IDFs of memory > learn again when too many
+    if((patchedRows+changed.size())*PATCH_RATIO > current.size()) {
+        MF_DEBUG("AA.TF-IDF: " << changed.size() << " Ns changed > learning memory again" << endl);
+        learnMemorySync();
+    } else {
+        patchRows(changed);
+    }
+}
+
+void AiAaTfIdf::patchRows(const vector<Note*>& changed)
+{
+#ifdef DO_MF_DEBUG
+    auto begin = chrono::high_resolution_clock::now();
+#endif
+
+    // row -> tokenized N (created Ns get new rows)
+    vector<WordFrequencyList*> docs(notes.size(), nullptr);
+    const size_t learnedWords = lexicon.size();
+    for(Note* n:changed) {
+        int row = getRow(n);
+        if(row < 0) {
+            row = static_cast<int>(notes.size());
+            notes.push_back(n);
+            revisions.push_back(0);
+            docs.push_back(nullptr);
+            n->setAiAaMatrixIndex(row);
+        }
+        revisions[row] = n->getRevision();
+        docs[row] = new WordFrequencyList{&lexicon};
+        tokenizer.tokenize(n, *docs[row]);
+    }
+
+    // IDFs of learned words are kept, new words get IDF of their frequency in patched rows
+    vector<int> dfs(lexicon.size()-learnedWords, 0);
+    for(WordFrequencyList* wfl:docs) {
+        if(wfl) {
+            for(auto& w:wfl->iterable()) {
+                if(static_cast<size_t>(w.id) >= learnedWords) {
+                    dfs[w.id-learnedWords]++;
+                }
+            }
+        }
+    }
+    idfs.resize(lexicon.size());
+    for(size_t id=learnedWords; id<idfs.size(); id++) {
+        idfs[id] = log((1.f+notes.size())/(1.f+dfs[id-learnedWords])) + 1.f;
+    }
+
+    // CSR is copied w/ patched rows replaced
+    vector<uint32_t> learnedRowOffsets{};
+    vector<int32_t> learnedColumns{};
+    vector<float> learnedValues{};
+    learnedRowOffsets.swap(rowOffsets);
+    learnedColumns.swap(columns);
+    learnedValues.swap(values);
+    rowOffsets.reserve(notes.size()+1);
+    columns.reserve(learnedColumns.size());
+    values.reserve(learnedValues.size());
+    rowOffsets.push_back(0);
+    for(size_t r=0; r<notes.size(); r++) {
+        if(docs[r]) {
+            appendRow(*docs[r]);
+            delete docs[r];
+        } else {
+            columns.insert(columns.end(), learnedColumns.begin()+learnedRowOffsets[r], learnedColumns.begin()+learnedRowOffsets[r+1]);
+            values.insert(values.end(), learnedValues.begin()+learnedRowOffsets[r], learnedValues.begin()+learnedRowOffsets[r+1]);
+            rowOffsets.push_back(static_cast<uint32_t>(values.size()));
+        }
+    }
+    patchedRows += changed.size();
+
+    query.assign(lexicon.size(), 0.f);
+
+#ifdef DO_MF_DEBUG
+    auto end = chrono::high_resolution_clock::now();
+    MF_DEBUG("AA.TF-IDF: " << changed.size() << " rows patched in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
+#endif
+}
+
+bool AiAaTfIdf::sleep()
+{
+    notes.clear();
+    revisions.clear();
+    patchedRows = 0;
+    lexicon.clear();
+    queryLexicon.clear();
+    idfs.clear();
+    rowOffsets.clear();
+    columns.clear();
+    values.clear();
+    query.clear();
+    return true;
+}
+
+int AiAaTfIdf::getRow(const Note* note) const
+{
+    int row = note->getAiAaMatrixIndex();
+    if(row >= 0 && static_cast<size_t>(row) < notes.size() && notes[row] == note) {
+        return row;
+    }
+    return -1;
+}
+
+void AiAaTfIdf::setQueryFromRow(int row)
+{
+    for(uint32_t j=rowOffsets[row]; j<rowOffsets[row+1]; j++) {
+        query[columns[j]] = values[j];
+    }
+}
+
+bool AiAaTfIdf::setQueryFromWords(const WordFrequencyList& wfl)
+{
+    vector<pair<int,float>> known{};
+    float norm = 0.f;
+    for(auto& w:wfl.iterable()) {
+        // words unknown to learned memory cannot match any N
+        Lexicon::WordEmbedding* e = lexicon.get(queryLexicon.get(w.id)->word);
+        if(e) {
+            float v = (1.f+log(static_cast<float>(w.frequency))) * idfs[e->id];
+            known.push_back(make_pair(e->id, v));
+            norm += v*v;
+        }
+    }
+    if(norm == 0.f) {
+        return false;
+    }
+
+    norm = sqrt(norm);
+    for(auto& k:known) {
+        query[k.first] = k.second/norm;
+    }
+    return true;
+}
+
+float AiAaTfIdf::dot(int row) const
+{
+    const int32_t* c = columns.data();
+    const float* v = values.data();
+    const float* q = query.data();
+    uint32_t j = rowOffsets[row];
+    const uint32_t end = rowOffsets[row+1];
+
+    // independent accumulators break the add dependency chain (gathers don't vectorize well)
+    float s0=0.f, s1=0.f, s2=0.f, s3=0.f;
+    for(; j+4<=end; j+=4) {
+        s0 += v[j]   * q[c[j]];
+        s1 += v[j+1] * q[c[j+1]];
+        s2 += v[j+2] * q[c[j+2]];
+        s3 += v[j+3] * q[c[j+3]];
+    }
+    for(; j<end; j++) {
+        s0 += v[j] * q[c[j]];
+    }
+    return (s0+s1)+(s2+s3);
+}
+
+void AiAaTfIdf::assessNotes(vector<pair<Note*,float>>& associations, const Note* self)
+{
+    typedef pair<float,int> Score;
+
+    // min-heap of the best k rows: the worst of the best on top
+    auto worse = [](const Score& s1, const Score& s2) {
+        return s1.first!=s2.first?s1.first>s2.first:s1.second<s2.second;
+    };
+    priority_queue<Score,vector<Score>,decltype(worse)> best{worse};
+
+    for(size_t r=0; r<notes.size(); r++) {
+        if(notes[r] == self || mind.getScopeAspect().isOutOfScope(notes[r])) {
+            continue;
+        }
+        float s = dot(static_cast<int>(r));
+        if(s > 0.f) {
+            if(best.size() < AA_LEADERBOARD_SIZE) {
+                best.push(make_pair(s, static_cast<int>(r)));
+            } else if(worse(make_pair(s, static_cast<int>(r)), best.top())) {
+                best.pop();
+                best.push(make_pair(s, static_cast<int>(r)));
+            }
+        }
+    }
+
+    // clear query for the next use
+    std::fill(query.begin(), query.end(), 0.f);
+
+    size_t offset = associations.size();
+    associations.resize(offset+best.size());
+    for(size_t i=associations.size(); i>offset; i--) {
+        associations[i-1] = make_pair(notes[best.top().second], best.top().first);
+        best.pop();
+    }
+}
+
+shared_future<bool> AiAaTfIdf::getAssociatedNotes(const Note* note, vector<pair<Note*,float>>& associations)
+{
+    refreshNotes();
+    if(notes.empty()) {
+        return toFuture(false);
+    }
+
+    int row = getRow(note);
+    if(row >= 0) {
+        setQueryFromRow(row);
+    } else {
+        // N which is not in memory (yet)
+        queryLexicon.clear();
+        WordFrequencyList wfl{&queryLexicon};
+        queryTokenizer.tokenize(note, wfl);
+        if(!setQueryFromWords(wfl)) {
+            return toFuture(true);
+        }
+    }
+
+    assessNotes(associations, note);
+    return toFuture(true);
+}
+
+shared_future<bool> AiAaTfIdf::getAssociatedNotes(Outline* outline, vector<pair<Note*,float>>& associations)
+{
+    return getAssociatedNotes(outline->getOutlineDescriptorAsNote(), associations);
+}
+
+shared_future<bool> AiAaTfIdf::getAssociatedNotes(const string& words, vector<pair<Note*,float>>& associations, const Note* self)
+{
+    refreshNotes();
+    if(notes.empty()) {
+        return toFuture(false);
+    }
+
+    queryLexicon.clear();
+    WordFrequencyList wfl{&queryLexicon};
+    queryTokenizer.tokenize(words, wfl);
+    if(setQueryFromWords(wfl)) {
+        assessNotes(associations, self);
+    }
+    return toFuture(true);
+}
+
+} // m8r namespace
@@ -0,0 +1,178 @@
+/*
+ ai_aa_tf_idf.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_AI_ASSOCIATIONS_ASSESSMENT_TF_IDF_H
+#define M8R_AI_ASSOCIATIONS_ASSESSMENT_TF_IDF_H
+
+#include <cstdint>
+#include <future>
+#include <vector>
+
+#include "ai_aa.h"
+#include "../mind.h"
+#include "./nlp/common_words_blacklist.h"
+#include "./nlp/markdown_tokenizer.h"
+
+namespace m8r {
+
+class Mind;
+class Memory;
+
+/**
+ * @brief TF-IDF cosine similarity based associations assessment.
+ *
+ * Description:
+ * - every N (including O descriptors) is represented by L2 normalized TF-IDF vector,
+ *   vectors are kept in a contiguous CSR (compressed sparse row) matrix
+ * - query (N, O or words) is scattered to a dense vector and cosine similarity
+ *   with all Ns is a sparse-dense dot product per row, the best Ns are picked using
+ *   top-k heap
+ * - queries are fast enough to be answered SYNCHRONOUSLY (like weighted FTS), learning
+ *   is tokenization of memory (like BoW)
+ * - when Mind generation changes, rows of Ns created or modified (revision) since learning
+ *   are patched: they are tokenized again using IDFs of learning (new words get IDF
+ *   of the patched rows) and CSR is copied w/ these rows replaced/appended - memory is
+ *   learned again (IDFs) if O/N was deleted or too many rows were patched
+ */
+class AiAaTfIdf : public AiAssociationsAssessment
+{
+public:
+    // memory is learned again if more than 1/PATCH_RATIO rows were patched since learning
+    static constexpr size_t PATCH_RATIO = 10;
+
+private:
+    Mind& mind;
+    Memory& memory;
+
+    Lexicon lexicon;
+    CommonWordsBlacklist wordBlacklist;
+    MarkdownTokenizer tokenizer;
+    // queries are tokenized to scratch lexicon - learned lexicon must NOT grow
+    Lexicon queryLexicon;
+    MarkdownTokenizer queryTokenizer;
+
+    // Ns - vector index is CSR matrix row
+    std::vector<Note*> notes;
+    // N row -> N revision when it was tokenized
+    std::vector<u_int32_t> revisions;
+
+    // word ID -> inverse document frequency
+    std::vector<float> idfs;
+
+    // CSR matrix: N row r has entries [rowOffsets[r],rowOffsets[r+1]) of columns (word IDs
+    // sorted ascending) and values (L2 normalized TF-IDF)
+    std::vector<uint32_t> rowOffsets;
+    std::vector<int32_t> columns;
+    std::vector<float> values;
+
+    // dense query vector (indexed by word ID) - reused by queries to avoid allocations
+    std::vector<float> query;
+
+    // Ns are learned again if O/N was deleted (learned N pointers would dangle)
+    int lastMindDeleteWatermark;
+    // rows are patched if O/N was created or modified
+    u_int32_t lastMindGeneration;
+    size_t patchedRows;
+
+public:
+    explicit AiAaTfIdf(Memory& memory, Mind& mind);
+    AiAaTfIdf(const AiAaTfIdf&) = delete;
+    AiAaTfIdf(const AiAaTfIdf&&) = delete;
+    AiAaTfIdf &operator=(const AiAaTfIdf&) = delete;
+    AiAaTfIdf &operator=(const AiAaTfIdf&&) = delete;
+    virtual ~AiAaTfIdf();
+
+    virtual std::shared_future<bool> dream();
+
+    virtual std::shared_future<bool> getAssociatedNotes(const Note* note, std::vector<std::pair<Note*,float>>& associations);
+    virtual std::shared_future<bool> getAssociatedNotes(Outline* outline, std::vector<std::pair<Note*,float>>& associations);
+    virtual std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, const Note* self);
+
+    virtual bool sleep();
+
+    virtual bool amnesia() {
+        return sleep();
+    }
+
+    size_t getNotesCount() const { return notes.size(); }
+    size_t getPatchedRowsCount() const { return patchedRows; }
+    size_t getFootprint() const {
+        return rowOffsets.size()*sizeof(uint32_t)
+               + columns.size()*sizeof(int32_t)
+               + values.size()*sizeof(float)
+               + idfs.size()*sizeof(float);
+    }
+
+private:
+    /**
+     * @brief Tokenize memory, calculate IDFs and build CSR matrix.
+     */
+    bool learnMemorySync();
+
+    /**
+     * @brief Append L2 normalized TF-IDF row of tokenized N to CSR matrix.
+     */
+    void appendRow(const WordFrequencyList& wfl);
+
+    /**
+     * @brief Learn memory again if Ns were deleted, patch rows of created/modified Ns.
+     */
+    void refreshNotes();
+
+    /**
+     * @brief Tokenize created/modified Ns and replace/append their rows.
+     */
+    void patchRows(const std::vector<Note*>& changed);
+
+    /**
+     * @brief Get CSR row of learned N or -1.
+     */
+    int getRow(const Note* note) const;
+
+    /**
+     * @brief Scatter learned N's row to dense query vector.
+     */
+    void setQueryFromRow(int row);
+
+    /**
+     * @brief Scatter L2 normalized TF-IDF of known words to dense query vector.
+     *
+     * @param wfl   query words tokenized to query lexicon.
+     * @return false if no learned word was found.
+     */
+    bool setQueryFromWords(const WordFrequencyList& wfl);
+
+    /**
+     * @brief Find the most similar Ns to dense query vector and clear it.
+     */
+    void assessNotes(std::vector<std::pair<Note*,float>>& associations, const Note* self);
+
+    /**
+     * @brief Sparse-dense dot product of CSR row and dense query vector.
+     */
+    float dot(int row) const;
+
+    static std::shared_future<bool> toFuture(bool status) {
+        std::promise<bool> p{};
+        p.set_value(status);
+        return std::shared_future<bool>(p.get_future());
+    }
+};
+
+}
+#endif // M8R_AI_ASSOCIATIONS_ASSESSMENT_TF_IDF_H
@@ -18,6 +18,8 @@
 */
 #include "ai_aa_weighted_fts.h"
 
+#include <unordered_set>
+
 namespace m8r {
 
 using namespace std;
@@ -27,27 +29,42 @@ AiAaWeightedFts::AiAaWeightedFts(Memory& memory, Mind& mind)
       memory(memory),
       commonWords{}
 {
-    lastMindDeleteWatermark = mind.getDeleteWatermark();
+    lastMindGeneration = mind.getGeneration();
 }
 
 AiAaWeightedFts::~AiAaWeightedFts()
 {
 }
 
-void AiAaWeightedFts::refreshNotes(bool checkWatermark)
+void AiAaWeightedFts::refreshNotes(bool checkGeneration)
 {
 #ifdef DO_MF_DEBUG
-    MF_DEBUG("AA.FTS Ns refresh - check watermark " << boolalpha << checkWatermark << endl);
+    MF_DEBUG("AA.FTS Ns refresh - check generation " << boolalpha << checkGeneration << endl);
     auto begin = chrono::high_resolution_clock::now();
 #endif
 
-    if(checkWatermark && lastMindDeleteWatermark==mind.getDeleteWatermark()) {
+    if(checkGeneration && lastMindGeneration==mind.getGeneration()) {
         return;
     }
-    lastMindDeleteWatermark = mind.getDeleteWatermark();
+    lastMindGeneration = mind.getGeneration();
     notes.clear();
     memory.getAllNotes(notes);
 
+    // prune shadows of deleted O/Ns (their addresses might be reused by new O/Ns)
+    if(shadows.size()) {
+        unordered_set<const Thing*> alive{notes.begin(), notes.end()};
+        for(Outline* o:memory.getOutlines()) {
+            alive.insert(o);
+        }
+        for(auto i=shadows.begin(); i!=shadows.end(); ) {
+            if(alive.find(i->first) == alive.end()) {
+                i = shadows.erase(i);
+            } else {
+                ++i;
+            }
+        }
+    }
+
 #ifdef DO_MF_DEBUG
     auto end = chrono::high_resolution_clock::now();
     MF_DEBUG("AA.FTS Ns refreshed in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
@@ -131,14 +148,7 @@ vector<pair<Note*,float>>* AiAaWeightedFts::assessNotesWithFallback(const string
     if(r.size()) words.push_back(r);
 
     // exact match
-    if(scope) {
-        assessNotesInOutline(scope, result, words, ignoreCase);
-    } else {
-        const vector<m8r::Outline*> outlines = memory.getOutlines();
-        for(Outline* outline:outlines) {
-            assessNotesInOutline(outline, result, words, ignoreCase);
-        }
-    }
+    assessNotes(scope, result, words);
     // remove self in case that result can become empty
     if(self && result->size() == 1 && result->begin()->first == self) {
         result->clear();
@@ -155,16 +165,11 @@ vector<pair<Note*,float>>* AiAaWeightedFts::assessNotesWithFallback(const string
         MF_DEBUG("AA.FTS.fallback words: " << words.size() << endl);
         if(words.size()) {
             // IMPROVE: iterate 3 *most valuable* words (now the first 3 words are considered, value is ignored)
-            words.resize(FTS_SEARCH_THRESHOLD_MULTIWORD);
-            // search using words
-            if(scope) {
-                assessNotesInOutline(scope, result, words, ignoreCase);
-            } else {
-                const vector<m8r::Outline*> outlines = memory.getOutlines();
-                for(Outline* outline:outlines) {
-                    assessNotesInOutline(outline, result, words, ignoreCase);
-                }
+            if(words.size() > FTS_SEARCH_THRESHOLD_MULTIWORD) {
+                words.resize(FTS_SEARCH_THRESHOLD_MULTIWORD);
             }
+            // search using words
+            assessNotes(scope, result, words);
         }
     }
 
@@ -176,86 +181,123 @@ vector<pair<Note*,float>>* AiAaWeightedFts::assessNotesWithFallback(const string
     return result;
 }
 
-void AiAaWeightedFts::assessNotesInOutline(Outline* outline, vector<pair<Note*,float>>* result, vector<string>& regexps, const bool ignoreCase)
+const AiAaWeightedFts::TextShadow& AiAaWeightedFts::getShadow(
+        const Thing* thing,
+        u_int32_t revision,
+        const string& name,
+        const vector<string*>& description)
 {
-    // IMPROVE make this faster - do NOT convert to lower case, but compare it in that method > will do less
-    if(ignoreCase) {
-        // case INSENSITIVE
-
-        // O matches
-        float oScore = 0.f;
-        string s{};
-        // O.title matches
-        stringToLower(outline->getName(), s);
-        for(auto& regexp:regexps) {
-            if(s.find(regexp)!=string::npos) {
-                oScore += 100.f;
-            }
-        }
-        // O.description matches
-        float matches = 0.f;
-        for(string* d:outline->getDescription()) {
-            if(d) {
-                s.clear();
-                stringToLower(*d, s);
-                for(auto& regexp:regexps) {
-                    // find all matches (regexp matched more than once)
-                    size_t m = s.find(regexp, 0);
-                    while(m != string::npos) {
-                        matches++;
-                        m = s.find(regexp,m+1);
-                    }
-                }
-            }
+    auto i = shadows.find(thing);
+    if(i != shadows.end() && i->second.revision == revision) {
+        return i->second;
+    }
+
+    TextShadow& shadow = shadows[thing];
+    shadow.revision = revision;
+    shadow.name.clear();
+    stringToLower(name, shadow.name);
+    shadow.description.clear();
+    for(string* d:description) {
+        if(d) {
+            // lines are kept separated so that matches do NOT span lines
+            stringToLower(*d, shadow.description);
+            shadow.description += '\n';
         }
-        if(matches != 0.f) {
-            oScore += 10.f*matches;
-            result->push_back(std::make_pair(outline->getOutlineDescriptorAsNote(),oScore));
+    }
+    return shadow;
+}
+
+const AiAaWeightedFts::TextShadow& AiAaWeightedFts::getShadow(const Outline* outline)
+{
+    return getShadow(outline, outline->getRevision(), outline->getName(), outline->getDescription());
+}
+
+const AiAaWeightedFts::TextShadow& AiAaWeightedFts::getShadow(const Note* note)
+{
+    return getShadow(note, note->getRevision(), note->getName(), note->getDescription());
+}
+
+void AiAaWeightedFts::assessNotes(Outline* scope, vector<pair<Note*,float>>* result, const vector<string>& regexps)
+{
+    // compile regexps to automaton to find all of them in a single pass
+    AhoCorasick automaton{};
+    for(const string& regexp:regexps) {
+        automaton.addPattern(regexp);
+    }
+    if(automaton.empty()) {
+        return;
+    }
+    automaton.build();
+
+    vector<int> counts(automaton.size());
+    if(scope) {
+        assessNotesInOutline(scope, result, automaton, counts);
+    } else {
+        const vector<m8r::Outline*> outlines = memory.getOutlines();
+        for(Outline* outline:outlines) {
+            assessNotesInOutline(outline, result, automaton, counts);
         }
+    }
+}
 
-        // O's score will contribute to N's score as a bonus > normalize it
-        //MF_DEBUG(" AA.FTS O>N '" << outline->getName() << "' ~ " << oScore << endl);
-        oScore /= 10.f;
+void AiAaWeightedFts::assessNotesInOutline(Outline* outline, vector<pair<Note*,float>>* result, const AhoCorasick& regexps, vector<int>& counts)
+{
+    // case is always ignored - lowercase shadows are matched by lowercase regexps
+    // (case sensitive version is NOT needed - was removed - see FTS search)
+
+    // O matches
+    float oScore = 0.f;
+    const TextShadow& o = getShadow(outline);
+    // O.title matches
+    std::fill(counts.begin(), counts.end(), 0);
+    regexps.count(o.name, counts);
+    for(int c:counts) {
+        if(c) {
+            oScore += 100.f;
+        }
+    }
+    // O.description matches (regexp matched more than once counts)
+    float matches = 0.f;
+    regexps.match(o.description, [&matches](int, size_t) {
+        matches++;
+    });
+    if(matches != 0.f) {
+        oScore += 10.f*matches;
+        result->push_back(std::make_pair(outline->getOutlineDescriptorAsNote(),oScore));
+    }
 
-        // O's N matches
-        float nScore = 0.f;
-        for(Note* note:outline->getNotes()) {
-            nScore = oScore;
-            // time scope @ AI
-            if(mind.getScopeAspect().isOutOfScope(note)) {
-                continue;
-            }
-            // N.title matches
-            s.clear();
-            stringToLower(note->getName(), s);
-            for(auto& regexp:regexps) {
-                if(s.find(regexp)!=string::npos) {
-                    nScore += 100.f;
-                }
-            }
-            // N.description matches
-            float matches=0.;
-            for(string* d:note->getDescription()) {
-                if(d) {
-                    s.clear();
-                    stringToLower(*d, s);
-                    for(auto& regexp:regexps) {
-                        // find them all
-                        size_t m = s.find(regexp, 0);
-                        while(m != string::npos) {
-                            matches++;
-                            m = s.find(regexp,m+1);
-                        }
-                    }
-                }
-            }
-            if(nScore!=0.f || matches!=0.f) {
-                nScore += 10.f*matches;
-                result->push_back(std::make_pair(note,nScore));
-                //MF_DEBUG(" AA.FTS > N '" << note->getName() << "' ~ " << nScore << endl);
+    // O's score will contribute to N's score as a bonus > normalize it
+    //MF_DEBUG(" AA.FTS O>N '" << outline->getName() << "' ~ " << oScore << endl);
+    oScore /= 10.f;
+
+    // O's N matches
+    float nScore = 0.f;
+    for(Note* note:outline->getNotes()) {
+        nScore = oScore;
+        // time scope @ AI
+        if(mind.getScopeAspect().isOutOfScope(note)) {
+            continue;
+        }
+        const TextShadow& n = getShadow(note);
+        // N.title matches
+        std::fill(counts.begin(), counts.end(), 0);
+        regexps.count(n.name, counts);
+        for(int c:counts) {
+            if(c) {
+                nScore += 100.f;
             }
         }
-    } // IMPROVE case sensitive version is NOT needed - was removed - see FTS search
+        // N.description matches - find them all
+        float matches=0.;
+        regexps.match(n.description, [&matches](int, size_t) {
+            matches++;
+        });
+        if(nScore!=0.f || matches!=0.f) {
+            nScore += 10.f*matches;
+            result->push_back(std::make_pair(note,nScore));
+            //MF_DEBUG(" AA.FTS > N '" << note->getName() << "' ~ " << nScore << endl);
+        }
+    }
 }
 
 std::shared_future<bool> AiAaWeightedFts::getAssociatedNotes(
@@ -22,10 +22,12 @@
 #include <future>
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 #include "ai_aa.h"
 #include "../mind.h"
 #include "../../gear/hash_map.h"
+#include "../../gear/aho_corasick.h"
 #include "./nlp/common_words_blacklist.h"
 #include "./nlp/markdown_tokenizer.h"
 
@@ -40,6 +42,9 @@ class Memory;
  * Description:
  * - This method has own FTS implementation to compute weights and leverage O/N relationships
  *   while searching the best result.
+ * - Query words are compiled to Aho-Corasick automaton, therefore every O/N text is scanned
+ *   once regardless of the number of words. Text is scanned in lowercase shadow of O/N which
+ *   is rebuilt only when O/N revision changes.
  * - IMPROVE this class is designed to run SYNCHRONOUSLY - for ASYNC modus operandi Mind/AI/this class
  *   cooperation and synchronization protocols must be architected.
  */
@@ -53,10 +58,23 @@ private:
     Memory& memory;
     CommonWordsBlacklist commonWords;
 
+    /**
+     * @brief Lowercase copy of O/N name and description (lines joined by \\n).
+     */
+    struct TextShadow {
+        u_int32_t revision;
+        std::string name;
+        std::string description;
+    };
+
     std::vector<Note*> notes;
 
-    // IMPROVE in addition to watermark also scope change should be tracked ~ mind.scopeWatermark
-    int lastMindDeleteWatermark;
+    // O/N -> lowercase shadow (shadows of deleted O/Ns are pruned on Ns refresh)
+    std::unordered_map<const Thing*,TextShadow> shadows;
+
+    // Ns are refreshed when Mind generation changes (O/N created, moved or deleted)
+    // IMPROVE in addition to generation also scope change should be tracked ~ mind.scopeWatermark
+    u_int32_t lastMindGeneration;
 
 public:
     explicit AiAaWeightedFts(Memory& memory, Mind& mind);
@@ -84,6 +102,7 @@ public:
 
     virtual bool sleep() {
         notes.clear();
+        shadows.clear();
         return true;
     }
 
@@ -92,7 +111,7 @@ public:
     }
 
 private:
-    void refreshNotes(bool checkWatermark);
+    void refreshNotes(bool checkGeneration);
     void tokenizeAndStripString(std::string s, const bool ignoreCase, std::vector<std::string>& words);
 
     std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, Outline* self);
@@ -101,7 +120,16 @@ private:
     //   -> assessNsWithFallback(){2lowercase,iterateOs,fallback}
     //     -> assessNs@O()
     std::vector<std::pair<Note*,float>>* assessNotesWithFallback(const std::string& regexp, Outline* scope, const Note* self);
-    void assessNotesInOutline(Outline* outline, std::vector<std::pair<Note*,float>>* result, std::vector<std::string>& regexp, const bool ignoreCase);
+    void assessNotesInOutline(Outline* outline, std::vector<std::pair<Note*,float>>* result, const AhoCorasick& regexps, std::vector<int>& counts);
+    void assessNotes(Outline* scope, std::vector<std::pair<Note*,float>>* result, const std::vector<std::string>& regexps);
+
+    const TextShadow& getShadow(const Outline* outline);
+    const TextShadow& getShadow(const Note* note);
+    const TextShadow& getShadow(
+            const Thing* thing,
+            u_int32_t revision,
+            const std::string& name,
+            const std::vector<std::string*>& description);
 };
 
 }
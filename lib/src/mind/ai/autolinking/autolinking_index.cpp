@@ -0,0 +1,148 @@
+/*
+ autolinking_index.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "autolinking_index.h"
+
+#include <unordered_map>
+
+namespace m8r {
+
+using namespace std;
+
+/*
+ * Names
+ */
+
+AutolinkingIndex::Names::Names(const vector<string>& names)
+    : automaton{},
+      spellings{},
+      namesCount{names.size()}
+{
+    // spellings w/ the same lowercased name share automaton pattern
+    unordered_map<string,int> patterns{};
+    string lower{};
+    for(const string& name:names) {
+        toAsciiLower(name, lower);
+        auto p = patterns.find(lower);
+        if(p == patterns.end()) {
+            int id = automaton.addPattern(lower);
+            if(id < 0) {
+                continue;
+            }
+            patterns[lower] = id;
+            spellings.emplace_back();
+            spellings[id].push_back(name);
+        } else {
+            spellings[p->second].push_back(name);
+        }
+    }
+    automaton.build();
+}
+
+AutolinkingIndex::Names::~Names()
+{
+}
+
+/*
+ * Index
+ */
+
+void AutolinkingIndex::toAsciiLower(const string& s, string& lower)
+{
+    // ASCII only ~ UTF-8 sequences and offsets are kept intact
+    lower.resize(s.size());
+    for(size_t i=0; i<s.size(); i++) {
+        lower[i] = s[i]>='A' && s[i]<='Z' ? s[i]+('a'-'A') : s[i];
+    }
+}
+
+AutolinkingIndex::AutolinkingIndex(
+    shared_ptr<const Names> base,
+    shared_ptr<const Names> delta,
+    const unordered_set<string>& removed,
+    uint64_t generation)
+    : base{base},
+      delta{delta},
+      removed{removed},
+      generation{generation}
+{
+}
+
+AutolinkingIndex::~AutolinkingIndex()
+{
+}
+
+bool AutolinkingIndex::isName(
+    const Names& names,
+    int id,
+    const string& text,
+    size_t begin,
+    size_t end,
+    bool caseInsensitive) const
+{
+    for(const string& s:names.getSpellings(id)) {
+        if((caseInsensitive || !text.compare(begin, end-begin, s))
+           && (removed.empty() || !removed.count(s)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AutolinkingIndex::findMatches(
+    const string& text,
+    vector<pair<size_t,size_t>>& matches,
+    bool caseInsensitive) const
+{
+    matches.clear();
+
+    string lower{};
+    toAsciiLower(text, lower);
+    for(const Names* names:{base.get(), delta.get()}) {
+        if(names) {
+            const AhoCorasick& automaton = names->getAutomaton();
+            automaton.match(lower, [&](int id, size_t end) {
+                size_t begin = end-automaton.getPatternLength(id);
+                if(isName(*names, id, text, begin, end, caseInsensitive)) {
+                    matches.push_back(make_pair(begin, end));
+                }
+            });
+        }
+    }
+}
+
+bool AutolinkingIndex::findLongestPrefixWord(const string& s, string& r) const
+{
+    vector<pair<size_t,size_t>> matches{};
+    findMatches(s, matches, false);
+
+    size_t longest{};
+    for(const pair<size_t,size_t>& m:matches) {
+        if(m.first == 0 && m.second > longest) {
+            longest = m.second;
+        }
+    }
+    if(longest) {
+        r.append(s, 0, longest);
+        return true;
+    }
+    return false;
+}
+
+} // m8r namespace
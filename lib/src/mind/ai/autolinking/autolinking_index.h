@@ -0,0 +1,124 @@
+/*
+ autolinking_index.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_AUTOLINKING_INDEX_H
+#define M8R_AUTOLINKING_INDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../../../debug.h"
+#include "../../../gear/aho_corasick.h"
+
+namespace m8r {
+
+/**
+ * @brief Immutable snapshot of autolinking index.
+ *
+ * Snapshot is never modified once created, therefore it can be read by any number
+ * of threads w/o synchronization - readers take snapshot (shared pointer) and
+ * writers publish new snapshots (RCU-style).
+ *
+ * Snapshot consists of base names (compiled rarely), delta names (names added since
+ * base compilation) and names removed since base compilation. Base is shared by
+ * snapshots, therefore publishing of a small change costs delta compilation only.
+ */
+class AutolinkingIndex
+{
+public:
+    /**
+     * @brief Names compiled to Aho-Corasick automaton of lowercased names.
+     */
+    class Names
+    {
+    private:
+        AhoCorasick automaton;
+        // automaton pattern ID > exact (case sensitive) spellings of the name
+        std::vector<std::vector<std::string>> spellings;
+        size_t namesCount;
+
+    public:
+        explicit Names(const std::vector<std::string>& names);
+        Names(const Names&) = delete;
+        Names(const Names&&) = delete;
+        Names &operator=(const Names&) = delete;
+        Names &operator=(const Names&&) = delete;
+        ~Names();
+
+        size_t size() const { return namesCount; }
+        const AhoCorasick& getAutomaton() const { return automaton; }
+        const std::vector<std::string>& getSpellings(int id) const { return spellings[id]; }
+    };
+
+    static void toAsciiLower(const std::string& s, std::string& lower);
+
+private:
+    std::shared_ptr<const Names> base;
+    std::shared_ptr<const Names> delta;
+    // base names which are no longer names
+    std::unordered_set<std::string> removed;
+    uint64_t generation;
+
+public:
+    explicit AutolinkingIndex(
+        std::shared_ptr<const Names> base,
+        std::shared_ptr<const Names> delta,
+        const std::unordered_set<std::string>& removed,
+        uint64_t generation);
+    AutolinkingIndex(const AutolinkingIndex&) = delete;
+    AutolinkingIndex(const AutolinkingIndex&&) = delete;
+    AutolinkingIndex &operator=(const AutolinkingIndex&) = delete;
+    AutolinkingIndex &operator=(const AutolinkingIndex&&) = delete;
+    ~AutolinkingIndex();
+
+    /**
+     * @brief Generation is incremented w/ every published snapshot.
+     */
+    uint64_t getGeneration() const { return generation; }
+
+    /**
+     * @brief Find all (also overlapping) occurrences of names in text.
+     *
+     * Matches are (begin, end) offsets.
+     */
+    void findMatches(
+        const std::string& text,
+        std::vector<std::pair<size_t,size_t>>& matches,
+        bool caseInsensitive) const;
+
+    /**
+     * @brief Find longest name which is (case sensitive) prefix of s - name is appended to r.
+     */
+    bool findLongestPrefixWord(const std::string& s, std::string& r) const;
+
+private:
+    bool isName(
+        const Names& names,
+        int id,
+        const std::string& text,
+        size_t begin,
+        size_t end,
+        bool caseInsensitive) const;
+};
+
+}
+#endif // M8R_AUTOLINKING_INDEX_H
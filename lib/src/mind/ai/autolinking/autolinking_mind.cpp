@@ -20,24 +20,38 @@
 
 #include "../../mind.h"
 
+#include <algorithm>
+#include <iterator>
+
 #ifdef MF_MD_2_HTML_CMARK
 
 namespace m8r {
 
 using namespace std;
 
+constexpr size_t AutolinkingMind::DELTA_RATIO;
+constexpr size_t AutolinkingMind::DELTA_MIN_SIZE;
+
 AutolinkingMind::AutolinkingMind(Mind& mind)
     : mind{mind},
-      trie{nullptr}
+      writerMutex{},
+      words{},
+      base{},
+      deltaWords{},
+      removedWords{},
+      outlineWords{},
+      generation{0},
+      epoch{0},
+      rebuildPending{false},
+      rebuildFuture{},
+      snapshot{}
 {
+    clear();
 }
 
 AutolinkingMind::~AutolinkingMind()
 {
-    if(trie) {
-        delete trie;
-        trie = nullptr;
-    }
+    waitForRebuild();
 }
 
 bool AutolinkingMind::aliasSizeComparator(const Thing* t1, const Thing* t2)
@@ -45,42 +59,34 @@ bool AutolinkingMind::aliasSizeComparator(const Thing* t1, const Thing* t2)
     return t1->getAutolinkingAlias().size() > t2->getAutolinkingAlias().size();
 }
 
-void AutolinkingMind::updateTrieIndex()
+void AutolinkingMind::reindex()
 {
-    // IMPROVE update indices only if an O/N is modified (except writing read timestamps)
-
 #ifdef DO_MF_DEBUG
-    MF_DEBUG("[Autolinking] Rebuilding trie index..." << endl);
+    MF_DEBUG("[Autolinking] Rebuilding index..." << endl);
     auto begin = chrono::high_resolution_clock::now();
-    int size{};
+    size_t size{};
 #endif
 
     clear();
 
-    // Os
+    lock_guard<mutex> criticalSection{writerMutex};
+
+    // Os and their Ns
     const vector<Outline*>& os=mind.getOutlines();
-#ifdef DO_MF_DEBUG
-    size = os.size();
-#endif
     for(Outline* o:os) {
-        addThingToTrie(o);
-    }
-
-    // Ns
-    std::vector<Note*> notes;
-    mind.getAllNotes(notes);
+        indexOutline(o);
 #ifdef DO_MF_DEBUG
-    size += notes.size();
+        size += 1 + o->getNotesCount();
 #endif
-    for(Note* n:notes) {
-        addThingToTrie(n);
     }
 
     // IMPROVE: add also tags
 
+    scheduleRebuild();
+
 #ifdef DO_MF_DEBUG
     auto end = chrono::high_resolution_clock::now();
-    MF_DEBUG("[Autolinking] trie w/ " << size << " things updated in: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000000.0 << "ms" << endl);
+    MF_DEBUG("[Autolinking] names of " << size << " things indexed in: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
 #endif
 }
 
@@ -91,45 +97,221 @@ string AutolinkingMind::getLowerName(const std::string& name)
     return lowerName;
 }
 
-void AutolinkingMind::addThingToTrie(const Thing *t) {
-    // name
-    trie->addWord(t->getAutolinkingName());
-    // name w/ lowercase 1st letter
-    trie->addWord(getLowerName(t->getAutolinkingName()));
+void AutolinkingMind::getThingWords(const Thing* t, vector<string>& thingWords)
+{
+    const string& name = t->getAutolinkingName();
+    if(name.size()) {
+        // name
+        thingWords.push_back(name);
+        // name w/ lowercase 1st letter
+        thingWords.push_back(getLowerName(name));
+    }
     // abbrev (if present)
-    trie->addWord(t->getAutolinkingAbbr());
+    if(t->getAutolinkingAbbr().size()) {
+        thingWords.push_back(t->getAutolinkingAbbr());
+    }
+}
+
+bool AutolinkingMind::indexOutline(const Outline* outline)
+{
+    vector<string> newWords{};
+    getThingWords(outline, newWords);
+    for(const Note* n:outline->getNotes()) {
+        getThingWords(n, newWords);
+    }
+    sort(newWords.begin(), newWords.end());
+
+    vector<string>& oldWords = outlineWords[outline];
+    if(oldWords == newWords) {
+        return false;
+    }
+
+    // (multi)sets difference - only added/removed names are updated
+    vector<string> diff{};
+    set_difference(oldWords.begin(), oldWords.end(), newWords.begin(), newWords.end(), back_inserter(diff));
+    for(const string& w:diff) {
+        removeWord(w);
+    }
+    diff.clear();
+    set_difference(newWords.begin(), newWords.end(), oldWords.begin(), oldWords.end(), back_inserter(diff));
+    for(const string& w:diff) {
+        addWord(w);
+    }
+
+    oldWords.swap(newWords);
+    return true;
+}
+
+void AutolinkingMind::remember(const Outline* outline)
+{
+    if(outline) {
+        lock_guard<mutex> criticalSection{writerMutex};
+        if(indexOutline(outline)) {
+            MF_DEBUG("[Autolinking] O names updated: " << outlineWords[outline].size() << endl);
+            update();
+        }
+    }
+}
+
+void AutolinkingMind::forget(const Outline* outline)
+{
+    lock_guard<mutex> criticalSection{writerMutex};
+    auto o = outlineWords.find(outline);
+    if(o != outlineWords.end()) {
+        for(const string& w:o->second) {
+            removeWord(w);
+        }
+        outlineWords.erase(o);
+        update();
+    }
 }
 
-void AutolinkingMind::removeThingFromTrie(const Thing *t) {
-    trie->removeWord(t->getAutolinkingName());
-    trie->removeWord(getLowerName(t->getAutolinkingName()));
-    trie->removeWord(t->getAutolinkingAbbr());
+void AutolinkingMind::addWord(const string& word)
+{
+    // words w/ zero refcount are kept until base compilation
+    Word& w = words.insert(make_pair(word, Word{0, false, 0})).first->second;
+    if(w.refCount++ == 0) {
+        if(w.compiled) {
+            removedWords.erase(word);
+        } else {
+            deltaWords.push_back(word);
+        }
+    }
+}
+
+void AutolinkingMind::removeWord(const string& word)
+{
+    auto w = words.find(word);
+    if(w != words.end() && w->second.refCount > 0 && --w->second.refCount == 0) {
+        if(w->second.compiled) {
+            // base can't be updated in place > filter its matches
+            removedWords.insert(word);
+        } else {
+            deltaWords.erase(std::remove(deltaWords.begin(), deltaWords.end(), word), deltaWords.end());
+        }
+    }
+}
+
+bool AutolinkingMind::isRebuildNeeded() const
+{
+    size_t baseSize = base?base->size():0;
+    return deltaWords.size() > std::max(DELTA_MIN_SIZE, baseSize/DELTA_RATIO)
+           || removedWords.size() > baseSize/2;
+}
+
+void AutolinkingMind::update()
+{
+    if(rebuildPending) {
+        // changes are published by base compilation in progress
+        return;
+    }
+    if(isRebuildNeeded()) {
+        scheduleRebuild();
+    } else {
+        publish();
+    }
+}
+
+void AutolinkingMind::publish()
+{
+    shared_ptr<const AutolinkingIndex::Names> delta{};
+    if(deltaWords.size()) {
+        delta = make_shared<const AutolinkingIndex::Names>(deltaWords);
+    }
+    shared_ptr<const AutolinkingIndex> index = make_shared<const AutolinkingIndex>(
+        base, delta, removedWords, ++generation);
+    std::atomic_store(&snapshot, index);
+
+    MF_DEBUG("[Autolinking] index #" << generation << " published: " << (base?base->size():0) << " + " << deltaWords.size() << " - " << removedWords.size() << " names" << endl);
 }
 
-void AutolinkingMind::update(const std::string& oldName, const std::string& newName)
+void AutolinkingMind::scheduleRebuild()
 {
-    MF_DEBUG("Autolink update: '" << oldName << " > '" << newName << "'" << endl);
+    if(!rebuildPending) {
+        rebuildPending = true;
+        // previous compilation is done (or finishing) when not pending
+        if(rebuildFuture.valid()) {
+            rebuildFuture.wait();
+        }
+        rebuildFuture = std::async(std::launch::async, [this]() { rebuildBase(); });
+    }
+}
 
-    if(oldName.compare(newName)) {
-        if(oldName.size()) {
-            Thing t{oldName};
-            removeThingFromTrie(&t);
+void AutolinkingMind::rebuildBase()
+{
+    vector<string> names{};
+    // compilation is repeated if indices are cleared meanwhile (new base would be obsolete)
+    for(;;) {
+        unsigned rebuildEpoch{};
+        {
+            lock_guard<mutex> criticalSection{writerMutex};
+            rebuildEpoch = ++epoch;
+            names.clear();
+            names.reserve(words.size());
+            for(auto& w:words) {
+                if(w.second.refCount > 0) {
+                    w.second.epoch = rebuildEpoch;
+                    names.push_back(w.first);
+                }
+            }
         }
-        if(newName.size()) {
-            Thing t{newName};
-            addThingToTrie(&t);
+
+        // readers use published snapshot and writers are not blocked while compiling
+        shared_ptr<const AutolinkingIndex::Names> compiled
+            = make_shared<const AutolinkingIndex::Names>(names);
+
+        lock_guard<mutex> criticalSection{writerMutex};
+        if(rebuildEpoch == epoch) {
+            // names changed during compilation are reconciled w/ new base
+            base = compiled;
+            deltaWords.clear();
+            removedWords.clear();
+            for(auto w = words.begin(); w != words.end(); ) {
+                w->second.compiled = w->second.epoch == rebuildEpoch;
+                if(w->second.compiled) {
+                    if(w->second.refCount == 0) {
+                        removedWords.insert(w->first);
+                    }
+                } else if(w->second.refCount > 0) {
+                    deltaWords.push_back(w->first);
+                } else {
+                    w = words.erase(w);
+                    continue;
+                }
+                ++w;
+            }
+
+            rebuildPending = false;
+            publish();
+            return;
         }
     }
+}
 
-    MF_DEBUG("DONE autolink update: '" << oldName << "' > '" << newName << "'" << endl);
+void AutolinkingMind::waitForRebuild()
+{
+    std::future<void> f{};
+    {
+        lock_guard<mutex> criticalSection{writerMutex};
+        f = std::move(rebuildFuture);
+    }
+    if(f.valid()) {
+        f.wait();
+    }
 }
 
 void AutolinkingMind::clear()
 {
-    if(trie) {
-        delete trie;
-    }
-    trie = new Trie{};
+    lock_guard<mutex> criticalSection{writerMutex};
+
+    words.clear();
+    base.reset();
+    deltaWords.clear();
+    removedWords.clear();
+    outlineWords.clear();
+    // compilation in progress (if any) is obsoleted
+    epoch++;
+    publish();
 
     MF_DEBUG("[Autolinking] indices CLEARed" << endl);
 }
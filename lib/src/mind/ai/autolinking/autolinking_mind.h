@@ -23,24 +23,76 @@
 
 #include <vector>
 #include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 #include "../../../debug.h"
 #include "../../ontology/thing_class_rel_triple.h"
-#include "../../../gear/trie.h"
+#include "autolinking_index.h"
 
 namespace m8r {
 
 class Mind;
+class Outline;
 
 /**
  * @brief Autolinking indices and inferences.
+ *
+ * Indices are maintained incrementally: names (and abbrevs) of O and its Ns are
+ * remembered per O and when O is remembered (saved), only names which were added
+ * or removed are updated. Full rebuild is performed on learn() only.
+ *
+ * Readers (renderers on any thread) never wait for index maintenance - they take
+ * immutable AutolinkingIndex snapshot, which is published by atomic pointer swap
+ * (RCU-style). Aho-Corasick automaton cannot be updated in place, therefore names
+ * added since the last compilation are compiled to a small delta (synchronously)
+ * and removed names are filtered out. When delta grows, all names are compiled
+ * to new base in the background and published when done.
  */
 class AutolinkingMind
 {
 private:
+    // names are merged to new base when delta exceeds 1/DELTA_RATIO of base
+    static constexpr size_t DELTA_RATIO = 8;
+    static constexpr size_t DELTA_MIN_SIZE = 256;
+
+    struct Word {
+        int refCount;
+        // compiled to the base (removed if refCount is 0)
+        bool compiled;
+        // names collected by base compilation in progress are stamped w/ its epoch
+        unsigned epoch;
+    };
+
     Mind& mind;
 
-    Trie* trie;
+    /*
+     * Writers' state - guarded by mutex.
+     */
+
+    std::mutex writerMutex;
+    // Os/Ns names (and abbrevs) w/ refcount
+    std::unordered_map<std::string,Word> words;
+    std::shared_ptr<const AutolinkingIndex::Names> base;
+    std::vector<std::string> deltaWords;
+    std::unordered_set<std::string> removedWords;
+    // O > names (and abbrevs) of O and its Ns as indexed (sorted)
+    std::unordered_map<const Outline*,std::vector<std::string>> outlineWords;
+    uint64_t generation;
+    unsigned epoch;
+    bool rebuildPending;
+    std::future<void> rebuildFuture;
+
+    /*
+     * Readers' state - atomically swapped.
+     */
+
+    std::shared_ptr<const AutolinkingIndex> snapshot;
 
 public:
     explicit AutolinkingMind(Mind& mind);
@@ -51,24 +103,34 @@ public:
     ~AutolinkingMind();
 
     /**
-     * @brief Rebuild indices (like trie) e.g. on new MD/repository load.
+     * @brief Rebuild indices e.g. on new MD/repository load.
+     *
+     * Names are compiled in the background - empty index is used until it's done.
      */
-    void reindex() {
-        updateTrieIndex();
-    }
+    void reindex();
 
     /**
-     * @brief Update indices on a thing rename.
+     * @brief Update indices w/ names of (new, modified or renamed) O and its Ns.
      */
-    void update(const std::string& oldName, const std::string& newName);
+    void remember(const Outline* outline);
 
     /**
-     * @brief Find longest autolinking match.
+     * @brief Remove names of O and its Ns from indices (O is not dereferenced).
      */
-    bool findLongestPrefixWord(std::string& s, std::string& r) const {
-        return trie->findLongestPrefixWord(s, r);
+    void forget(const Outline* outline);
+
+    /**
+     * @brief Get the latest published index snapshot (never null).
+     */
+    std::shared_ptr<const AutolinkingIndex> getIndex() const {
+        return std::atomic_load(&snapshot);
     }
 
+    /**
+     * @brief Wait for background compilation (if any) - for tests and shutdown.
+     */
+    void waitForRebuild();
+
     /**
      * @brief Clear indices.
      */
@@ -83,19 +145,28 @@ protected:
     static std::string getLowerName(const std::string& name);
 
     /**
-     * @brief Update trie-based Os and Ns names index.
+     * @brief Get thing's name (and abbrev) as indexed.
      */
-    void updateTrieIndex();
+    static void getThingWords(const Thing* t, std::vector<std::string>& thingWords);
 
     /**
-     * @brief Add thing's name (and abbrev) to trie.
+     * @brief Diff O's names w/ indexed names.
+     *
+     * @return true if indexed names were changed.
      */
-    void addThingToTrie(const Thing *t);
+    bool indexOutline(const Outline* outline);
+
+    void addWord(const std::string& word);
+    void removeWord(const std::string& word);
 
     /**
-     * @brief Remove thing's name (and abbrev) from trie.
+     * @brief Publish new snapshot w/ delta compiled (or schedule base compilation).
      */
-    void removeThingFromTrie(const Thing *t);
+    void update();
+    void publish();
+    bool isRebuildNeeded() const;
+    void scheduleRebuild();
+    void rebuildBase();
 };
 
 }
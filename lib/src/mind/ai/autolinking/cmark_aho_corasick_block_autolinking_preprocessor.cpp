@@ -22,6 +22,14 @@
   #include <cmark-gfm.h>
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "autolinking_index.h"
+
 /*
  * High priority tasks:
  *
@@ -40,9 +48,6 @@
  *      (JavaScript algorithm library uses upper case words as title convention - no matches)
  * - bugs
  *    - cmark leaks when ALL unit tests are run (not just cmark test case)
- * - performance
- *    - move trie to memory (or mind) and keep it up to date there (based on mind state)
- *    - O or N edit: always DELETE old name and add new name to TRIE
  *
  * Plan:
  *
@@ -55,20 +60,8 @@
  *    - blacklist ~ don't autolink e.g. http (to protect cmark's URLs autolinking)
  *
  * - performance
- *    - avoid trie rebuild - on N save():
- *      ! implement delete operation on trie:
- *       - enhance trie w/ refcount for words so that delete knows whether to remove or not
- *       - implement delete() operation:
- *        - finds word mark, decreases refcount, if it's leaf than it goes up deletes orphan
- *      OR:
- *      1) synchronous: add new N name to trie on its save()
- *      2) async: after save let trie rebuild async in other
- *         thread to update it (trie access must be synchronized)
  *    - avoid autolinking whole O on its load - it's not needed > debug why it happens
- *    - map search structure instead of Aho
  *    - benchmark on C++ repo
- *    ! configurable time limit on autolinking and leave on exceeding it
- *      (measure time from autlinking start and stop document transformation)
  */
 
 namespace m8r {
@@ -123,146 +116,88 @@ cmark_node* injectAstTxtNode(
     return txtNode;
 }
 
-void injectThingsLinks(cmark_node* srcNode, Mind& mind)
+inline bool isAutolinkingBoundary(const string& txt, size_t offset)
 {
-    // copy w to t as it will be chopped word/match by word/match from head to tail
-    string txt{cmark_node_get_literal(srcNode)};
-    string pre{}, at{}, chop{};
-    size_t preSize{};
+    return CmarkAhoCorasickBlockAutolinkingPreprocessor::TRAILING_CHARS.find(txt[offset]) != string::npos;
+}
 
-    cmark_node* node{};
+/**
+ * @brief Inject links to O/Ns whose names are found in text node.
+ *
+ * Text node is scanned only once by Aho-Corasick automaton (of lowercased names)
+ * which gives all occurrences of all names. Matches of whole words are used only (match must be
+ * surrounded by trailing chars or text begin/end), overlapping matches are resolved
+ * as leftmost-longest. Text between links is copied as is.
+ *
+ * @return true if links were injected, false if text node was left intact.
+ */
+bool injectThingsLinks(
+    cmark_node* srcNode,
+    const AutolinkingIndex& index,
+    bool insensitive,
+    vector<pair<size_t,size_t>>& matches
+)
+{
+    const string txt{cmark_node_get_literal(srcNode)};
 
 #ifdef DO_MF_DEBUG
     MF_DEBUG("[Autolinking] Injecting links to: '" << txt << "'" << endl);
 #endif
 
-    while(txt.size()>0) {
-        // skip trailing chars and append them
-        preSize = 0;
-        while(preSize < txt.size()) {
-            // check $$ to detect begin/end of math (MathJax) section to ignore it
-            if(txt.size()>=2 && '$'==txt.at(0) && '$'==txt.at(1)) {
-                MF_DEBUG("MATH matched" << endl);
-                // TODO toggle math
-                preSize+=2;
-                if(txt.size()==2) {
-                    break;
-                }
-            }
+    index.findMatches(txt, matches, insensitive);
+    if(matches.empty()) {
+        return false;
+    }
 
-            if(CmarkAhoCorasickBlockAutolinkingPreprocessor::TRAILING_CHARS.find(txt.at(preSize)) != string::npos) {
-                preSize++;
-            } else {
-                break;
-            }
+    // leftmost first, longest first for the same begin
+    sort(
+        matches.begin(),
+        matches.end(),
+        [](const pair<size_t,size_t>& m1, const pair<size_t,size_t>& m2) {
+            return m1.first < m2.first || (m1.first == m2.first && m1.second > m2.second);
+        });
+
+    cmark_node* node{};
+    string at{}, link{};
+    size_t cursor{};
+    for(const pair<size_t,size_t>& m:matches) {
+        if(m.first < cursor) {
+            // overlaps w/ already linked match
+            continue;
         }
-        if(preSize) {
-            // chop trailing chars prefix from input and append it to result
-            at.append(txt.substr(0, preSize));
-            txt = txt.substr(preSize);
-
-            MF_DEBUG("  Skipping trailing chars: '" << txt.substr(0, preSize) << "'" << endl);
-            MF_DEBUG("     txt: '" << txt << "'" << endl);
-            MF_DEBUG("     at : '" << at  << "'" << endl);
+        // avoid word PREFIX/SUFFIX matches ~ ensure that WHOLE world is matched
+        if((m.first && !isAutolinkingBoundary(txt, m.first-1))
+           || (m.second < txt.size() && !isAutolinkingBoundary(txt, m.second)))
+        {
+            continue;
         }
 
-        // try to match word
-        pre.clear();
-
-        MF_DEBUG("  Trie search txt: '" << txt << "'" << endl);
-        if(mind.autolinkFindLongestPrefixWord(txt, pre)) {
-            MF_DEBUG("    Matched prefix: '" << pre << "'" << endl);
-
-            // avoid word PREFIX matches ~ ensure that WHOLE world is matched:
-            // - match followed by trailing char
-            // - match until EOL
-
-            // determine trailing char
-            char tChar{txt.size()==pre.size()?' ':txt.at(pre.size())};
-            MF_DEBUG("    Match's trailing char: '" << tChar << "'" << endl);
-            if(CmarkAhoCorasickBlockAutolinkingPreprocessor::TRAILING_CHARS.find(tChar) != string::npos
-               || txt.size() == pre.size()
-            ) {
-                // AST: add text node w/ content preceding link
-                // IMPROVE make this method
-                if(at.size()) {
-                    node = injectAstTxtNode(srcNode, node, at);
-                }
+        MF_DEBUG("    Matched: '" << txt.substr(m.first, m.second-m.first) << "'" << endl);
 
-                // AST: add link
-                node = injectAstLinkNode(srcNode, node, pre);
+        // AST: add text node w/ content preceding link
+        if(m.first > cursor) {
+            at.assign(txt, cursor, m.first-cursor);
+            node = injectAstTxtNode(srcNode, node, at);
+        }
+        // AST: add link
+        link.assign(txt, m.first, m.second-m.first);
+        node = injectAstLinkNode(srcNode, node, link);
 
-                // chop linked prefix word from input word w
-                if(txt.size() == pre.size()) {
-                    txt.clear();
-                } else {
-                    txt = txt.substr(pre.size());
-                }
-                // trailing char will be handled later
-                at.clear();
-
-                MF_DEBUG("    txt: '" << txt << "'" << endl);
-                MF_DEBUG("    at : '" << at  << "'" << endl);
-            } else {
-                // invalid trailing char > matched a NOT-whole-world prefix > skip and append one word
-
-                // TODO make it method
-                // current w prefix was NOT linked > chop it and append it
-                size_t begin = txt.find_first_of(" \t");
-                if(begin != string::npos) {
-                    chop = txt.substr(0, begin);
-                    txt = txt.substr(begin+1);
-                    at.append(chop);
-                    // TODO IMPORTANT append what was found - space or tab! simply index there
-                    at.append(" ");
-
-                    MF_DEBUG("  Skiping word: '" << chop << "'" << endl);
-                    MF_DEBUG("     txt: '" << txt << "'" << endl);
-                    MF_DEBUG("     at : '" << at  << "'" << endl);
-                } else {
-                    // no more words (prefix already checked) > DONE
-                    at.append(txt);
-
-                    MF_DEBUG("  DONE no-more words: '" << chop << "'" << endl);
-                    MF_DEBUG("     txt: '" << txt << "'" << endl);
-                    MF_DEBUG("     at : '" << at  << "'" << endl);
+        cursor = m.second;
+    }
 
-                    break;
-                }
-            }
-        } else {
-            // didn't match prefix > skip and append one word
-
-            // TODO make it method
-            // current w prefix was NOT linked > chop it and append it
-            size_t begin = txt.find_first_of(" \t");
-            if(begin != string::npos) {
-                chop = txt.substr(0, begin);
-                txt = txt.substr(begin+1);
-                at.append(chop);
-                // TODO IMPORTANT append what was found - space or tab! simply index there
-                at.append(" ");
-
-                MF_DEBUG("  Skiping word: '" << chop << "'" << endl);
-                MF_DEBUG("     txt: '" << txt << "'" << endl);
-                MF_DEBUG("     at : '" << at  << "'" << endl);
-            } else {
-                // no more words (prefix already checked) > DONE
-                at.append(txt);
-
-                MF_DEBUG("  DONE no-more words: '" << chop << "'" << endl);
-                MF_DEBUG("     txt: '" << txt << "'" << endl);
-                MF_DEBUG("     at : '" << at  << "'" << endl);
-
-                break;
-            }
-        }
+    if(!node) {
+        // no whole word matched
+        return false;
     }
 
-    // AST: add text node w/ content preceding link
-    if(at.size()) {
+    // AST: add text node w/ content following the last link
+    if(cursor < txt.size()) {
+        at.assign(txt, cursor, string::npos);
         node = injectAstTxtNode(srcNode, node, at);
     }
+
+    return true;
 }
 
 /*
@@ -271,8 +206,14 @@ void injectThingsLinks(cmark_node* srcNode, Mind& mind)
 
 const string CmarkAhoCorasickBlockAutolinkingPreprocessor::TRAILING_CHARS = string{" \t,:;.!?<>{}&()-+/*\\_=%~#$^[]'\""};
 
+constexpr size_t CmarkAhoCorasickBlockAutolinkingPreprocessor::MEMO_CAPACITY;
+
 CmarkAhoCorasickBlockAutolinkingPreprocessor::CmarkAhoCorasickBlockAutolinkingPreprocessor(Mind& mind)
-    : AutolinkingPreprocessor{mind}
+    : AutolinkingPreprocessor{mind},
+      memoMutex{},
+      memo{},
+      memoHits{0},
+      timeLimitExceeded{0}
 {
 }
 
@@ -284,37 +225,99 @@ void CmarkAhoCorasickBlockAutolinkingPreprocessor::process(
     const vector<string*>& md,
     string& amd
 ) {
+    string mds{};
+    toString(md, mds);
+
+    // index snapshot is immutable ~ consistent for the whole document and never blocked by updates
+    shared_ptr<const AutolinkingIndex> index = mind.autolinkGetIndex();
+    autolink(mds, index.get(), amd);
+}
+
+bool CmarkAhoCorasickBlockAutolinkingPreprocessor::processDescription(
+    const Note* note,
+    string& amd
+) {
+    string mds{};
+    toString(note->getDescription(), mds);
+
+    shared_ptr<const AutolinkingIndex> index = mind.autolinkGetIndex();
+    if(!index) {
+        return autolink(mds, nullptr, amd);
+    }
+
+    // description hash protects memo against N changes w/o revision change and N reallocation
+    const bool caseInsensitive = Configuration::getInstance().isAutolinkingCaseInsensitive();
+    const size_t descriptionHash = std::hash<string>{}(mds);
+    {
+        lock_guard<mutex> criticalSection{memoMutex};
+        auto m = memo.find(note);
+        if(m != memo.end()
+           && m->second.revision == note->getRevision()
+           && m->second.generation == index->getGeneration()
+           && m->second.insensitive == caseInsensitive
+           && m->second.descriptionHash == descriptionHash)
+        {
+            MF_DEBUG("[Autolinking] memo HIT: " << note->getName() << endl);
+            memoHits++;
+            amd.assign(m->second.amd);
+            return true;
+        }
+    }
+
+    if(autolink(mds, index.get(), amd)) {
+        // partially autolinked descriptions are not memoized
+        lock_guard<mutex> criticalSection{memoMutex};
+        if(memo.size() >= MEMO_CAPACITY) {
+            memo.clear();
+        }
+        Memo& m = memo[note];
+        m.revision = note->getRevision();
+        m.generation = index->getGeneration();
+        m.insensitive = caseInsensitive;
+        m.descriptionHash = descriptionHash;
+        m.amd.assign(amd);
+        return true;
+    }
+
+    return false;
+}
+
+void CmarkAhoCorasickBlockAutolinkingPreprocessor::clearMemo()
+{
+    lock_guard<mutex> criticalSection{memoMutex};
+    memo.clear();
+}
+
+bool CmarkAhoCorasickBlockAutolinkingPreprocessor::autolink(
+    const string& mds,
+    const AutolinkingIndex* index,
+    string& amd
+) {
+    bool complete{true};
+
 #ifdef MF_MD_2_HTML_CMARK
 
 #ifdef DO_MF_DEBUG
     MF_DEBUG("[Autolinking] begin CMARK" << endl);
-    string ds{};
-    toString(md, ds);
-    MF_DEBUG("[Autolinking] input:" << endl << ">>>" << ds << "<<<" << endl);
-
-    auto begin = chrono::high_resolution_clock::now();
+    MF_DEBUG("[Autolinking] input:" << endl << ">>>" << mds << "<<<" << endl);
 #endif
 
-    insensitive = Configuration::getInstance().isAutolinkingCaseInsensitive();
-
-    // IMPROVE measure time in here and if over give limit, than STOP injecting
-    // and leave i.e. what happens is that a time SLA will be fulfilled and
-    // some part (prefix) of the input MD will be autolinked.
-
-    if(md.size()) {
-        string mds{};
-        toString(md, mds);
-        const char* mdsc{mds.c_str()};
+    const bool caseInsensitive = Configuration::getInstance().isAutolinkingCaseInsensitive();
+    const int timeLimit = Configuration::getInstance().getAutolinkingTimeLimit();
+    auto begin = chrono::steady_clock::now();
+    auto deadline = begin + chrono::milliseconds(timeLimit);
 
+    if(mds.size() && index) {
         cmark_node* document = cmark_parse_document(
-            mdsc,
-            strlen(mdsc),
+            mds.c_str(),
+            mds.size(),
             CMARK_OPT_DEFAULT
         );
 
         cmark_iter* astWalker = cmark_iter_new(document);
 
         vector<cmark_node*> zombies{};
+        vector<pair<size_t,size_t>> matches{};
 
         while (cmark_iter_next(astWalker) != CMARK_EVENT_DONE) {
             cmark_node* node = cmark_iter_get_node(astWalker);
@@ -324,9 +327,16 @@ void CmarkAhoCorasickBlockAutolinkingPreprocessor::process(
                  &&
                CMARK_NODE_PARAGRAPH == cmark_node_get_type(cmark_node_parent(node)))
             {
+                // time limit: links are injected to the document prefix only (SLA over completeness)
+                if(timeLimit && chrono::steady_clock::now() > deadline) {
+                    complete = false;
+                    break;
+                }
+
                 MF_DEBUG("[Autolinking] text node: '" << cmark_node_get_literal(node) << "'" << endl);
-                injectThingsLinks(node, mind);
-                zombies.push_back(node);
+                if(injectThingsLinks(node, *index, caseInsensitive, matches)) {
+                    zombies.push_back(node);
+                }
             }
         }
 
@@ -351,21 +361,31 @@ void CmarkAhoCorasickBlockAutolinkingPreprocessor::process(
         }
 
         cmark_node_free(document);
+    } else if(mds.size()) {
+        amd.assign(mds);
     } else {
         amd.clear();
     }
 
+    if(!complete) {
+        timeLimitExceeded++;
+        MF_DEBUG("[Autolinking] time limit " << timeLimit << "ms EXCEEDED - rest of the document was NOT autolinked" << endl);
+    }
+
 #ifdef DO_MF_DEBUG
     MF_DEBUG("[Autolinking] output:" << endl << "  >>>" << amd << "<<<" << endl);
 
-    auto end = chrono::high_resolution_clock::now();
-    MF_DEBUG("[Autolinking] MD autolinked in: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000000.0 << "ms" << endl);
+    auto end = chrono::steady_clock::now();
+    MF_DEBUG("[Autolinking] MD autolinked in: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
 #endif
 
 #else
+    UNUSED_ARG(index);
     // cmark-gfm not available - returning Markdown as is
-    toString(md, amd);
+    amd.assign(mds);
 #endif
+
+    return complete;
 }
 
 } // m8r namespace
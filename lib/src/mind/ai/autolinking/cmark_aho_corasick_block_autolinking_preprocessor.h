@@ -19,10 +19,17 @@
 #ifndef M8R_CMARK_AHO_CORASICK_BLOCK_AUTOLINKING_PREPROCESSOR_H
 #define M8R_CMARK_AHO_CORASICK_BLOCK_AUTOLINKING_PREPROCESSOR_H
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
 #include "../autolinking_preprocessor.h"
 
 namespace m8r {
 
+class AutolinkingIndex;
+
 /**
  * @brief cmark-gfm AST and Aho-Corasick autolinking pre-processor.
  *
@@ -88,6 +95,13 @@ namespace m8r {
  *  7. When the whole AST is walked and links injected:
  *    a) AST iterator is released.
  *    b) Collected original text nodes (zombies) are unlinked and deleted.
+ *
+ * Latency:
+ *
+ *  - Autolinking has time limit (configuration) - when it's exceeded, links are
+ *    not injected to remaining text nodes and rendering continues.
+ *  - Autolinked description of N is memoized - it's valid while N's revision,
+ *    description and autolinking index generation are the same.
  */
 class CmarkAhoCorasickBlockAutolinkingPreprocessor : public AutolinkingPreprocessor
 {
@@ -95,6 +109,24 @@ public:
     // allowed text MD snippets words trailing chars (\\... added newly)
     static const std::string TRAILING_CHARS;
 
+    // memo is dropped when full
+    static constexpr size_t MEMO_CAPACITY = 1<<12;
+
+private:
+    struct Memo {
+        uint32_t revision;
+        uint64_t generation;
+        bool insensitive;
+        size_t descriptionHash;
+        std::string amd;
+    };
+
+    std::mutex memoMutex;
+    std::unordered_map<const Note*,Memo> memo;
+
+    std::atomic<unsigned> memoHits;
+    std::atomic<unsigned> timeLimitExceeded;
+
 public:
     explicit CmarkAhoCorasickBlockAutolinkingPreprocessor(Mind& mind);
     CmarkAhoCorasickBlockAutolinkingPreprocessor(const CmarkAhoCorasickBlockAutolinkingPreprocessor&) = delete;
@@ -107,6 +139,29 @@ public:
      * @brief Autolink Markdown.
      */
     virtual void process(const std::vector<std::string*>& md, std::string& amd) override;
+
+    /**
+     * @brief Autolink N's description (memoized).
+     *
+     * @return false if autolinking was stopped because of the time limit.
+     */
+    virtual bool processDescription(const Note* note, std::string& amd) override;
+
+    void clearMemo();
+    unsigned getMemoHits() const { return memoHits; }
+    /**
+     * @brief How many times autolinking was stopped because of the time limit.
+     */
+    unsigned getTimeLimitExceeded() const { return timeLimitExceeded; }
+    virtual unsigned getIncompleteCount() const override { return timeLimitExceeded; }
+
+private:
+    /**
+     * @brief Autolink MD string.
+     *
+     * @return false if autolinking was stopped because of the time limit.
+     */
+    bool autolink(const std::string& mds, const AutolinkingIndex* index, std::string& amd);
 };
 
 }
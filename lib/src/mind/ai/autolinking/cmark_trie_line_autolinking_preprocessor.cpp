@@ -173,7 +173,7 @@ void CmarkTrieLineAutolinkingPreprocessor::process(
     MF_DEBUG("[Autolinking] output:" << endl << ">>>" << amd << "<<<" << endl);
 
     auto end = chrono::high_resolution_clock::now();
-    MF_DEBUG("[Autolinking] MD autolinked in: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000000.0 << "ms" << endl);
+    MF_DEBUG("[Autolinking] MD autolinked in: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
 #endif
 
 #else
@@ -246,7 +246,7 @@ void CmarkTrieLineAutolinkingPreprocessor::processLineByLine(
     MF_DEBUG("[Autolinking] output:" << endl << ">>" << amd << "<<" << endl);
 
     auto end = chrono::high_resolution_clock::now();
-    MF_DEBUG("[Autolinking] MD autolinked in: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000000.0 << "ms" << endl);
+    MF_DEBUG("[Autolinking] MD autolinked in: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
 #endif
 
 #else
@@ -18,6 +18,8 @@
 */
 #include "autolinking_preprocessor.h"
 
+#include "autolinking/autolinking_index.h"
+
 namespace m8r {
 
 using namespace std;
@@ -39,4 +41,10 @@ AutolinkingPreprocessor::~AutolinkingPreprocessor()
 {
 }
 
+uint64_t AutolinkingPreprocessor::getGeneration() const
+{
+    std::shared_ptr<const AutolinkingIndex> index = mind.autolinkGetIndex();
+    return index?index->getGeneration():0;
+}
+
 } // m8r namespace
@@ -63,6 +63,11 @@ public:
      * @brief Inject links to given MD source (list of rows) and return valid MD string.
      */
     virtual void process(const std::vector<std::string*>& in, std::string& out) = 0;
+
+    /**
+     * @brief Autolinking index generation - autolinked output is stale once it changes.
+     */
+    virtual uint64_t getGeneration() const override;
 };
 
 }
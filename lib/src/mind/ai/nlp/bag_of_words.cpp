@@ -24,10 +24,10 @@ BagOfWords::BagOfWords()
 {
 }
 
-void BagOfWords::reorderDocVectorsByWeight()
+void BagOfWords::reorderDocVectorsByWeight(size_t relevantSize)
 {
     for(auto& e:bow) {
-        e.second->sort();
+        e.second->sort(relevantSize);
     }
 }
 
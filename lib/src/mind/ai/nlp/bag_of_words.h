@@ -70,15 +70,42 @@ public:
         bow.clear();
     }
 
+    /**
+     * @brief Add doc vector - doc vector of changed doc is replaced (and deleted).
+     */
     void add(Thing* t, WordFrequencyList* wfl) {
-        bow[t] = wfl;
+        auto i = bow.find(t);
+        if(i != bow.end()) {
+            if(i->second != wfl) {
+                delete i->second;
+                i->second = wfl;
+            }
+        } else {
+            bow[t] = wfl;
+        }
+    }
+
+    /**
+     * @brief Remove (and delete) doc vector of forgotten doc.
+     */
+    void remove(Thing* t) {
+        auto i = bow.find(t);
+        if(i != bow.end()) {
+            delete i->second;
+            bow.erase(i);
+        }
     }
 
     WordFrequencyList* get(Thing* t) {
-        return bow[t];
+        // find() (not operator[]) so that BoW can be read by multiple threads
+        auto i = bow.find(t);
+        return i!=bow.end()?i->second:nullptr;
     }
 
-    void reorderDocVectorsByWeight();
+    /**
+     * @brief Sort doc vectors by weight and pick relevant words of each doc.
+     */
+    void reorderDocVectorsByWeight(size_t relevantSize=SIZE_MAX);
 
 #ifdef DO_MF_DEBUG
     void print() const {
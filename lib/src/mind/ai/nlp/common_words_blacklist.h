@@ -36,10 +36,10 @@ public:
     CommonWordsBlacklist &operator=(const CommonWordsBlacklist&&) = delete;
     ~CommonWordsBlacklist();
 
-    bool findWord(std::string s) const {
+    bool findWord(const std::string& s) const {
         return wordBlacklist.findWord(s);
     }
-    void addWord(std::string word) {
+    void addWord(const std::string& word) {
         wordBlacklist.addWord(word);
     }
 };
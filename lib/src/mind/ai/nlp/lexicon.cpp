@@ -24,6 +24,8 @@ Lexicon::Lexicon()
 {
     // inaccurate, but until the 1st word is added ;)
     maxFrequency = 1;
+    histogram.assign(2, 0);
+    generation = 0;
 }
 
 Lexicon::~Lexicon() = default;
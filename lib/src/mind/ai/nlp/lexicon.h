@@ -36,7 +36,9 @@ namespace m8r {
  * @brief Lexicon of all words w/ global frequencies.
  *
  * Lexicon is the *only* data structure in MF's AI that keeps words by *value*.
- * Other data structures use either pointers or references to be memory efficient.
+ * Other data structures use word IDs to be memory efficient - words are interned
+ * i.e. every word gets dense integer ID (index to embeddings and weights arrays)
+ * when it's added to lexicon for the first time.
  *
  */
 // IMPROVE Stanford GloVe lexicon w/ word attributes & semantic domains (configure > check existence > use OR skip)
@@ -47,15 +49,18 @@ public:
     struct WordEmbedding {
         // IMPROVE consider use of ptr to map's key
         std::string word;
+        int id;
         int frequency;
         float weight;
 
         explicit WordEmbedding() {
+            id = -1;
             frequency = 0;
             weight = 0.;
         }
-        explicit WordEmbedding(const std::string& ww, int f, float w) {
+        explicit WordEmbedding(const std::string& ww, int i, int f, float w) {
             word = ww;
+            id = i;
             frequency = f;
             weight = w;
         }
@@ -69,11 +74,18 @@ private:
     //         instead.
     std::map<std::string,WordEmbedding> m;
 
-    // sorted/ordered words by weight/frequency/... referencing/pointing to map
-    //std::vector<WordEmbedding*> words;
+    // word ID -> embedding (pointing to map which keeps nodes stable)
+    std::vector<WordEmbedding*> embeddings;
+    // word ID -> weight - flat array for vector kernels (valid after weights recalculation)
+    std::vector<float> weights;
 
     // keeping max word frequency for efficient weighs calculation
     int maxFrequency;
+    // frequency -> number of words w/ such frequency - max frequency is found w/o scan of words
+    std::vector<unsigned> histogram;
+
+    // incremented when lexicon is cleared i.e. when word IDs are reassigned
+    unsigned generation;
 
 public:
     explicit Lexicon();
@@ -84,7 +96,15 @@ public:
     ~Lexicon();
 
     size_t size() const { return m.size(); }
-    void clear() { m.clear(); }
+    void clear() {
+        m.clear();
+        embeddings.clear();
+        weights.clear();
+        maxFrequency = 1;
+        histogram.assign(2, 0);
+        generation++;
+    }
+    unsigned getGeneration() const { return generation; }
     const std::map<std::string,WordEmbedding>& get() const { return m; }
 
     WordEmbedding* get(const std::string& word) {
@@ -98,23 +118,79 @@ public:
     WordEmbedding* get(const std::string* word) {
         return get(*word);
     }
+    const WordEmbedding* get(int id) const {
+        return embeddings[id];
+    }
+
+    float getWeight(int id) const { return weights[id]; }
+    const std::vector<float>& getWeights() const { return weights; }
 
     WordEmbedding* add(const std::string& word) {
         WordEmbedding* result;
         if((result=get(word)) != nullptr) {
-            ++result->frequency;
+            setFrequency(result, result->frequency+1);
             if(result->frequency>maxFrequency) maxFrequency=result->frequency;
             return result;
         } else {
-            WordEmbedding we{word,1,0};
-            m[word] = we;
-            return &(m[word]);
+            auto i = m.emplace(word, WordEmbedding{word,static_cast<int>(embeddings.size()),1,0});
+            result = &i.first->second;
+            embeddings.push_back(result);
+            histogram[1]++;
+            return result;
         }
     }
     WordEmbedding* add(const std::string* word) {
         return add(*word);
     }
 
+    /**
+     * @brief Restore persisted word - IDs are assigned in order of restoration.
+     *
+     * @return nullptr if word is already in lexicon (persisted lexicon is corrupted).
+     */
+    WordEmbedding* restore(const std::string& word) {
+        auto i = m.emplace(word, WordEmbedding{word,static_cast<int>(embeddings.size()),0,0});
+        if(!i.second) {
+            return nullptr;
+        }
+        embeddings.push_back(&i.first->second);
+        histogram[0]++;
+        return &i.first->second;
+    }
+
+    /**
+     * @brief Increase word frequency by count (word of restored doc).
+     */
+    void add(int id, int count) {
+        WordEmbedding* e = embeddings[id];
+        setFrequency(e, e->frequency+count);
+        if(e->frequency>maxFrequency) maxFrequency=e->frequency;
+    }
+
+    /**
+     * @brief Decrease word frequency by count (word of forgotten/changed doc).
+     *
+     * Word keeps its ID even if its frequency drops to 0 (IDs are referenced by doc vectors).
+     * New max frequency is found in histogram - amortized O(1) as the max frequency
+     * drops at most by the sum of frequencies added before.
+     *
+     * @return true if max frequency changed i.e. all weights must be recalculated.
+     */
+    bool remove(int id, int count) {
+        WordEmbedding* e = embeddings[id];
+        setFrequency(e, e->frequency>count?e->frequency-count:0);
+        if(!histogram[maxFrequency]) {
+            int oldMaxFrequency = maxFrequency;
+            while(maxFrequency>1 && !histogram[maxFrequency]) {
+                maxFrequency--;
+            }
+            return oldMaxFrequency != maxFrequency;
+        }
+        return false;
+    }
+
+    int getMaxFrequency() const { return maxFrequency; }
+
     /**
      * @brief Recalculate word weights.
      *
@@ -130,15 +206,44 @@ public:
      *
      */
     void recalculateWeights() {
-        for(auto& e:m) {
-            e.second.weight =  1.f - ((((float)e.second.frequency)/100.f) / (((float)maxFrequency)/100.f));
+        weights.resize(embeddings.size());
+        for(WordEmbedding* e:embeddings) {
+            recalculateWeight(e);
+        }
+    }
 
-            // IMPROVE fixed constant is eight too big or small
-            // ensure max(w)'s weigh to be > 0
-            if(!e.second.weight) e.second.weight = 0.01f;
+    /**
+     * @brief Recalculate weight of a single word (its frequency changed, but max frequency did not).
+     */
+    void recalculateWeight(int id) {
+        if(weights.size() < embeddings.size()) {
+            weights.resize(embeddings.size());
         }
+        recalculateWeight(embeddings[id]);
     }
 
+private:
+    void setFrequency(WordEmbedding* e, int frequency) {
+        histogram[e->frequency]--;
+        if(static_cast<size_t>(frequency) >= histogram.size()) {
+            histogram.resize(frequency+1, 0);
+        }
+        histogram[frequency]++;
+        e->frequency = frequency;
+    }
+
+    void recalculateWeight(WordEmbedding* e) {
+        e->weight =  1.f - ((((float)e->frequency)/100.f) / (((float)maxFrequency)/100.f));
+
+        // IMPROVE fixed constant is eight too big or small
+        // ensure max(w)'s weigh to be > 0
+        if(!e->weight) e->weight = 0.01f;
+
+        weights[e->id] = e->weight;
+    }
+
+public:
+
 #ifdef DO_MF_DEBUG
     void print() const {
         MF_DEBUG("Lexicon[" << m.size() << "]:" << std::endl);
@@ -18,12 +18,84 @@
 */
 #include "markdown_tokenizer.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace m8r {
 
 using namespace std;
 
+/*
+ * Character classes of span tokenization - must be consistent w/ delimiters of CharProvider tokenization.
+ */
+enum TokenizerCharClass : unsigned char {
+    WORD_CHAR = 0,
+    DELIMITER_CHAR = 1,
+    // '-' is part of a word unless it's followed by '-' (self-awareness vs. --)
+    DASH_CHAR = 2
+};
+
+struct TokenizerCharTable {
+    unsigned char classes[256];
+    char lowercase[256];
+
+    TokenizerCharTable() {
+        for(int c=0; c<256; c++) {
+            // HIGH Unicode chars are skipped
+            classes[c] = c<128 ? WORD_CHAR : DELIMITER_CHAR;
+            lowercase[c] = static_cast<char>(c<128 ? tolower(c) : c);
+        }
+        for(unsigned char c:string{"\n\r \t!?.,:;#=`()[]*_\"'~@$%^&+{}|\\<>/"}) {
+            classes[c] = DELIMITER_CHAR;
+        }
+        classes[static_cast<unsigned char>('-')] = DASH_CHAR;
+    }
+};
+
+static const TokenizerCharTable charTable{};
+
+/**
+ * @brief Skip delimiters - whitespace runs (indentation, empty lines) are skipped by 16 bytes using SIMD.
+ */
+static inline const unsigned char* skipDelimiters(const unsigned char* p, const unsigned char* end)
+{
+    while(p<end) {
+#if defined(__SSE2__)
+        while(end-p >= 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i whitespace = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))),
+                _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\t')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\r'))));
+            if(_mm_movemask_epi8(whitespace) != 0xFFFF) {
+                break;
+            }
+            p += 16;
+        }
+#endif
+        switch(charTable.classes[*p]) {
+        case DELIMITER_CHAR:
+            p++;
+            break;
+        case DASH_CHAR:
+            if(p+1<end && p[1]=='-') {
+                p++;
+                break;
+            }
+            return p;
+        default:
+            return p;
+        }
+    }
+    return p;
+}
+
 MarkdownTokenizer::MarkdownTokenizer(Lexicon& lexicon, CommonWordsBlacklist& blacklist)
-    : lexicon(lexicon), blacklist(blacklist), stemmer{}
+    : lexicon(lexicon),
+      blacklist(blacklist),
+      stemmer{},
+      wordIdsLexiconGeneration{lexicon.getGeneration()},
+      wordIdsCapacity{Stemmer::DEFAULT_CACHE_CAPACITY}
 {
 }
 
@@ -142,8 +214,97 @@ void MarkdownTokenizer::tokenize(CharProvider& md, WordFrequencyList& wfl, bool
             break;
         }
     }
+}
 
-    lexicon.recalculateWeights();
+void MarkdownTokenizer::tokenize(const char* text, size_t length, vector<int>& ids, bool useBlacklist, bool lowercase, bool stem)
+{
+    // IDs of cleared lexicon are reassigned
+    if(wordIdsLexiconGeneration != lexicon.getGeneration()) {
+        for(unordered_map<string,int>& w:wordIds) {
+            w.clear();
+        }
+        wordIdsLexiconGeneration = lexicon.getGeneration();
+    }
+    unordered_map<string,int>& memo = wordIds[(useBlacklist?1:0)|(stem?2:0)];
+
+    // split span to words (word buffer is reused)
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+    const unsigned char* end = p+length;
+    while(p<end) {
+        p = skipDelimiters(p, end);
+
+        const unsigned char* begin = p;
+        while(p<end) {
+            unsigned char c = charTable.classes[*p];
+            if(c == WORD_CHAR || (c == DASH_CHAR && (p+1==end || p[1]!='-'))) {
+                p++;
+            } else {
+                break;
+            }
+        }
+
+        if(p-begin > 1) {
+            word.resize(p-begin);
+            for(size_t i=0; i<word.size(); i++) {
+                word[i] = lowercase ? charTable.lowercase[begin[i]] : static_cast<char>(begin[i]);
+            }
+
+            int id;
+            auto m = memo.find(word);
+            if(m != memo.end()) {
+                id = m->second;
+                if(id >= 0) {
+                    lexicon.add(id, 1);
+                }
+            } else {
+                if(wordIdsCapacity) {
+                    if(memo.size() >= wordIdsCapacity) {
+                        memo.clear();
+                    }
+                    // word is stemmed in place by wordToId()
+                    m = memo.emplace(word, -1).first;
+                    id = m->second = wordToId(word, useBlacklist, stem);
+                } else {
+                    id = wordToId(word, useBlacklist, stem);
+                }
+            }
+            if(id >= 0) {
+                ids.push_back(id);
+            }
+        }
+    }
+}
+
+int MarkdownTokenizer::wordToId(string& w, bool useBlacklist, bool stem)
+{
+    if(stem) {
+        w = stemmer.stem(w);
+    }
+    // remove common words
+    if(useBlacklist && blacklist.findWord(w)) {
+        return -1;
+    }
+    return lexicon.add(w)->id;
+}
+
+void MarkdownTokenizer::tokenize(const string& text, WordFrequencyList& wfl, bool useBlacklist, bool lowercase, bool stem)
+{
+    ids.clear();
+    tokenize(text.data(), text.size(), ids, useBlacklist, lowercase, stem);
+    wfl.add(ids);
+}
+
+void MarkdownTokenizer::tokenize(const Note* note, WordFrequencyList& wfl, bool useBlacklist, bool lowercase, bool stem)
+{
+    ids.clear();
+    const string& name = note->getName();
+    tokenize(name.data(), name.size(), ids, useBlacklist, lowercase, stem);
+    for(const string* line:note->getDescription()) {
+        if(line) {
+            tokenize(line->data(), line->size(), ids, useBlacklist, lowercase, stem);
+        }
+    }
+    wfl.add(ids);
 }
 
 void MarkdownTokenizer::handleWord(WordFrequencyList& wfl, string &w, bool stem, bool useBlacklist)
@@ -157,8 +318,7 @@ void MarkdownTokenizer::handleWord(WordFrequencyList& wfl, string &w, bool stem,
         // remove common words
         if(!useBlacklist || !blacklist.findWord(w)) {
             // increment token frequency
-            Lexicon::WordEmbedding* we = lexicon.add(w);
-            ++wfl[&(we->word)];
+            wfl.add(lexicon.add(w));
         }
     }
     w.clear();
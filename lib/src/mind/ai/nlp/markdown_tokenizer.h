@@ -20,9 +20,13 @@
 #define M8R_MARKDOWN_TOKENIZER_H
 
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "../../../debug.h"
 #include "../../../gear/lang_utils.h"
+#include "../../../model/note.h"
 #include "../../../mind/ai/nlp/common_words_blacklist.h"
 #include "char_provider.h"
 #include "lexicon.h"
@@ -41,6 +45,18 @@ namespace m8r {
  *   - stems words (optional)
  *   - computes token frequency via Lexicon
  *
+ * Text can be tokenized either as a stream of characters (CharProvider)
+ * or as contiguous spans of bytes. Span tokenization classifies characters
+ * using a lookup table, skips whitespace runs using SIMD (where available)
+ * and emits word IDs to a reusable buffer - N's name and description lines
+ * are tokenized in place w/o narrowing N to a string.
+ *
+ * Span tokenization memoizes word -> lexicon ID (stemmed, blacklist checked)
+ * so that a repeated word costs a single hash lookup instead of stemming,
+ * blacklist and lexicon lookups. Memo is bounded like stemmer's cache and it
+ * is dropped when lexicon is cleared. Blacklist must not be changed once
+ * the tokenizer is used.
+ *
  * See also:
  * https://www.ibm.com/developerworks/community/blogs/nlp/entry/tokenization?lang=en
  */
@@ -55,6 +71,15 @@ class MarkdownTokenizer
 
     Stemmer stemmer;
 
+    // reusable buffers of span tokenization
+    std::string word;
+    std::vector<int> ids;
+
+    // word -> lexicon ID (-1 if blacklisted) for every blacklist/stemming options combination
+    std::unordered_map<std::string,int> wordIds[4];
+    unsigned wordIdsLexiconGeneration;
+    size_t wordIdsCapacity;
+
 public:
     explicit MarkdownTokenizer(Lexicon& lexicon, CommonWordsBlacklist& blacklist);
     MarkdownTokenizer(const MarkdownTokenizer&) = delete;
@@ -63,11 +88,42 @@ public:
     MarkdownTokenizer &operator=(const MarkdownTokenizer&&) = delete;
     ~MarkdownTokenizer();
 
+    Stemmer& getStemmer() { return stemmer; }
+
+    /**
+     * @brief Set capacity of word -> lexicon ID memo of span tokenization (0 disables it).
+     */
+    void setWordIdsCacheCapacity(size_t capacity) {
+        wordIdsCapacity = capacity;
+        for(std::unordered_map<std::string,int>& w:wordIds) {
+            w.clear();
+        }
+    }
+
     /**
      * @brief Tokenize a stream of characters.
      */
     void tokenize(CharProvider& md, WordFrequencyList& wfl, bool useBlacklist=true, bool lowercase=true, bool stem=true);
 
+    /**
+     * @brief Tokenize a span of characters and append word IDs (in order of occurrence) to ids.
+     *
+     * Span is tokenized as if it was followed by a new line i.e. the last word is not lost.
+     */
+    void tokenize(const char* text, size_t length, std::vector<int>& ids, bool useBlacklist=true, bool lowercase=true, bool stem=true);
+
+    /**
+     * @brief Tokenize a string to word frequency list.
+     */
+    void tokenize(const std::string& text, WordFrequencyList& wfl, bool useBlacklist=true, bool lowercase=true, bool stem=true);
+
+    /**
+     * @brief Tokenize N's name and description lines to word frequency list.
+     *
+     * Result is the same as when tokenizing NoteCharProvider, but N is not copied.
+     */
+    void tokenize(const Note* note, WordFrequencyList& wfl, bool useBlacklist=true, bool lowercase=true, bool stem=true);
+
     /**
      * @brief Remove non-alpha numeric characters from the 1st word and return it.
      */
@@ -84,6 +140,7 @@ public:
     static bool isNonAlpha(char c);
 
 private:
+    int wordToId(std::string& w, bool useBlacklist, bool stem);
     inline void handleWord(WordFrequencyList& wfl, std::string &w, bool stem, bool useBlacklist);
 };
 
@@ -22,7 +22,10 @@ namespace m8r {
 
 using namespace std;
 
-Stemmer::Stemmer()
+constexpr size_t Stemmer::DEFAULT_CACHE_CAPACITY;
+
+Stemmer::Stemmer(size_t cacheCapacity)
+    : cacheCapacity{cacheCapacity}
 {
     language = ENGLISH;
 }
@@ -31,17 +34,61 @@ Stemmer::~Stemmer()
 {
 }
 
-string Stemmer::stem(string word)
+const string& Stemmer::stem(const string& word)
+{
+    auto i = cache.find(word);
+    if(i != cache.end()) {
+        return i->second;
+    }
+
+    if(cache.size() >= cacheCapacity) {
+        // IMPROVE evict cold words only (CLOCK) - now frequent words are cached again quickly
+        cache.clear();
+        if(!cacheCapacity) {
+            stemWord(word, uncached);
+            return uncached;
+        }
+    }
+    string& result = cache[word];
+    stemWord(word, result);
+    return result;
+}
+
+void Stemmer::stemWord(const string& word, string& result)
 {
     // IMPROVE: despite stemmer works in wstring mode, MindForger runs just in string mode - wstring to come later when entire application is switched
-    std::wstringstream swide;
-    swide << word.c_str();
-    wstring wide = swide.str();
+    bool ascii = true;
+    for(char c:word) {
+        if(c < 0) {
+            ascii = false;
+            break;
+        }
+    }
+
+    if(ascii) {
+        // tokenizer skips HIGH Unicode chars > widening/narrowing of ASCII is a copy
+        wide.assign(word.begin(), word.end());
+    } else {
+        std::wstringstream swide;
+        swide << word.c_str();
+        wide = swide.str();
+    }
 
     // IMPROVE switch by language (configuration)
     StemEnglish(wide);
 
-    return converter.to_bytes(wide);
+    if(ascii) {
+        result.clear();
+        for(wchar_t c:wide) {
+            if(c >= 0x80) {
+                result = converter.to_bytes(wide);
+                return;
+            }
+            result += static_cast<char>(c);
+        }
+    } else {
+        result = converter.to_bytes(wide);
+    }
 }
 
 } // m8r namespace
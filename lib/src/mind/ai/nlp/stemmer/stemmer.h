@@ -20,6 +20,7 @@
 #define M8R_STEMMER_H
 
 #include <string>
+#include <unordered_map>
 #include <iostream>
 #include <sstream>
 #include <locale>
@@ -40,6 +41,16 @@
 
 namespace m8r {
 
+/**
+ * @brief Stemmer w/ memo cache.
+ *
+ * Natural language text is Zipfian - a few words make the most of word
+ * occurrences - therefore stems are cached and stemming of a repeated
+ * word costs a hash lookup. Cache is bounded: when it gets full, it's
+ * dropped and filled again by the most frequent words. Cache is owned
+ * by stemmer instance which is used by a single thread (tokenizer) - no
+ * locking is needed.
+ */
 class Stemmer
 {
 public:
@@ -47,6 +58,8 @@ public:
         ENGLISH
     };
 
+    static constexpr size_t DEFAULT_CACHE_CAPACITY = 1<<16;
+
 private:
     Language language;
 
@@ -62,18 +75,42 @@ private:
     stemming::portuguese_stem<> StemPortuguese;
 
     std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    std::wstring wide;
+
+    // word -> stem
+    std::unordered_map<std::string,std::string> cache;
+    size_t cacheCapacity;
+    std::string uncached;
 
 public:
-    explicit Stemmer();
+    explicit Stemmer(size_t cacheCapacity=DEFAULT_CACHE_CAPACITY);
     Stemmer(const Stemmer&) = delete;
     Stemmer(const Stemmer&&) = delete;
     Stemmer &operator=(const Stemmer&) = delete;
     Stemmer &operator=(const Stemmer&&) = delete;
     ~Stemmer();
 
-    void setLanguage(Language lang) { this->language = lang; }
+    void setLanguage(Language lang) {
+        this->language = lang;
+        cache.clear();
+    }
+
+    /**
+     * @brief Set cache capacity (0 disables caching).
+     */
+    void setCacheCapacity(size_t capacity) {
+        cacheCapacity = capacity;
+        cache.clear();
+    }
+    size_t getCacheSize() const { return cache.size(); }
 
-    std::string stem(std::string word);
+    /**
+     * @brief Get stem of the word - returned reference is valid until the next call.
+     */
+    const std::string& stem(const std::string& word);
+
+private:
+    void stemWord(const std::string& word, std::string& result);
 };
 
 }
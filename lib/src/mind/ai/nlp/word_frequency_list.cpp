@@ -25,8 +25,7 @@ namespace m8r {
 using namespace std;
 
 WordFrequencyList::WordFrequencyList(Lexicon* lexicon)
-    : lexicon(lexicon),
-      wordWeightComparator{lexicon}
+    : lexicon(lexicon)
 {
     weight = UNDEF_WEIGHT;
 }
@@ -35,22 +34,75 @@ WordFrequencyList::~WordFrequencyList()
 {
 }
 
-void WordFrequencyList::sort() {
-    // reset array
-    wordsByWeight.clear();
+void WordFrequencyList::add(vector<int>& ids)
+{
+    if(ids.empty()) {
+        return;
+    }
+    weight = UNDEF_WEIGHT;
+
+    // sorted ids are run-length encoded and merged w/ doc vector (no insert per word)
+    std::sort(ids.begin(), ids.end());
+    vector<WordFrequency> added{};
+    for(int id:ids) {
+        if(added.size() && added.back().id == id) {
+            added.back().frequency++;
+        } else {
+            added.push_back(WordFrequency{id, 1});
+        }
+    }
 
-    for(auto& w:word2Frequency) {
-        wordsByWeight.push_back(&w);
+    if(words.empty()) {
+        words.swap(added);
+        return;
     }
-    std::sort(wordsByWeight.begin(),wordsByWeight.end(),wordWeightComparator);
+    vector<WordFrequency> merged{};
+    merged.reserve(words.size()+added.size());
+    auto w = words.begin();
+    auto a = added.begin();
+    while(w!=words.end() && a!=added.end()) {
+        if(w->id < a->id) {
+            merged.push_back(*w++);
+        } else if(a->id < w->id) {
+            merged.push_back(*a++);
+        } else {
+            merged.push_back(WordFrequency{w->id, w->frequency+a->frequency});
+            w++;
+            a++;
+        }
+    }
+    merged.insert(merged.end(), w, words.end());
+    merged.insert(merged.end(), a, added.end());
+    words.swap(merged);
+}
+
+void WordFrequencyList::sort(size_t relevantSize) {
+    // weights are looked up in flat array (by ID) - no lexicon lookup per comparison
+    const vector<float>& weights = lexicon->getWeights();
+
+    wordsByWeight = words;
+    std::stable_sort(
+        wordsByWeight.begin(),
+        wordsByWeight.end(),
+        [&weights](const WordFrequency& w1, const WordFrequency& w2) {
+            return weights[w1.id] > weights[w2.id];
+        });
+
+    relevantWords.assign(
+        wordsByWeight.begin(),
+        wordsByWeight.begin()+(relevantSize<wordsByWeight.size()?relevantSize:wordsByWeight.size()));
+    std::sort(
+        relevantWords.begin(),
+        relevantWords.end(),
+        [](const WordFrequency& w1, const WordFrequency& w2) { return w1.id < w2.id; });
 }
 
 float WordFrequencyList::recalculateWeight() {
     weight = 0;
-    for(auto& w:word2Frequency) {
-        Lexicon::WordEmbedding* e = lexicon->get(w.first);
+    const vector<float>& weights = lexicon->getWeights();
+    for(auto& w:words) {
         // IMPROVE if(e) result += e->weight * ((float)w.second); ... means min of weights in UNION and INTERSECTION
-        if(e) weight += e->weight;
+        if(static_cast<size_t>(w.id) < weights.size()) weight += weights[w.id];
     }
     return weight;
 }
@@ -19,7 +19,8 @@
 #ifndef M8R_WORD_FREQUENCY_LIST_H
 #define M8R_WORD_FREQUENCY_LIST_H
 
-#include <map>
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -35,65 +36,62 @@ namespace m8r {
 /**
  * @brief Word frequency list for a doc.
  *
+ * Document vector is sparse - (word ID, frequency) pairs sorted by word ID,
+ * therefore operations on two vectors (intersection, union, similarity) are
+ * merge-joins w/o lookups and allocations.
+ *
  * See:
  *   https://en.wikipedia.org/wiki/Word_lists_by_frequency
  */
 class WordFrequencyList
 {
-    struct WordWeightComparator
-    {
-        Lexicon *l;
-        WordWeightComparator(Lexicon* l) : l(l) {}
-
-        // functor to compare words by weight
-        bool operator()(
-                const std::pair<const std::string* const,int>*const& p1,
-                const std::pair<const std::string* const,int>*const& p2
-        ) {
-            return l->get(p1->first)->weight > l->get(p2->first)->weight;
-        }
-    };
-
 public:
     static constexpr float UNDEF_WEIGHT = -1;
 
+    struct WordFrequency {
+        int id;
+        int frequency;
+    };
+
     static void evalUnion(WordFrequencyList& l1, WordFrequencyList& l2, WordFrequencyList& u)
     {
-        // IMPROVE u.iterable().insert(l1.iterable().begin(),l1.iterable().end());
         for(auto& e:l1.iterable()) {
-            u.add(e.first);
+            u.add(e.id);
         }
 
         for(auto& e:l2.iterable()) {
-            u.add(e.first);
+            u.add(e.id);
         }
     }
 
     static void evalIntersection(WordFrequencyList& l1, WordFrequencyList& l2, WordFrequencyList& u)
     {
-        // IMPROVE u.iterable().insert(l1.iterable().begin(),l1.iterable().end());
         for(auto& e:l1.iterable()) {
-            if(l2.contains(e.first)) {
-                u.add(e.first);
+            if(l2.contains(e.id)) {
+                u.add(e.id);
             }
         }
     }
 
 private:
     Lexicon* lexicon;
-    WordWeightComparator wordWeightComparator;
 
     float weight;
 
     /**
-     * @brief List of words occuring in a Thing ordered by weight.
+     * @brief Document vector - words occuring in a Thing sorted by word ID.
+     */
+    std::vector<WordFrequency> words;
+
+    /**
+     * @brief Words ordered by weight (descending) - built by sort().
      */
-    std::vector<std::pair<const std::string *const,int>*> wordsByWeight;
+    std::vector<WordFrequency> wordsByWeight;
 
     /**
-     * @brief TRANSIENT map used for quick inserts (can be cleared once list is built).
+     * @brief The most relevant words (w/ highest weight) sorted by word ID - built by sort().
      */
-    std::map<const std::string*,int> word2Frequency;
+    std::vector<WordFrequency> relevantWords;
 
 public:
     explicit WordFrequencyList(Lexicon* lexicon);
@@ -103,9 +101,9 @@ public:
     WordFrequencyList &operator=(const WordFrequencyList&&) = delete;
     ~WordFrequencyList();
 
-    int& operator[](std::string* key) { return word2Frequency[key]; }
-    size_t size() const { return word2Frequency.size(); }
-    const std::map<const std::string*,int>& iterable() const { return word2Frequency; }
+    size_t size() const { return words.size(); }
+    const std::vector<WordFrequency>& iterable() const { return words; }
+    const std::vector<WordFrequency>& getRelevantWords() const { return relevantWords; }
 
     float getWeight() {
         if(weight==UNDEF_WEIGHT) {
@@ -115,52 +113,73 @@ public:
         }
     }
 
-    int contains(const std::string* word) {
-        std::map<const std::string*,int>::iterator i = word2Frequency.find(word);
-        if(i != word2Frequency.end()) {
-            return true;
-        } else {
-            return false;
-        }
+    bool contains(int id) const {
+        auto i = std::lower_bound(words.begin(), words.end(), id, idComparator);
+        return i != words.end() && i->id == id;
     }
 
-    int add(const std::string* word) {
+    /**
+     * @brief Increment word frequency.
+     *
+     * Doc vectors are short (unique words of a Thing), therefore binary search
+     * and insert to sorted vector is cheaper than maintenance of a map.
+     */
+    int add(int id) {
         weight = UNDEF_WEIGHT;
 
-        std::map<const std::string*,int>::iterator i = word2Frequency.find(word);
-        if(i != word2Frequency.end()) {
-            ++i->second;
-            return word2Frequency[word];
+        auto i = std::lower_bound(words.begin(), words.end(), id, idComparator);
+        if(i != words.end() && i->id == id) {
+            return ++i->frequency;
         } else {
-            word2Frequency[word] = 1;
+            words.insert(i, WordFrequency{id, 1});
             return 1;
         }
     }
+    int add(const Lexicon::WordEmbedding* word) {
+        return add(word->id);
+    }
+
+    /**
+     * @brief Increment frequencies of words (tokenizer output) - ids are sorted in place.
+     */
+    void add(std::vector<int>& ids);
 
-    void set(const std::string* word, int frequency) {
-        word2Frequency[word] = frequency;
+    /**
+     * @brief Append word w/ frequency - words must be appended in ascending ID order (restored doc).
+     */
+    void append(int id, int frequency) {
+        weight = UNDEF_WEIGHT;
+        words.push_back(WordFrequency{id, frequency});
     }
 
     /**
-     * @brief Sort words by weight.
+     * @brief Sort words by weight and pick relevant words.
+     *
+     * Lexicon weights must be calculated.
+     *
+     * @param relevantSize  number of words w/ the highest weight to be used as relevant words.
      */
-    void sort();
+    void sort(size_t relevantSize=SIZE_MAX);
 
     /**
      * @brief Get weight of vector words.
      */
     float recalculateWeight();
 
+private:
+    static bool idComparator(const WordFrequency& wf, int id) { return wf.id < id; }
+
+public:
 #ifdef DO_MF_DEBUG
     void print() const {
-        std::cout << "WordFrequencyList[" << word2Frequency.size() << "]:" << std::endl;
+        std::cout << "WordFrequencyList[" << words.size() << "]:" << std::endl;
         for(auto& w:wordsByWeight) {
-            std::cout << "  " << (*w->first) << " [" << w->second << "] " << std::endl;
+            std::cout << "  " << lexicon->get(w.id)->word << " [" << w.frequency << "] " << std::endl;
         }
     }
     void printFlat() const {
         for(auto& w:wordsByWeight) {
-            std::cout << (*w->first) << " [" << w->second << "] ";
+            std::cout << lexicon->get(w.id)->word << " [" << w.frequency << "] ";
         }
     }
 #endif
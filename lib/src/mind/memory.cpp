@@ -18,6 +18,8 @@
  */
 #include "memory.h"
 
+#include <iostream>
+
 #include "../gear/string_utils.h"
 
 using namespace std;
@@ -56,6 +58,9 @@ vector<Stencil*>& Memory::getStencils(ResourceType type)
 
 void Memory::learn()
 {
+    // barrier: Os saved in background must be written before they are (re)loaded
+    flush();
+
     aware = true;
 
     repositoryIndexer.index(config.getActiveRepository());
@@ -255,11 +260,39 @@ void Memory::remember(Outline* outline)
     }
 }
 
+bool Memory::flush(vector<string>* failedOutlineKeys)
+{
+    vector<string> failed{};
+    if(persistence->flush(&failed)) {
+        return true;
+    }
+
+    for(const string& k:failed) {
+        cerr << "Error: unable to write Outline '" << k << "' - changes were NOT saved" << endl;
+        Outline* o = getOutline(k);
+        if(o) {
+            o->makeDirty();
+        }
+    }
+    if(failedOutlineKeys) {
+        failedOutlineKeys->insert(failedOutlineKeys->end(), failed.begin(), failed.end());
+    }
+    return false;
+}
+
 void Memory::exportToHtml(Outline* outline, const string& fileName)
 {
     persistence->saveAsHtml(outline, fileName);
 }
 
+bool Memory::exportToHtml(
+        const string& directory,
+        bool incremental,
+        ProgressCallbackCtx* callbackCtx)
+{
+    return persistence->saveAsHtml(outlines, directory, incremental, callbackCtx);
+}
+
 void Memory::exportToCsv(
         const string& fileName,
         map<const Tag*,int>& tagsCardinality,
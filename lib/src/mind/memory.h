@@ -142,11 +142,36 @@ public:
      */
     void remember(Outline* outline);
 
+    /**
+     * @brief Barrier - wait until remembered Os are written (they are saved in background).
+     *
+     * Os which could not be written are made dirty again (unsaved) and reported.
+     *
+     * @param failedOutlineKeys Keys of Os which could not be written are appended
+     *        to this vector (if not nullptr).
+     * @return `false` if some O could not be written, `true` otherwise.
+     */
+    bool flush(std::vector<std::string>* failedOutlineKeys=nullptr);
+
     /**
      * @brief Export Outline to HTML.
      */
     void exportToHtml(Outline* outline, const std::string& fileName);
 
+    /**
+     * @brief Export all Os to HTML files in the directory.
+     *
+     * Os are rendered in parallel, links among Os are rewritten to relative
+     * .html links. Incremental export skips Os unchanged since the last export.
+     *
+     * @return `false` if some O(s) could not be exported.
+     */
+    bool exportToHtml(
+        const std::string& directory,
+        bool incremental=false,
+        ProgressCallbackCtx* callbackCtx = nullptr
+    );
+
     /**
      * @brief Export memory to CSV.
      */
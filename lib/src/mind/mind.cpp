@@ -48,10 +48,12 @@ Mind::Mind(Configuration &configuration)
       exclusiveMind{},
       timeScopeAspect{},
       tagsScopeAspect{ontology},
-      scopeAspect{timeScopeAspect, tagsScopeAspect}
+      scopeAspect{timeScopeAspect, tagsScopeAspect},
+      thingsIndex{configuration, scopeAspect}
 {
     ai = new Ai{memory,*this};
     deleteWatermark = 0;
+    generation = 0;
     activeProcesses = 0;
     associationsSemaphore = 0;
 
@@ -95,6 +97,7 @@ bool Mind::learn()
         MF_DEBUG("Learning..." << endl);
         mindAmnesia();
         memory.learn();
+        thingsIndex.learn(memory.getOutlines());
 #ifdef MF_MD_2_HTML_CMARK
         autolinking->reindex();
 #endif
@@ -112,17 +115,9 @@ shared_future<bool> Mind::think()
     lock_guard<mutex> criticalSection{exclusiveMind};
 
     if(config.getMindState()==Configuration::MindState::SLEEPING) {
-        if(config.getAsyncMindThreshold() > memory.getNotesCount()) {
-            // get ready for thinking - dream() changes state to THINKING on its finish
-            return mindDream();
-        } else {
-            // IMPROVE design ASYNC AI/AA to handle also huge repositories
-            MF_DEBUG("Think: CANNOT think because number of Notes in Mind is too big" << endl);
-            persistMindState(Configuration::MindState::SLEEPING);
-            promise<bool> p;
-            p.set_value(false);
-            return p.get_future();
-        }
+        // get ready for thinking - dream() changes state to THINKING on its finish
+        // (AA keeps top-k associations per N only, dream() goes ASYNC above the threshold)
+        return mindDream();
     } else {
         MF_DEBUG("Think: CANNOT think because Mind is DREAMING or already THINKING (asleep first)" << endl);
         promise<bool> p;
@@ -253,6 +248,8 @@ bool Mind::mindAmnesia()
 
         // forget EVERYTHING
         memory.amnesia();
+        generation++;
+        thingsIndex.clear();
 #ifdef MF_MD_2_HTML_CMARK
         autolinking->clear();
 #endif
@@ -268,19 +265,30 @@ bool Mind::mindAmnesia()
  * Autolinking
  */
 
-void Mind::autolinkUpdate(const std::string& oldName, const std::string& newName) const
+bool Mind::autolinkFindLongestPrefixWord(std::string& s, std::string& r) const
 {
 #ifdef MF_MD_2_HTML_CMARK
-    autolinking->update(oldName, newName);
+    return autolinking->getIndex()->findLongestPrefixWord(s, r);
+#else
+    UNUSED_ARG(s);
+    UNUSED_ARG(r);
+    return false;
 #endif
 }
 
-bool Mind::autolinkFindLongestPrefixWord(std::string& s, std::string& r) const
+std::shared_ptr<const AutolinkingIndex> Mind::autolinkGetIndex() const
 {
 #ifdef MF_MD_2_HTML_CMARK
-    return autolinking->findLongestPrefixWord(s, r);
+    return autolinking->getIndex();
 #else
-    return false;
+    return nullptr;
+#endif
+}
+
+void Mind::autolinkWaitForIndex()
+{
+#ifdef MF_MD_2_HTML_CMARK
+    autolinking->waitForRebuild();
 #endif
 }
 
@@ -292,37 +300,47 @@ bool Mind::autolinkFindLongestPrefixWord(std::string& s, std::string& r) const
 void Mind::remember(const std::string& outlineKey)
 {
     memory.remember(outlineKey);
+    thingsIndex.remember(memory.getOutline(outlineKey));
+    mindRemember(memory.getOutline(outlineKey));
 
     // TODO onRemembering()
 
 #ifdef MF_MD_2_HTML_CMARK
-    if(config.isAutolinking()) {
-        autolinking->reindex();
-    }
+    autolinking->remember(memory.getOutline(outlineKey));
 #endif
 }
 
 void Mind::remember(Outline* outline)
 {
     memory.remember(outline);
+    thingsIndex.remember(outline);
+    mindRemember(outline);
 
 #ifdef MF_MD_2_HTML_CMARK
-    if(config.isAutolinking()) {
-        autolinking->reindex();
-    }
+    autolinking->remember(outline);
 #endif
 }
 
+void Mind::mindRemember(Outline* outline)
+{
+    lock_guard<mutex> criticalSection{exclusiveMind};
+
+    if(config.getMindState()==Configuration::MindState::THINKING) {
+        ai->remember(outline);
+    }
+    generation++;
+}
+
 void Mind::forget(Outline* outline)
 {
     memory.forget(outline);
+    thingsIndex.forget(outline);
+    generation++;
 
     // TODO onRemembering()
 
 #ifdef MF_MD_2_HTML_CMARK
-    if(config.isAutolinking()) {
-        autolinking->reindex();
-    }
+    autolinking->forget(outline);
 #endif
 }
 
@@ -553,89 +571,10 @@ void Mind::getAllThings(
     vector<string>* thingsNames,
     string* pattern,
     ThingNameSerialization as,
-    Outline* currentO)
+    Outline* currentO,
+    int limit)
 {
-    const vector<Outline*>& os = getOutlines();
-    for(Outline* o:os) {
-        if((pattern && stringStartsWith(o->getName(), *pattern))
-              ||
-            pattern==nullptr)
-        {
-            things.push_back(o);
-            if(thingsNames) {
-                string s{};
-                switch(as) {
-                case ThingNameSerialization::LINK:
-                    // IMPROVE make this Note's method
-                    {
-                        s += "[";
-                        s += o->getName();
-                        s += "](";
-                        string p = RepositoryIndexer::makePathRelative(
-                             config.getActiveRepository(),
-                             currentO?currentO->getKey():o->getKey(),
-                             o->getKey());
-                        pathToLinuxDelimiters(p, p);
-                        s += p;
-                        s += ")";
-                        break;
-                    }
-                case ThingNameSerialization::NAME:
-                case ThingNameSerialization::SCOPED_NAME:
-                default:
-                    s += o->getName();
-                    break;
-                }
-                thingsNames->push_back(s);
-            }
-        }
-    }
-    vector<Note*> ns{};
-    getAllNotes(ns);
-    for(Note* n:ns) {
-        if((pattern && stringStartsWith(n->getName(), *pattern))
-              ||
-            pattern==nullptr)
-        {
-            things.push_back(n);
-            if(thingsNames) {
-                string s{};
-                switch(as) {
-                case ThingNameSerialization::NAME:
-                    s += n->getName();
-                    break;
-                case ThingNameSerialization::LINK:
-                    // IMPROVE make this Note's method
-                    {
-                        s += "[";
-                        s += n->getName();
-                        s += " (";
-                        s += n->getOutline()->getName();
-                        s += ")](";
-                        string p = RepositoryIndexer::makePathRelative(
-                             config.getActiveRepository(),
-                             currentO?currentO->getKey():n->getOutline()->getKey(),
-                             n->getKey());
-                        pathToLinuxDelimiters(p, p);
-                        s += p;
-                        s += ")";
-                        break;
-                    }
-                case ThingNameSerialization::SCOPED_NAME:
-                default:
-                    {
-                        // IMPROVE make this Note's method: getScopedName()
-                        s += n->getName();
-                        s += " (";
-                        s += n->getOutline()->getName();
-                        s += ")";
-                        break;
-                    }
-                }
-                thingsNames->push_back(s);
-            }
-        }
-    }
+    thingsIndex.find(things, thingsNames, pattern, as, currentO, limit);
 }
 
 const vector<Outline*>& Mind::getOutlines() const
@@ -928,7 +867,13 @@ Outline* Mind::outlineClone(const std::string& outlineKey)
         Outline* clonedOutline = new Outline{*o};
         clonedOutline->setKey(memory.createOutlineKey(&o->getName()));
         memory.remember(clonedOutline);
+        thingsIndex.remember(clonedOutline);
+        generation++;
         onRemembering();
+
+#ifdef MF_MD_2_HTML_CMARK
+        autolinking->remember(clonedOutline);
+#endif
         return clonedOutline;
     } else {
         return nullptr;
@@ -944,6 +889,9 @@ bool Mind::outlineForget(string outlineKey)
         forget(o);
         auto k = memory.createLimboKey(&o->getName());
         o->setKey(k);
+        // barrier: pending write would recreate O file after it is moved to limbo
+        // (Os which could not be written are made dirty and reported by memory)
+        memory.flush();
         moveFile(outlineKey, k);
         return true;
     }
@@ -987,6 +935,8 @@ Note* Mind::noteNew(
         n->setModifiedPretty();
 
         o->addNote(n, NO_PARENT==offset?0:offset);
+        thingsIndex.remember(o);
+        generation++;
         return n;
     } else {
         throw MindForgerException("Outline for given key not found!");
@@ -997,7 +947,10 @@ Note* Mind::noteClone(const string& outlineKey, const Note* newNote, const bool
 {
     Outline* o = memory.getOutline(outlineKey);
     if(o) {
-        return o->cloneNote(newNote, deep);
+        Note* clonedNote = o->cloneNote(newNote, deep);
+        thingsIndex.remember(o);
+        generation++;
+        return clonedNote;
     } else {
         throw MindForgerException("Outline for given key not found!");
     }
@@ -1021,7 +974,16 @@ Outline* Mind::noteRefactor(Note* noteToRefactor, const string& targetOutlineKey
 
             memory.remember(sourceOutline);
             memory.remember(targetOutline);
+            thingsIndex.remember(sourceOutline);
+            thingsIndex.remember(targetOutline);
+            // moved Ns are learned by AI w/ new O
+            mindRemember(sourceOutline);
+            mindRemember(targetOutline);
 
+#ifdef MF_MD_2_HTML_CMARK
+            autolinking->remember(sourceOutline);
+            autolinking->remember(targetOutline);
+#endif
             return targetOutline;
         } else {
             throw MindForgerException("Outline for given key not found!");
@@ -1038,6 +1000,8 @@ Outline* Mind::noteForget(Note* note)
         deleteWatermark++;
 
         note->getOutline()->forgetNote(note);
+        thingsIndex.remember(o);
+        generation++;
         return o;
     } else {
         throw MindForgerException("Unable find Outline from which should be the Note deleted!");
@@ -1086,13 +1050,6 @@ void Mind::noteDemote(Note* note, Outline::Patch* patch)
     }
 }
 
-void Mind::noteOnRename(const std::string& oldName, const std::string& newName)
-{
-#ifdef MF_MD_2_HTML_CMARK
-    autolinking->update(oldName, newName);
-#endif
-}
-
 void Mind::onRemembering()
 {
     allNotesCache.clear();
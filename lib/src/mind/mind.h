@@ -20,6 +20,7 @@
 #define M8R_MIND_H_
 
 #include <inttypes.h>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <regex>
@@ -28,6 +29,7 @@
 #include "knowledge_graph.h"
 #include "ai/ai.h"
 #include "associated_notes.h"
+#include "things_completion_index.h"
 #include "ontology/thing_class_rel_triple.h"
 #include "aspect/mind_scope_aspect.h"
 #include "../config/configuration.h"
@@ -42,6 +44,7 @@ namespace m8r {
 class Ai;
 class KnowledgeGraph;
 class AutolinkingMind;
+class AutolinkingIndex;
 
 constexpr auto NO_PARENT = 0xFFFF;
 
@@ -61,12 +64,6 @@ struct MindStatistics {
     const Tag* mostUsedTag;
 };
 
-enum class ThingNameSerialization {
-    NAME,
-    SCOPED_NAME,
-    LINK
-};
-
 /**
  * @brief Mind.
  *
@@ -167,9 +164,19 @@ private:
     int deleteWatermark;
 
     /**
-     * @brief Active mental processes.
+     * @brief Generation is incremented on every change of memory: O/N is remembered,
+     * created, moved or deleted.
+     *
+     * Components key their caches on generation and N revisions: when generation
+     * doesn't change, cached results are valid (O(1) check), otherwise only entries
+     * affected by the change are evicted.
+     */
+    std::atomic<u_int32_t> generation;
+
+    /**
+     * @brief Active mental processes (inc/dec also by AI threads).
      */
-    int activeProcesses;
+    std::atomic<int> activeProcesses;
 
     /**
      * @brief Need for associations.
@@ -230,6 +237,11 @@ private:
      */
     MindScopeAspect scopeAspect;
 
+    /**
+     * @brief O/N names index for link completion and Find dialogs.
+     */
+    ThingsCompletionIndex thingsIndex;
+
 public:
     explicit Mind(Configuration &config);
     Mind() = delete;
@@ -242,6 +254,7 @@ public:
     HtmlOutlineRepresentation* getHtmlRepresentation() { return &htmlRepresentation; }
 
     int getDeleteWatermark() const { return deleteWatermark; }
+    u_int32_t getGeneration() const { return generation; }
 
     /**
      * @brief Synchronize both desired and current state and persist it.
@@ -298,8 +311,17 @@ public:
      * Autolinking
      */
 
-    void autolinkUpdate(const std::string& oldName, const std::string& newName) const;
     bool autolinkFindLongestPrefixWord(std::string& s, std::string& r) const;
+    /**
+     * @brief Get immutable autolinking index snapshot (null if autolinking is not available).
+     *
+     * Snapshot can be used from any thread - index updates are published as new snapshots.
+     */
+    std::shared_ptr<const AutolinkingIndex> autolinkGetIndex() const;
+    /**
+     * @brief Wait until autolinking index compiled in background (if any) is published.
+     */
+    void autolinkWaitForIndex();
 
     /*
      * Knowledge graph
@@ -469,12 +491,18 @@ public:
      * TYPES
      */
 
+    /**
+     * @brief Get Os and Ns whose name starts with pattern (all if nullptr) sorted by name.
+     *
+     * Things are served from the completion index maintained on O/N create/rename/forget.
+     */
     void getAllThings(
             std::vector<Thing*>& things,
             std::vector<std::string>* thingsNames=nullptr,
             std::string* pattern=nullptr,
             ThingNameSerialization as=ThingNameSerialization::SCOPED_NAME,
-            Outline* currentO=nullptr);
+            Outline* currentO=nullptr,
+            int limit=ALL_ENTRIES);
     // IMPROVE rename to getAllOs()
     const std::vector<Outline*>& getOutlines() const;
     std::vector<Outline*>* getOutlinesOfType(const OutlineType& type) const;
@@ -637,11 +665,6 @@ public:
             std::string fromOutlineKey,
             uint16_t fromNoteId);
 
-    /**
-     * @brief Actions to perform on N rename.
-     */
-    void noteOnRename(const std::string& oldName, const std::string& newName);
-
     /*
      * DIAGNOSTICS
      */
@@ -678,6 +701,11 @@ private:
     bool mindSleep();
     bool mindAmnesia();
 
+    /**
+     * @brief Let AI learn remembered O incrementally (if thinking).
+     */
+    void mindRemember(Outline* outline);
+
     /**
      * @brief Invoked on remembering Outline/Note/... to flush all inferred knowledge, caches, ...
      */
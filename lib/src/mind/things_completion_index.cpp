@@ -0,0 +1,178 @@
+/*
+ things_completion_index.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "things_completion_index.h"
+
+#include <algorithm>
+
+#include "../repository_indexer.h"
+#include "../gear/file_utils.h"
+
+namespace m8r {
+
+using namespace std;
+
+ThingsCompletionIndex::ThingsCompletionIndex(Configuration& config, const MindScopeAspect& scope)
+    : config(config),
+      scope(scope)
+{
+}
+
+ThingsCompletionIndex::~ThingsCompletionIndex()
+{
+}
+
+void ThingsCompletionIndex::addOutlineEntries(Outline* outline, vector<Entry>& batch)
+{
+    Entry oe{};
+    oe.thing = outline;
+    oe.outline = outline;
+    oe.isOutline = true;
+    oe.name = outline->getName();
+    oe.scopedName = outline->getName();
+    batch.push_back(std::move(oe));
+
+    for(Note* n:outline->getNotes()) {
+        Entry ne{};
+        ne.thing = n;
+        ne.outline = outline;
+        ne.isOutline = false;
+        ne.name = n->getName();
+        ne.scopedName.reserve(n->getName().size() + outline->getName().size() + 3);
+        ne.scopedName += n->getName();
+        ne.scopedName += " (";
+        ne.scopedName += outline->getName();
+        ne.scopedName += ")";
+        batch.push_back(std::move(ne));
+    }
+}
+
+void ThingsCompletionIndex::learn(const vector<Outline*>& outlines)
+{
+    entries.clear();
+    for(Outline* o:outlines) {
+        addOutlineEntries(o, entries);
+    }
+    std::stable_sort(entries.begin(), entries.end());
+
+    MF_DEBUG("Things completion index: " << entries.size() << " entries" << endl);
+}
+
+void ThingsCompletionIndex::remember(Outline* outline)
+{
+    if(outline) {
+        forget(outline);
+
+        // merge sorted O batch into the sorted index ~ O(N) instead of N*log(N) re-sort
+        vector<Entry> batch{};
+        addOutlineEntries(outline, batch);
+        std::stable_sort(batch.begin(), batch.end());
+
+        size_t middle = entries.size();
+        entries.insert(
+            entries.end(),
+            std::make_move_iterator(batch.begin()),
+            std::make_move_iterator(batch.end()));
+        std::inplace_merge(entries.begin(), entries.begin()+middle, entries.end());
+    }
+}
+
+void ThingsCompletionIndex::forget(const Outline* outline)
+{
+    // O's Ns might be already deallocated > match by O only, don't touch Things
+    entries.erase(
+        std::remove_if(
+            entries.begin(),
+            entries.end(),
+            [outline](const Entry& e) { return e.outline == outline; }),
+        entries.end());
+}
+
+const string& ThingsCompletionIndex::getLink(Entry& e, Outline* currentO)
+{
+    const string& baseKey = currentO?currentO->getKey():e.outline->getKey();
+    if(e.link.empty() || e.linkBaseKey != baseKey) {
+        e.linkBaseKey = baseKey;
+        string p = RepositoryIndexer::makePathRelative(
+            config.getActiveRepository(),
+            baseKey,
+            e.thing->getKey());
+        pathToLinuxDelimiters(p, p);
+
+        e.link.clear();
+        e.link += "[";
+        e.link += e.scopedName;
+        e.link += "](";
+        e.link += p;
+        e.link += ")";
+    }
+    return e.link;
+}
+
+void ThingsCompletionIndex::find(
+        vector<Thing*>& things,
+        vector<string>* thingsNames,
+        const string* prefix,
+        ThingNameSerialization as,
+        Outline* currentO,
+        int limit)
+{
+    vector<Entry>::iterator it;
+    if(prefix) {
+        Entry key{};
+        key.name = *prefix;
+        it = std::lower_bound(entries.begin(), entries.end(), key);
+    } else {
+        it = entries.begin();
+    }
+
+    bool scoped = scope.isEnabled();
+    int found = 0;
+    for(; it != entries.end() && (limit == ALL_ENTRIES || found < limit); ++it) {
+        if(prefix && !stringStartsWith(it->name, *prefix)) {
+            // sorted ~ no more matches
+            break;
+        }
+        if(scoped) {
+            if(it->isOutline) {
+                if(!scope.isInScope(it->outline)) continue;
+            } else {
+                if(!scope.isInScope(static_cast<Note*>(it->thing))) continue;
+            }
+        }
+
+        things.push_back(it->thing);
+        if(thingsNames) {
+            switch(as) {
+            case ThingNameSerialization::NAME:
+                thingsNames->push_back(it->name);
+                break;
+            case ThingNameSerialization::LINK:
+                thingsNames->push_back(getLink(*it, currentO));
+                break;
+            case ThingNameSerialization::SCOPED_NAME:
+            default:
+                thingsNames->push_back(it->scopedName);
+                break;
+            }
+        }
+        found++;
+    }
+}
+
+} // m8r namespace
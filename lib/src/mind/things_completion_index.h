@@ -0,0 +1,127 @@
+/*
+ things_completion_index.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_THINGS_COMPLETION_INDEX_H
+#define M8R_THINGS_COMPLETION_INDEX_H
+
+#include <string>
+#include <vector>
+
+#include "../model/outline.h"
+#include "../model/note.h"
+#include "../config/configuration.h"
+#include "aspect/mind_scope_aspect.h"
+
+namespace m8r {
+
+enum class ThingNameSerialization {
+    NAME,
+    SCOPED_NAME,
+    LINK
+};
+
+/**
+ * @brief Things completion index.
+ *
+ * Persistent index of O and N names used by link completion and Find
+ * dialogs. Entries are kept in a vector sorted by name so that a prefix
+ * query is a binary search followed by a linear scan of matching entries.
+ * Scoped names (N name w/ O name suffix) are precomputed on (re)index, relative
+ * links are computed lazily on the first query and cached for the O they were
+ * computed for (link completion typically asks repeatedly for the same O).
+ *
+ * The index is maintained per O: when an O is remembered, its entries are
+ * dropped and re-added, when it's forgotten its entries are dropped.
+ */
+class ThingsCompletionIndex
+{
+public:
+    static constexpr int ALL_ENTRIES = -1;
+
+private:
+    struct Entry {
+        Thing* thing;
+        // O owning the N or O itself
+        Outline* outline;
+        bool isOutline;
+        std::string name;
+        std::string scopedName;
+        // lazily computed link + key of the O the link is relative to
+        std::string linkBaseKey;
+        std::string link;
+
+        bool operator<(const Entry& e) const { return name < e.name; }
+    };
+
+    Configuration& config;
+    const MindScopeAspect& scope;
+
+    std::vector<Entry> entries;
+
+public:
+    explicit ThingsCompletionIndex(Configuration& config, const MindScopeAspect& scope);
+    ThingsCompletionIndex(const ThingsCompletionIndex&) = delete;
+    ThingsCompletionIndex(const ThingsCompletionIndex&&) = delete;
+    ThingsCompletionIndex& operator=(const ThingsCompletionIndex&) = delete;
+    ThingsCompletionIndex& operator=(const ThingsCompletionIndex&&) = delete;
+    ~ThingsCompletionIndex();
+
+    size_t size() const { return entries.size(); }
+
+    /**
+     * @brief Rebuild the index from scratch.
+     */
+    void learn(const std::vector<Outline*>& outlines);
+
+    /**
+     * @brief Drop all entries.
+     */
+    void clear() { entries.clear(); }
+
+    /**
+     * @brief (Re)index O and its Ns - on O/N create, rename, N forget, ...
+     */
+    void remember(Outline* outline);
+
+    /**
+     * @brief Drop O and its Ns from the index.
+     */
+    void forget(const Outline* outline);
+
+    /**
+     * @brief Find Things whose name starts with the prefix (all Things if prefix is nullptr).
+     *
+     * Matches are returned sorted by name - Os and Ns are interleaved (not Os
+     * followed by Ns). If Mind scope is enabled, both Os and Ns out of scope are
+     * skipped. Limit restricts the number of results to the first (by name) matches.
+     */
+    void find(
+            std::vector<Thing*>& things,
+            std::vector<std::string>* thingsNames,
+            const std::string* prefix,
+            ThingNameSerialization as,
+            Outline* currentO,
+            int limit=ALL_ENTRIES);
+
+private:
+    void addOutlineEntries(Outline* outline, std::vector<Entry>& batch);
+    const std::string& getLink(Entry& e, Outline* currentO);
+};
+
+}
+#endif // M8R_THINGS_COMPLETION_INDEX_H
@@ -17,6 +17,7 @@
  along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 #include "filesystem_persistence.h"
+#include "html_repository_export.h"
 
 #include <sys/stat.h>
 
@@ -73,6 +74,9 @@ string FilesystemPersistence::createFileName(
     const string* text,
     const string& extension
 ) {
+    // barrier: files of saved Os must exist so that the new name doesn't clash w/ them
+    writeBehindQueue.wait();
+
     return FilesystemPersistence::getUniqueDirOrFileName(
         directory, text, extension
     );
@@ -101,18 +105,18 @@ void FilesystemPersistence::save(Outline* outline)
     string* text = mdRepresentation.to(outline);
     if(text!=nullptr) {
         MF_DEBUG("Saving O: " << outline->getKey() << endl);
-        ofstream out(outline->getKey());
-        MF_DEBUG("  O opened: " << boolalpha << out.is_open() << endl);
-        out << *text;
-        MF_DEBUG("  O written: " << &out << endl);
-        out.close();
-        MF_DEBUG("O saved: " << &out << endl);
-        delete text;
+        // queue takes ownership of the text
+        writeBehindQueue.write(outline->getKey(), text);
 
         outline->clearDirty();
     }
 }
 
+bool FilesystemPersistence::flush(vector<string>* failedOutlineKeys)
+{
+    return writeBehindQueue.flush(failedOutlineKeys);
+}
+
 void FilesystemPersistence::saveAsHtml(Outline* outline, const string& fileName)
 {
     string* text = new string{};
@@ -130,4 +134,20 @@ void FilesystemPersistence::saveAsHtml(Outline* outline, const string& fileName)
     delete text;
 }
 
+bool FilesystemPersistence::saveAsHtml(
+    const vector<Outline*>& outlines,
+    const string& directory,
+    bool incremental,
+    ProgressCallbackCtx* callbackCtx
+) {
+    HtmlRepositoryExport htmlExport{htmlRepresentation};
+    return htmlExport.to(
+        outlines,
+        Configuration::getInstance().getMemoryPath(),
+        directory,
+        incremental,
+        callbackCtx
+    );
+}
+
 } // m8r namespace
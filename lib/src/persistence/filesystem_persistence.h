@@ -26,6 +26,7 @@
 #include "../model/stencil.h"
 #include "../representations/markdown/markdown_outline_representation.h"
 #include "../representations/html/html_outline_representation.h"
+#include "write_behind_queue.h"
 
 namespace m8r {
 
@@ -35,6 +36,9 @@ private:
     MarkdownOutlineRepresentation& mdRepresentation;
     HtmlOutlineRepresentation& htmlRepresentation;
 
+    // Os are serialized by the caller and written (atomically) in background
+    WriteBehindQueue writeBehindQueue;
+
 public:
 
     static std::string getUniqueDirOrFileName(
@@ -70,8 +74,22 @@ public:
      * @return `false` if read-only, else `true`.
      */
     bool isWriteable(const std::string& outlineKey);
+    /**
+     * @brief Save O - O is serialized immediately, file is written in background.
+     *
+     * Repeated saves of O which is still waiting for the writer are coalesced.
+     */
     virtual void save(Outline* outline);
+    virtual bool flush(std::vector<std::string>* failedOutlineKeys=nullptr);
     virtual void saveAsHtml(Outline* o, const std::string& fileName);
+    /**
+     * @brief Export Os to HTML files in the directory (in parallel).
+     */
+    virtual bool saveAsHtml(
+            const std::vector<Outline*>& outlines,
+            const std::string& directory,
+            bool incremental,
+            ProgressCallbackCtx* callbackCtx);
 };
 
 }
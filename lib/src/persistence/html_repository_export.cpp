@@ -0,0 +1,456 @@
+/*
+ html_repository_export.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "html_repository_export.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "../config/configuration.h"
+#include "../gear/file_utils.h"
+
+namespace m8r {
+
+using namespace std;
+
+constexpr size_t HtmlRepositoryExport::WRITE_QUEUE_CAPACITY;
+
+HtmlRepositoryExport::HtmlRepositoryExport(HtmlOutlineRepresentation& htmlRepresentation)
+    : htmlRepresentation(htmlRepresentation),
+      pool{},
+      exportedCount{0},
+      skippedCount{0},
+      failedCount{0}
+{
+}
+
+HtmlRepositoryExport::~HtmlRepositoryExport()
+{
+}
+
+string HtmlRepositoryExport::normalizePath(const string& path)
+{
+    vector<string> segments{};
+    size_t begin = 0;
+    while(begin <= path.size()) {
+        size_t end = path.find('/', begin);
+        if(end == string::npos) {
+            end = path.size();
+        }
+        const string segment = path.substr(begin, end-begin);
+        if(segment == "..") {
+            if(segments.size() && segments.back() != "..") {
+                segments.pop_back();
+            } else if(path[0] != '/') {
+                segments.push_back(segment);
+            }
+        } else if(segment.size() && segment != ".") {
+            segments.push_back(segment);
+        }
+        begin = end+1;
+    }
+
+    string normalized{path.size() && path[0]=='/'?"/":""};
+    for(size_t i=0; i<segments.size(); i++) {
+        if(i) {
+            normalized += '/';
+        }
+        normalized += segments[i];
+    }
+    return normalized;
+}
+
+string HtmlRepositoryExport::relativePath(const string& from, const string& to)
+{
+    vector<string> fromSegments{}, toSegments{};
+    for(auto p:{make_pair(&from, &fromSegments), make_pair(&to, &toSegments)}) {
+        size_t begin = 0, end;
+        while((end = p.first->find('/', begin)) != string::npos) {
+            p.second->push_back(p.first->substr(begin, end-begin));
+            begin = end+1;
+        }
+        p.second->push_back(p.first->substr(begin));
+    }
+    // directory of 'from'
+    fromSegments.pop_back();
+
+    size_t common = 0;
+    while(common < fromSegments.size()
+          && common+1 < toSegments.size()
+          && fromSegments[common] == toSegments[common])
+    {
+        common++;
+    }
+
+    string relative{};
+    for(size_t i=common; i<fromSegments.size(); i++) {
+        relative += "../";
+    }
+    for(size_t i=common; i<toSegments.size(); i++) {
+        relative += toSegments[i];
+        if(i+1 < toSegments.size()) {
+            relative += '/';
+        }
+    }
+    return relative;
+}
+
+void HtmlRepositoryExport::rewriteLinks(
+    string& html,
+    const string& outlineDirectory,
+    const string& htmlPath,
+    const map<string,string>& exported,
+    vector<pair<string,bool>>& dependencies
+) {
+    static const string HREF{"href=\""};
+    static const string MD_EXTENSION{".md"};
+    static const string MARKDOWN_EXTENSION{".markdown"};
+
+    string rewritten{};
+    size_t copied = 0;
+    size_t p = 0;
+    while((p = html.find(HREF, p)) != string::npos) {
+        const size_t begin = p+HREF.size();
+        const size_t end = html.find('"', begin);
+        if(end == string::npos) {
+            break;
+        }
+        p = end+1;
+
+        // skip in-page links and URLs w/ scheme (http:, mailto:, mindforger:, file:, ...)
+        const size_t delimiter = html.find_first_of(":/?#", begin);
+        if(begin == end || html[begin] == '#' || (delimiter<end && html[delimiter] == ':')) {
+            continue;
+        }
+
+        size_t targetEnd = html.find('#', begin);
+        if(targetEnd > end) {
+            targetEnd = end;
+        }
+        string target = html.substr(begin, targetEnd-begin);
+        if(!stringEndsWith(target, MD_EXTENSION) && !stringEndsWith(target, MARKDOWN_EXTENSION)) {
+            continue;
+        }
+        // cmark percent-encodes (special) chars in URLs
+        if(target.find('%') != string::npos) {
+            string decoded{};
+            for(size_t i=0; i<target.size(); i++) {
+                if(target[i]=='%' && i+2<target.size() && isxdigit(target[i+1]) && isxdigit(target[i+2])) {
+                    decoded += static_cast<char>(stoi(target.substr(i+1, 2), nullptr, 16));
+                    i += 2;
+                } else {
+                    decoded += target[i];
+                }
+            }
+            target = decoded;
+        }
+
+        const string absolute = normalizePath(
+            target[0]=='/'?target:outlineDirectory+"/"+target
+        );
+        auto e = exported.find(absolute);
+        dependencies.push_back(make_pair(absolute, e != exported.end()));
+        if(e != exported.end()) {
+            rewritten.append(html, copied, begin-copied);
+            rewritten += relativePath(htmlPath, e->second);
+            copied = targetEnd;
+        }
+    }
+
+    if(copied) {
+        rewritten.append(html, copied, string::npos);
+        html.swap(rewritten);
+    }
+}
+
+string HtmlRepositoryExport::toHtmlPath(const string& outlineKey, const string& memoryPath)
+{
+    string key{}, memory{};
+    pathToLinuxDelimiters(outlineKey, key);
+    pathToLinuxDelimiters(memoryPath, memory);
+    key = normalizePath(key);
+    memory = normalizePath(memory);
+
+    string htmlPath{};
+    if(memory.size() && key.size() > memory.size()+1
+       && key.compare(0, memory.size(), memory) == 0
+       && key[memory.size()] == '/')
+    {
+        htmlPath = key.substr(memory.size()+1);
+    } else {
+        // O outside of memory (e.g. single file repository)
+        htmlPath = key.substr(key.find_last_of('/')+1);
+    }
+
+    const size_t dot = htmlPath.find_last_of('.');
+    const size_t slash = htmlPath.find_last_of('/');
+    if(dot != string::npos && (slash == string::npos || dot > slash)) {
+        htmlPath.erase(dot);
+    }
+    htmlPath += ".html";
+    return htmlPath;
+}
+
+bool HtmlRepositoryExport::createParentDirectories(const string& directory, const string& path)
+{
+    size_t slash = 0;
+    while((slash = path.find('/', slash)) != string::npos) {
+        const string subdirectory = directory + FILE_PATH_SEPARATOR + path.substr(0, slash);
+        if(!isDirectory(subdirectory.c_str()) && !createDirectory(subdirectory)) {
+            return false;
+        }
+        slash++;
+    }
+    return true;
+}
+
+void HtmlRepositoryExport::loadManifest(
+    const string& fileName,
+    string& configurationHash,
+    map<string,ManifestEntry>& manifest
+) {
+    ifstream in{fileName};
+    string line{};
+    const string configurationPrefix{MANIFEST_CONFIGURATION_PREFIX};
+    while(getline(in, line)) {
+        if(line.compare(0, configurationPrefix.size(), configurationPrefix) == 0) {
+            configurationHash = line.substr(configurationPrefix.size());
+            continue;
+        }
+        if(line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        // path TAB revision TAB modified (TAB dependency TAB exists)*
+        vector<string> fields{};
+        size_t begin = 0, end;
+        while((end = line.find('\t', begin)) != string::npos) {
+            fields.push_back(line.substr(begin, end-begin));
+            begin = end+1;
+        }
+        fields.push_back(line.substr(begin));
+        if(fields.size() < 3 || fields.size()%2 == 0) {
+            continue;
+        }
+
+        ManifestEntry& entry = manifest[fields[0]];
+        entry.revision = static_cast<uint32_t>(strtoul(fields[1].c_str(), nullptr, 10));
+        entry.modified = static_cast<time_t>(strtoll(fields[2].c_str(), nullptr, 10));
+        for(size_t i=3; i+1<fields.size(); i+=2) {
+            entry.dependencies.push_back(make_pair(fields[i], fields[i+1]=="1"));
+        }
+    }
+}
+
+bool HtmlRepositoryExport::saveManifest(
+    const string& fileName,
+    const string& configurationHash,
+    const map<string,ManifestEntry>& manifest
+) {
+    ofstream out{fileName};
+    out << "# MindForger HTML export manifest" << endl;
+    out << MANIFEST_CONFIGURATION_PREFIX << configurationHash << endl;
+    for(const auto& m:manifest) {
+        out << m.first << "\t" << m.second.revision << "\t" << static_cast<long long>(m.second.modified);
+        for(const pair<string,bool>& d:m.second.dependencies) {
+            out << "\t" << d.first << "\t" << (d.second?"1":"0");
+        }
+        out << "\n";
+    }
+    out.close();
+    return !out.fail();
+}
+
+bool HtmlRepositoryExport::to(
+    const vector<Outline*>& outlines,
+    const string& memoryPath,
+    const string& directory,
+    bool incremental,
+    ProgressCallbackCtx* callbackCtx
+) {
+    exportedCount = skippedCount = failedCount = 0;
+
+    if(!isDirectory(directory.c_str()) && !createDirectory(directory)) {
+        failedCount = outlines.size();
+        return false;
+    }
+
+    // O paths: source (normalized) -> HTML (relative to export directory)
+    map<string,string> exported{};
+    vector<string> htmlPaths(outlines.size());
+    vector<string> outlineDirectories(outlines.size());
+    for(size_t i=0; i<outlines.size(); i++) {
+        string key{}, file{};
+        pathToLinuxDelimiters(outlines[i]->getKey(), key);
+        key = normalizePath(key);
+        htmlPaths[i] = toHtmlPath(key, memoryPath);
+        exported[key] = htmlPaths[i];
+        pathToDirectoryAndFile(key, outlineDirectories[i], file);
+    }
+
+    // incremental: skip Os w/ the same revision and dependencies
+    const string manifestFileName = directory + FILE_PATH_SEPARATOR + MANIFEST_FILE_NAME;
+    const string configurationHash = std::to_string(htmlRepresentation.getConfigurationHash(true));
+    map<string,ManifestEntry> lastManifest{};
+    string lastConfigurationHash{};
+    if(incremental) {
+        loadManifest(manifestFileName, lastConfigurationHash, lastManifest);
+    }
+    // configuration/theme changed > all Os must be rendered again
+    const bool reusable = incremental && lastConfigurationHash == configurationHash;
+    map<string,ManifestEntry> manifest{};
+    vector<size_t> dirty{};
+    for(size_t i=0; i<outlines.size(); i++) {
+        if(reusable) {
+            auto m = lastManifest.find(htmlPaths[i]);
+            if(m != lastManifest.end()
+               && m->second.revision == outlines[i]->getRevision()
+               && m->second.modified == outlines[i]->getModified()
+               && isFile((directory + FILE_PATH_SEPARATOR + htmlPaths[i]).c_str()))
+            {
+                bool changed{false};
+                for(const pair<string,bool>& d:m->second.dependencies) {
+                    if((exported.find(d.first) != exported.end()) != d.second) {
+                        changed = true;
+                        break;
+                    }
+                }
+                if(!changed) {
+                    manifest[htmlPaths[i]] = m->second;
+                    skippedCount++;
+                    continue;
+                }
+            }
+        }
+        dirty.push_back(i);
+    }
+    if(incremental) {
+        // HTML of Os which no longer exist
+        set<string> paths(htmlPaths.begin(), htmlPaths.end());
+        for(const auto& m:lastManifest) {
+            if(paths.find(m.first) == paths.end()) {
+                std::remove((directory + FILE_PATH_SEPARATOR + m.first).c_str());
+            }
+        }
+    }
+    MF_DEBUG("HTML export of " << outlines.size() << " Os: " << dirty.size() << " to be rendered" << endl);
+
+    // writer: rendered HTML is written by a single thread so that workers are not blocked by I/O
+    mutex queueMutex{};
+    condition_variable notEmpty{}, notFull{};
+    deque<pair<size_t,string>> queue{};
+    bool rendered{false};
+    vector<char> written(outlines.size(), 0);
+    thread writer{[&]() {
+        for(;;) {
+            unique_lock<mutex> lock{queueMutex};
+            notEmpty.wait(lock, [&]{ return !queue.empty() || rendered; });
+            if(queue.empty()) {
+                return;
+            }
+            pair<size_t,string> item{std::move(queue.front())};
+            queue.pop_front();
+            lock.unlock();
+            notFull.notify_one();
+
+            const string& htmlPath = htmlPaths[item.first];
+            if(createParentDirectories(directory, htmlPath)) {
+                ofstream out{directory + FILE_PATH_SEPARATOR + htmlPath, ios::binary};
+                out.write(item.second.data(), item.second.size());
+                out.close();
+                written[item.first] = !out.fail();
+            }
+            if(!written[item.first]) {
+                cerr << "Error: unable to export O to HTML file '" << htmlPath << "'" << endl;
+            }
+        }
+    }};
+
+    // render Os in parallel
+    vector<vector<pair<string,bool>>> dependencies(outlines.size());
+    atomic<size_t> done{0};
+    parallelForBlocks(
+        pool,
+        dirty.size(),
+        1,
+        getDefaultWorkersCount(),
+        [&](unsigned int worker, size_t begin, size_t end) {
+            for(size_t d=begin; d<end; d++) {
+                const size_t i = dirty[d];
+                string html{};
+                htmlRepresentation.to(outlines[i], &html, true, false, true, false);
+                rewriteLinks(html, outlineDirectories[i], htmlPaths[i], exported, dependencies[i]);
+                sort(dependencies[i].begin(), dependencies[i].end());
+                dependencies[i].erase(
+                    unique(dependencies[i].begin(), dependencies[i].end()),
+                    dependencies[i].end());
+                {
+                    unique_lock<mutex> lock{queueMutex};
+                    notFull.wait(lock, [&]{ return queue.size() < WRITE_QUEUE_CAPACITY; });
+                    queue.emplace_back(i, std::move(html));
+                }
+                notEmpty.notify_one();
+                done++;
+
+                // progress callback is NOT thread safe - calling thread (worker 0) reports it
+                if(worker == 0 && callbackCtx) {
+                    callbackCtx->updateProgress(
+                        static_cast<float>(skippedCount+done)/static_cast<float>(outlines.size()));
+                }
+            }
+        }
+    );
+    {
+        lock_guard<mutex> lock{queueMutex};
+        rendered = true;
+    }
+    notEmpty.notify_one();
+    writer.join();
+
+    for(size_t i:dirty) {
+        if(written[i]) {
+            ManifestEntry& entry = manifest[htmlPaths[i]];
+            entry.revision = outlines[i]->getRevision();
+            entry.modified = outlines[i]->getModified();
+            entry.dependencies = std::move(dependencies[i]);
+            exportedCount++;
+        } else {
+            failedCount++;
+        }
+    }
+    if(!saveManifest(manifestFileName, configurationHash, manifest)) {
+        cerr << "Error: unable to save HTML export manifest '" << manifestFileName << "'" << endl;
+    }
+
+    if(callbackCtx) {
+        callbackCtx->updateProgress(1.0);
+    }
+
+    MF_DEBUG("HTML export: " << exportedCount << " exported, " << skippedCount << " skipped, " << failedCount << " failed" << endl);
+    return failedCount == 0;
+}
+
+} // m8r namespace
@@ -0,0 +1,149 @@
+/*
+ html_repository_export.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_HTML_REPOSITORY_EXPORT_H
+#define M8R_HTML_REPOSITORY_EXPORT_H
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../model/outline.h"
+#include "../gear/async_utils.h"
+#include "../gear/worker_pool.h"
+#include "../representations/html/html_outline_representation.h"
+
+namespace m8r {
+
+/**
+ * @brief Static HTML export of (whole) repository.
+ *
+ * Os are rendered to HTML in parallel by worker threads of export's own pool
+ * (so that export doesn't block AA computations of the shared pool), rendered
+ * HTML is written by a single writer thread (so that rendering is not
+ * blocked by I/O). Rendering is reentrant - it must not use
+ * non-reentrant C library functions like localtime().
+ * Directory structure of the memory is kept in the export directory,
+ * O file extension is changed to .html and links to exported Os are
+ * rewritten to relative .html links.
+ *
+ * Incremental export skips Os whose revision, modification time and
+ * dependencies (existence of linked Os) are the same as in the last
+ * export - this is tracked in the manifest file in the export directory.
+ * Manifest also keeps hash of configuration and theme used by the last
+ * export - if it's changed, then all Os are exported again.
+ */
+class HtmlRepositoryExport
+{
+public:
+    static constexpr const auto MANIFEST_FILE_NAME = ".mindforger-html-export";
+    static constexpr const auto MANIFEST_CONFIGURATION_PREFIX = "# configuration: ";
+    // rendered Os waiting for the writer
+    static constexpr size_t WRITE_QUEUE_CAPACITY = 32;
+
+    /**
+     * @brief Rewrite href links to exported Os (.md) to relative .html links.
+     *
+     * @param html HTML to be rewritten.
+     * @param outlineDirectory absolute path of the directory w/ O source.
+     * @param htmlPath path of HTML file relative to export directory.
+     * @param exported absolute O path (normalized) -> HTML path relative to export directory.
+     * @param dependencies collected linked Os (normalized absolute path, whether exported).
+     */
+    static void rewriteLinks(
+        std::string& html,
+        const std::string& outlineDirectory,
+        const std::string& htmlPath,
+        const std::map<std::string,std::string>& exported,
+        std::vector<std::pair<std::string,bool>>& dependencies
+    );
+
+    /**
+     * @brief Normalize path lexically i.e. w/o file system access - remove . and resolve ..
+     */
+    static std::string normalizePath(const std::string& path);
+    /**
+     * @brief Get path of file 'to' relative to directory of file 'from' - both relative to the same root.
+     */
+    static std::string relativePath(const std::string& from, const std::string& to);
+
+private:
+    struct ManifestEntry {
+        uint32_t revision;
+        time_t modified;
+        std::vector<std::pair<std::string,bool>> dependencies;
+    };
+
+    HtmlOutlineRepresentation& htmlRepresentation;
+
+    // rendering workers - threads are started on the first export
+    WorkerPool pool;
+
+    unsigned exportedCount;
+    unsigned skippedCount;
+    unsigned failedCount;
+
+public:
+    explicit HtmlRepositoryExport(HtmlOutlineRepresentation& htmlRepresentation);
+    HtmlRepositoryExport(const HtmlRepositoryExport&) = delete;
+    HtmlRepositoryExport(const HtmlRepositoryExport&&) = delete;
+    HtmlRepositoryExport &operator=(const HtmlRepositoryExport&) = delete;
+    HtmlRepositoryExport &operator=(const HtmlRepositoryExport&&) = delete;
+    ~HtmlRepositoryExport();
+
+    /**
+     * @brief Export Os to HTML files in the directory.
+     *
+     * Progress is reported from the calling thread only.
+     *
+     * @param outlines Os to export.
+     * @param memoryPath memory directory - O paths are made relative to it.
+     * @param directory export directory (created if it doesn't exist).
+     * @param incremental skip Os which haven't changed since the last export.
+     * @param callbackCtx progress callback.
+     * @return `true` if all Os were exported, `false` if some file(s) could not be written.
+     */
+    bool to(
+        const std::vector<Outline*>& outlines,
+        const std::string& memoryPath,
+        const std::string& directory,
+        bool incremental=false,
+        ProgressCallbackCtx* callbackCtx=nullptr
+    );
+
+    unsigned getExportedCount() const { return exportedCount; }
+    unsigned getSkippedCount() const { return skippedCount; }
+    unsigned getFailedCount() const { return failedCount; }
+
+private:
+    static std::string toHtmlPath(const std::string& outlineKey, const std::string& memoryPath);
+    static bool createParentDirectories(const std::string& directory, const std::string& path);
+    static void loadManifest(
+        const std::string& fileName,
+        std::string& configurationHash,
+        std::map<std::string,ManifestEntry>& manifest);
+    static bool saveManifest(
+        const std::string& fileName,
+        const std::string& configurationHash,
+        const std::map<std::string,ManifestEntry>& manifest);
+};
+
+}
+#endif // M8R_HTML_REPOSITORY_EXPORT_H
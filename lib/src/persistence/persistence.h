@@ -19,8 +19,12 @@
 #ifndef M8R_PERSISTENCE_H_
 #define M8R_PERSISTENCE_H_
 
+#include <string>
+#include <vector>
+
 #include "../model/stencil.h"
 #include "../model/outline.h"
+#include "../gear/async_utils.h"
 
 namespace m8r {
 
@@ -38,7 +42,19 @@ public:
     virtual void load(Stencil* stencil) = 0;
     virtual bool isWriteable(const std::string& outlineKey) = 0;
     virtual void save(Outline* outline) = 0;    
+    /**
+     * @brief Barrier - wait until all saved Os are written.
+     * @param failedOutlineKeys Keys of Os which could not be written since the last
+     *        flush are appended to this vector (if not nullptr).
+     * @return `false` if some O could not be written, `true` otherwise.
+     */
+    virtual bool flush(std::vector<std::string>* failedOutlineKeys=nullptr) = 0;
     virtual void saveAsHtml(Outline* outline, const std::string& fileName) = 0;
+    virtual bool saveAsHtml(
+            const std::vector<Outline*>& outlines,
+            const std::string& directory,
+            bool incremental,
+            ProgressCallbackCtx* callbackCtx) = 0;
 };
 
 }
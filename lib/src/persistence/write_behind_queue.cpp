@@ -0,0 +1,274 @@
+/*
+ write_behind_queue.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "write_behind_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+  #include <io.h>
+  #include <process.h>
+  #include <windows.h>
+#else
+  #include <unistd.h>
+#endif
+
+#include "../gear/file_utils.h"
+
+using namespace std;
+
+namespace m8r {
+
+WriteBehindQueue::WriteBehindQueue()
+    : order{},
+      pending{},
+      writing{false},
+      stopping{false},
+      failedFiles{},
+      writtenCount{0},
+      coalescedCount{0},
+      failedCount{0},
+      writer{}
+{
+}
+
+WriteBehindQueue::~WriteBehindQueue()
+{
+    {
+        lock_guard<mutex> criticalSection{queueMutex};
+        stopping = true;
+    }
+    queueFilled.notify_all();
+
+    // writer drains the queue before it finishes
+    if(writer.joinable()) {
+        writer.join();
+    }
+    for(auto& p:pending) {
+        delete p.second;
+    }
+}
+
+bool WriteBehindQueue::writeAtomically(const string& fileName, const string& content)
+{
+    static atomic<unsigned> discriminator{0};
+
+    // symbolic link is kept - file it points to is replaced
+    string target{fileName};
+#ifndef _WIN32
+    struct stat link{};
+    if(!lstat(fileName.c_str(), &link) && S_ISLNK(link.st_mode)) {
+        char* resolved = realpath(fileName.c_str(), nullptr);
+        if(resolved) {
+            target.assign(resolved);
+            free(resolved);
+        }
+    }
+#endif
+
+    // temporary file MUST be in the same directory (file system) to be renamed atomically
+    string directory, file;
+    pathToDirectoryAndFile(target, directory, file);
+    string tmp{target, 0, target.size()-file.size()};
+    tmp += ".";
+    tmp += file;
+    tmp += ".mf-";
+#ifdef _WIN32
+    tmp += std::to_string(_getpid());
+#else
+    tmp += std::to_string(getpid());
+#endif
+    tmp += "-";
+    tmp += std::to_string(discriminator++);
+
+    // O_EXCL: never follow/reuse existing file; mode is subject to umask as when file is created
+#ifdef _WIN32
+    // text mode to keep line endings of the files written using ofstream
+    int fd = _open(tmp.c_str(), _O_WRONLY|_O_CREAT|_O_EXCL|_O_TEXT, _S_IREAD|_S_IWRITE);
+#else
+    int fd = open(tmp.c_str(), O_WRONLY|O_CREAT|O_EXCL, 0666);
+#endif
+    if(fd < 0) {
+        MF_DEBUG("Write behind: unable to create " << tmp << ": " << errno << endl);
+        return false;
+    }
+
+#ifndef _WIN32
+    // keep permissions of the replaced file
+    struct stat original{};
+    if(!stat(target.c_str(), &original)) {
+        fchmod(fd, original.st_mode & 07777);
+    }
+#endif
+
+    // single write of the whole content (loop handles signals and partial writes only)
+    bool ok{true};
+    const char* data = content.data();
+    size_t remaining = content.size();
+    while(remaining) {
+#ifdef _WIN32
+        const int written = _write(fd, data, static_cast<unsigned>(remaining));
+#else
+        const ssize_t written = ::write(fd, data, remaining);
+#endif
+        if(written < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            ok = false;
+            break;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+#ifdef _WIN32
+    ok = ok && !_commit(fd);
+    ok = !_close(fd) && ok;
+    ok = ok && MoveFileExA(tmp.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING|MOVEFILE_WRITE_THROUGH);
+#else
+    ok = ok && !fsync(fd);
+    ok = !close(fd) && ok;
+    ok = ok && !rename(tmp.c_str(), target.c_str());
+    if(ok) {
+        // persist directory entry of the renamed file
+        int dirFd = open(directory.size()?directory.c_str():FILE_PATH_SEPARATOR, O_RDONLY);
+        if(dirFd >= 0) {
+            fsync(dirFd);
+            close(dirFd);
+        }
+    }
+#endif
+
+    if(!ok) {
+        MF_DEBUG("Write behind: unable to write " << target << ": " << errno << endl);
+        remove(tmp.c_str());
+    }
+    return ok;
+}
+
+void WriteBehindQueue::write(const string& fileName, string* content)
+{
+    {
+        lock_guard<mutex> criticalSection{queueMutex};
+
+        auto p = pending.find(fileName);
+        if(p != pending.end()) {
+            // coalesce: file is written once w/ the latest content
+            delete p->second;
+            p->second = content;
+            coalescedCount++;
+        } else {
+            pending[fileName] = content;
+            order.push_back(fileName);
+        }
+
+        if(!writer.joinable()) {
+            writer = thread{&WriteBehindQueue::run, this};
+        }
+    }
+    queueFilled.notify_one();
+}
+
+void WriteBehindQueue::wait()
+{
+    unique_lock<mutex> criticalSection{queueMutex};
+    queueDrained.wait(criticalSection, [this]{ return order.empty() && !writing; });
+}
+
+bool WriteBehindQueue::flush(vector<string>* failedFiles)
+{
+    unique_lock<mutex> criticalSection{queueMutex};
+    queueDrained.wait(criticalSection, [this]{ return order.empty() && !writing; });
+
+    if(this->failedFiles.empty()) {
+        return true;
+    }
+    if(failedFiles) {
+        failedFiles->insert(failedFiles->end(), this->failedFiles.begin(), this->failedFiles.end());
+    }
+    this->failedFiles.clear();
+    return false;
+}
+
+void WriteBehindQueue::run()
+{
+    unique_lock<mutex> criticalSection{queueMutex};
+    while(true) {
+        queueFilled.wait(criticalSection, [this]{ return !order.empty() || stopping; });
+        if(order.empty()) {
+            // stopping
+            return;
+        }
+
+        string fileName{order.front()};
+        order.pop_front();
+        auto p = pending.find(fileName);
+        string* content = p->second;
+        pending.erase(p);
+        writing = true;
+
+        // file is written w/o lock - new writes (of the same file too) can be queued meanwhile
+        criticalSection.unlock();
+        MF_DEBUG("Write behind: " << fileName << endl);
+        const bool ok = writeAtomically(fileName, *content);
+        delete content;
+        criticalSection.lock();
+
+        writing = false;
+        if(ok) {
+            writtenCount++;
+            // the latest content of file which failed before is saved
+            failedFiles.erase(std::remove(failedFiles.begin(), failedFiles.end(), fileName), failedFiles.end());
+        } else {
+            failedCount++;
+            if(std::find(failedFiles.begin(), failedFiles.end(), fileName) == failedFiles.end()) {
+                failedFiles.push_back(fileName);
+            }
+        }
+        if(order.empty()) {
+            queueDrained.notify_all();
+        }
+    }
+}
+
+unsigned WriteBehindQueue::getWrittenCount()
+{
+    lock_guard<mutex> criticalSection{queueMutex};
+    return writtenCount;
+}
+
+unsigned WriteBehindQueue::getCoalescedCount()
+{
+    lock_guard<mutex> criticalSection{queueMutex};
+    return coalescedCount;
+}
+
+unsigned WriteBehindQueue::getFailedCount()
+{
+    lock_guard<mutex> criticalSection{queueMutex};
+    return failedCount;
+}
+
+} // m8r namespace
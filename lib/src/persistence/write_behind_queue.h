@@ -0,0 +1,119 @@
+/*
+ write_behind_queue.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_WRITE_BEHIND_QUEUE_H
+#define M8R_WRITE_BEHIND_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../debug.h"
+
+namespace m8r {
+
+/**
+ * @brief Write-behind queue of files to be (re)written.
+ *
+ * Files are written by a single background writer thread so that the caller
+ * (UI) is not blocked by I/O. If a file is queued again before it is written,
+ * the queued content is replaced i.e. repeated saves are coalesced to the
+ * last one.
+ *
+ * Files are written atomically: content is written to a temporary file
+ * in the same directory, synced to disk and renamed over the original file,
+ * therefore readers (and crash recovery) never see a torn file.
+ *
+ * flush() is a barrier - it returns when all queued files are written and
+ * reports files which could not be written. Destructor drains the queue.
+ */
+class WriteBehindQueue
+{
+private:
+    std::mutex queueMutex;
+    // writer is waiting for files to write
+    std::condition_variable queueFilled;
+    // flush() is waiting for writer to write everything
+    std::condition_variable queueDrained;
+
+    // file names in order of (first) write request
+    std::deque<std::string> order;
+    // file name -> content to be written
+    std::map<std::string,std::string*> pending;
+    bool writing;
+    bool stopping;
+    // files which could not be written (and weren't written later), cleared by flush()
+    std::vector<std::string> failedFiles;
+
+    unsigned writtenCount;
+    unsigned coalescedCount;
+    unsigned failedCount;
+
+    // writer thread is started on the first write
+    std::thread writer;
+
+public:
+    explicit WriteBehindQueue();
+    WriteBehindQueue(const WriteBehindQueue&) = delete;
+    WriteBehindQueue(const WriteBehindQueue&&) = delete;
+    WriteBehindQueue &operator=(const WriteBehindQueue&) = delete;
+    WriteBehindQueue &operator=(const WriteBehindQueue&&) = delete;
+    ~WriteBehindQueue();
+
+    /**
+     * @brief Write file atomically - temporary file, single write, sync and rename.
+     *
+     * Permissions of the replaced file are kept, symbolic link is followed.
+     *
+     * @return `true` if file was written, `false` otherwise (file is kept intact).
+     */
+    static bool writeAtomically(const std::string& fileName, const std::string& content);
+
+    /**
+     * @brief Queue file to be written - queue takes ownership of the content.
+     */
+    void write(const std::string& fileName, std::string* content);
+
+    /**
+     * @brief Wait until all queued files are written - failures are kept for flush().
+     */
+    void wait();
+
+    /**
+     * @brief Wait until all queued files are written.
+     *
+     * @param failedFiles Names of files which could not be written since the last flush
+     *        (and whose later write didn't succeed) are appended to this vector (if not nullptr).
+     * @return `false` if any file could not be written since the last flush, `true` otherwise.
+     */
+    bool flush(std::vector<std::string>* failedFiles=nullptr);
+
+    unsigned getWrittenCount();
+    unsigned getCoalescedCount();
+    unsigned getFailedCount();
+
+private:
+    void run();
+};
+
+}
+#endif // M8R_WRITE_BEHIND_QUEUE_H
@@ -0,0 +1,441 @@
+/*
+ html_live_preview.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "html_live_preview.h"
+
+#include <algorithm>
+
+namespace m8r {
+
+using namespace std;
+
+namespace {
+
+bool isBlank(const string& line)
+{
+    for(const char c:line) {
+        if(c != ' ' && c != '\t' && c != '\r') {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t indentation(const string& line)
+{
+    size_t i{0};
+    while(i < line.size() && (line[i] == ' ' || line[i] == '\t')) {
+        i++;
+    }
+    return i;
+}
+
+bool isListItem(const string& line)
+{
+    size_t i = indentation(line);
+    if(i < line.size() && (line[i] == '-' || line[i] == '*' || line[i] == '+')) {
+        i++;
+    } else {
+        const size_t digits{i};
+        while(i < line.size() && i-digits < 10 && line[i] >= '0' && line[i] <= '9') {
+            i++;
+        }
+        if(i == digits || i >= line.size() || (line[i] != '.' && line[i] != ')')) {
+            return false;
+        }
+        i++;
+    }
+    return i == line.size() || line[i] == ' ' || line[i] == '\t' || line[i] == '\r';
+}
+
+/**
+ * @brief Link reference definitions and footnotes are global - such MD cannot be split.
+ */
+bool isReferenceDefinition(const string& line)
+{
+    size_t i = indentation(line);
+    if(i > 3 || i >= line.size() || line[i] != '[') {
+        return false;
+    }
+    const size_t close = line.find("]:", i+1);
+    return close != string::npos && close > i+1;
+}
+
+/**
+ * @brief Get closing sequence of block which may contain blank lines.
+ */
+string blockCloser(const string& line)
+{
+    const size_t i = indentation(line);
+    if(i > 3) {
+        return string{};
+    }
+
+    // fenced code
+    if(i < line.size() && (line[i] == '`' || line[i] == '~')) {
+        size_t n{i};
+        while(n < line.size() && line[n] == line[i]) {
+            n++;
+        }
+        if(n-i >= 3) {
+            return line.substr(i, n-i);
+        }
+        return string{};
+    }
+
+    // math
+    if(!line.compare(i, 2, "$$")) {
+        if(line.find("$$", i+2) == string::npos) {
+            return string{"$$"};
+        }
+        return string{};
+    }
+
+    // HTML comment and raw HTML blocks
+    static const vector<pair<string,string>> HTML_BLOCKS{
+        {"<!--", "-->"},
+        {"<pre", "</pre>"},
+        {"<script", "</script>"},
+        {"<style", "</style>"},
+        {"<textarea", "</textarea>"}
+    };
+    string lower{line.substr(i)};
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    for(const auto& b:HTML_BLOCKS) {
+        if(!lower.compare(0, b.first.size(), b.first)
+           && lower.find(b.second, b.first.size()) == string::npos)
+        {
+            return b.second;
+        }
+    }
+    return string{};
+}
+
+bool isClosed(const string& line, const string& closer)
+{
+    if(closer[0] == '`' || closer[0] == '~') {
+        const size_t i = indentation(line);
+        size_t n{i};
+        while(n < line.size() && line[n] == closer[0]) {
+            n++;
+        }
+        return i <= 3 && n-i >= closer.size() && isBlank(line.substr(n));
+    }
+    if(closer[0] == '$') {
+        return line.find(closer) != string::npos;
+    }
+    string lower{line};
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    return lower.find(closer) != string::npos;
+}
+
+} // anonymous namespace
+
+HtmlLivePreview::HtmlLivePreview(HtmlOutlineRepresentation& htmlRepresentation)
+    : config(Configuration::getInstance()),
+      htmlRepresentation(htmlRepresentation),
+      page{},
+      blocks{},
+      token{0},
+      loaded{false},
+      transcodedBlocks{0}
+{
+}
+
+HtmlLivePreview::~HtmlLivePreview()
+{
+}
+
+void HtmlLivePreview::splitBlocks(const vector<string*>& lines, vector<string>& blocks)
+{
+    for(const string* line:lines) {
+        if(isReferenceDefinition(*line)) {
+            string block{};
+            for(const string* l:lines) {
+                block += *l;
+                block += "\n";
+            }
+            if(!isBlank(block)) {
+                blocks.push_back(block);
+            }
+            return;
+        }
+    }
+
+    string block{};
+    string closer{};
+    bool list{false};
+    unsigned blankLines{0};
+    for(const string* line:lines) {
+        if(closer.size()) {
+            // inside of fenced code, math or HTML block
+            block += *line;
+            block += "\n";
+            if(isClosed(*line, closer)) {
+                closer.clear();
+            }
+            continue;
+        }
+
+        if(isBlank(*line)) {
+            blankLines++;
+            continue;
+        }
+
+        const bool listItem = isListItem(*line);
+        if(blankLines && block.size()) {
+            // indented continuation and next item of a (loose) list belong to the block
+            if(indentation(*line) || (list && listItem)) {
+                block.append(blankLines, '\n');
+            } else {
+                blocks.push_back(block);
+                block.clear();
+                list = false;
+            }
+        }
+        blankLines = 0;
+
+        list = list || listItem;
+        block += *line;
+        block += "\n";
+        closer = blockCloser(*line);
+    }
+    if(block.size()) {
+        blocks.push_back(block);
+    }
+}
+
+void HtmlLivePreview::toJavaScriptString(const string& s, string& js)
+{
+    static const char* HEX = "0123456789abcdef";
+
+    js += '\'';
+    for(size_t i=0; i<s.size(); i++) {
+        const unsigned char c = static_cast<unsigned char>(s[i]);
+        switch(c) {
+        case '\\':
+            js += "\\\\";
+            break;
+        case '\'':
+            js += "\\'";
+            break;
+        case '\n':
+            js += "\\n";
+            break;
+        case '\r':
+            js += "\\r";
+            break;
+        case '\t':
+            js += "\\t";
+            break;
+        case 0xE2:
+            // U+2028 and U+2029 (UTF-8) terminate JavaScript string literal
+            if(i+2 < s.size()
+               && static_cast<unsigned char>(s[i+1]) == 0x80
+               && (static_cast<unsigned char>(s[i+2]) == 0xA8 || static_cast<unsigned char>(s[i+2]) == 0xA9))
+            {
+                js += static_cast<unsigned char>(s[i+2]) == 0xA8 ? "\\u2028" : "\\u2029";
+                i += 2;
+            } else {
+                js += s[i];
+            }
+            break;
+        default:
+            if(c < 0x20) {
+                js += "\\x";
+                js += HEX[c >> 4];
+                js += HEX[c & 0xF];
+            } else {
+                js += s[i];
+            }
+        }
+    }
+    js += '\'';
+}
+
+void HtmlLivePreview::reset()
+{
+    page.clear();
+    blocks.clear();
+    loaded = false;
+}
+
+void HtmlLivePreview::transcode(const string& block, string& html)
+{
+    transcodedBlocks++;
+    htmlRepresentation.transcode(block, html);
+}
+
+bool HtmlLivePreview::to(const Note* note, string& html, string& js, int yScrollTo)
+{
+    js.clear();
+    if(!config.isUiHtmlTheme()) {
+        reset();
+        htmlRepresentation.to(note, &html, false, yScrollTo);
+        return false;
+    }
+
+    string path, file;
+    pathToDirectoryAndFile(note->getOutlineKey(), path, file);
+
+    string md{};
+    htmlRepresentation.markdownRepresentation.toHeader(note, &md, true);
+    string headerHtml{};
+    htmlRepresentation.transcode(md, headerHtml);
+
+    return to(path, headerHtml, note->getDescription(), html, js, yScrollTo);
+}
+
+bool HtmlLivePreview::to(Outline* outline, string& html, string& js, int yScrollTo)
+{
+    js.clear();
+    if(!config.isUiHtmlTheme()) {
+        reset();
+        htmlRepresentation.to(outline, &html, false, false, false, true, yScrollTo);
+        return false;
+    }
+
+    string path, file;
+    pathToDirectoryAndFile(outline->getKey(), path, file);
+
+    string headerHtml{};
+    headerHtml.reserve(1000);
+    htmlRepresentation.outlineHeaderToHtml(outline, headerHtml);
+
+    return to(path, headerHtml, outline->getDescription(), html, js, yScrollTo);
+}
+
+bool HtmlLivePreview::to(
+    const string& basePath,
+    string& headerHtml,
+    const vector<string*>& description,
+    string& html,
+    string& js,
+    int yScrollTo
+) {
+    vector<string> b{};
+    b.reserve(blocks.size()+1);
+    b.push_back(std::move(headerHtml));
+    splitBlocks(description, b);
+
+    // page must be reloaded if its head (base path, CSS, JS libraries) or rendering options changed
+    string p{};
+    string path{basePath};
+    htmlRepresentation.header(p, &path, false, 0);
+    p += std::to_string(config.getMd2HtmlOptions());
+
+    if(!loaded || p != page) {
+        MF_DEBUG("[HTML] live preview reload: " << b.size() << " blocks" << endl);
+
+        size_t size{5000};
+        for(const string& block:b) {
+            size += block.size();
+        }
+        html.clear();
+        html.reserve(size + size/2);
+        htmlRepresentation.header(html, &path, false, yScrollTo);
+        html += "<div id=\"";
+        html += CONTAINER_ID;
+        html += "\" data-mf-token=\"";
+        html += std::to_string(++token);
+        html += "\">";
+        for(size_t i=0; i<b.size(); i++) {
+            html += "<div>";
+            if(i) {
+                transcode(b[i], html);
+            } else {
+                html += b[i];
+            }
+            html += "</div>";
+        }
+        html += "</div>";
+        htmlRepresentation.footer(html);
+
+        page = std::move(p);
+        blocks = std::move(b);
+        loaded = true;
+        return false;
+    }
+
+    // diff: blocks between common prefix and suffix are replaced
+    size_t prefix{0};
+    while(prefix < blocks.size() && prefix < b.size() && blocks[prefix] == b[prefix]) {
+        prefix++;
+    }
+    size_t suffix{0};
+    while(suffix < blocks.size()-prefix
+          && suffix < b.size()-prefix
+          && blocks[blocks.size()-1-suffix] == b[b.size()-1-suffix])
+    {
+        suffix++;
+    }
+    const size_t deleted = blocks.size()-prefix-suffix;
+    const size_t inserted = b.size()-prefix-suffix;
+    if(!deleted && !inserted) {
+        return true;
+    }
+
+    MF_DEBUG("[HTML] live preview patch @ " << prefix << ": -" << deleted << " +" << inserted << endl);
+
+    js.reserve(1000);
+    js += "(function(){var c=document.getElementById('";
+    js += CONTAINER_ID;
+    js += "');if(!c||c.getAttribute('data-mf-token')!='";
+    js += std::to_string(token);
+    js += "')return false;var h=[";
+    string blockHtml{};
+    for(size_t i=prefix; i<prefix+inserted; i++) {
+        if(i > prefix) {
+            js += ",";
+        }
+        if(i) {
+            blockHtml.clear();
+            transcode(b[i], blockHtml);
+            toJavaScriptString(blockHtml, js);
+        } else {
+            toJavaScriptString(b[i], js);
+        }
+    }
+    js += "];";
+    js += "for(var i=0;i<";
+    js += std::to_string(deleted);
+    js += ";i++)c.removeChild(c.children[";
+    js += std::to_string(prefix);
+    js += "]);var r=c.children[";
+    js += std::to_string(prefix);
+    js += "]||null;"
+          "for(var i=0;i<h.length;i++){"
+            "var e=document.createElement('div');e.innerHTML=h[i];c.insertBefore(e,r);"
+            // re-run source highlighting, diagrams and math on the new blocks only
+            "if(window.hljs){var p=e.querySelectorAll('pre code');for(var j=0;j<p.length;j++)hljs.highlightBlock(p[j]);}"
+            "if(window.mermaid&&mermaid.init){var m=e.querySelectorAll('.mermaid');if(m.length)mermaid.init(undefined,m);}"
+            "if(window.MathJax&&MathJax.Hub)MathJax.Hub.Queue(['Typeset',MathJax.Hub,e]);"
+          "}";
+    if(yScrollTo > 0) {
+        // keep preview scrolled as editor - inserted/removed blocks change page height
+        js += "window.scrollTo(0,(document.body.scrollHeight/100)*";
+        js += std::to_string(yScrollTo);
+        js += ");";
+    }
+    js += "return true;})();";
+
+    blocks = std::move(b);
+    return true;
+}
+
+} // m8r namespace
@@ -0,0 +1,125 @@
+/*
+ html_live_preview.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_HTML_LIVE_PREVIEW_H
+#define M8R_HTML_LIVE_PREVIEW_H
+
+#include <string>
+#include <vector>
+
+#include "../../config/configuration.h"
+#include "../../model/note.h"
+#include "../../model/outline.h"
+#include "html_outline_representation.h"
+
+namespace m8r {
+
+/**
+ * @brief Incremental HTML live preview of N/O header being edited.
+ *
+ * Preview page is assembled from Markdown blocks (separated by blank lines)
+ * which are transcoded independently. Block list of the page loaded in the
+ * view is kept and on edit only changed blocks are transcoded - they are
+ * delivered to the view as JavaScript which patches the DOM (no page reload,
+ * no flickering, no scroll position loss, math/diagrams typeset only in
+ * changed blocks).
+ *
+ * Whole page is generated when there is no page loaded, page header changes
+ * (base path, CSS, JavaScript libraries) or raw HTML theme is used.
+ */
+class HtmlLivePreview
+{
+public:
+    static constexpr const auto CONTAINER_ID = "mf-live-preview";
+
+private:
+    Configuration& config;
+    HtmlOutlineRepresentation& htmlRepresentation;
+
+    // head of the loaded page + rendering options
+    std::string page;
+    // header HTML (block 0) and Markdown sources of the blocks of the loaded page
+    std::vector<std::string> blocks;
+    // loaded page identifier - patch is applied only to the page it was created for
+    unsigned token;
+    bool loaded;
+
+    unsigned transcodedBlocks;
+
+public:
+    explicit HtmlLivePreview(HtmlOutlineRepresentation& htmlRepresentation);
+    HtmlLivePreview(const HtmlLivePreview&) = delete;
+    HtmlLivePreview(const HtmlLivePreview&&) = delete;
+    HtmlLivePreview &operator=(const HtmlLivePreview&) = delete;
+    HtmlLivePreview &operator=(const HtmlLivePreview&&) = delete;
+    ~HtmlLivePreview();
+
+    /**
+     * @brief Split Markdown to blocks which can be transcoded independently.
+     *
+     * Blocks are separated by blank lines - fenced code, math and HTML blocks,
+     * indented continuations and (loose) lists are kept in one block. Markdown
+     * w/ link reference definitions or footnotes is not split at all.
+     *
+     * @param lines Markdown lines.
+     * @param blocks Blocks are appended to this vector.
+     */
+    static void splitBlocks(const std::vector<std::string*>& lines, std::vector<std::string>& blocks);
+
+    /**
+     * @brief Append string as JavaScript single quoted string literal.
+     */
+    static void toJavaScriptString(const std::string& s, std::string& js);
+
+    /**
+     * @brief Live preview of N.
+     *
+     * @param note N w/ editor content.
+     * @param html Whole page HTML if `false` is returned.
+     * @param js JavaScript which patches loaded page if `true` is returned
+     *        (empty if nothing changed). JavaScript evaluates to `false`
+     *        if it cannot be applied - page must be reloaded after reset().
+     * @param yScrollTo Scroll whole page to given % on page load or when patched.
+     * @return `true` if loaded page is to be patched, `false` if page is to be (re)loaded.
+     */
+    bool to(const Note* note, std::string& html, std::string& js, int yScrollTo=0);
+    /**
+     * @brief Live preview of O header - see N live preview.
+     */
+    bool to(Outline* outline, std::string& html, std::string& js, int yScrollTo=0);
+
+    /**
+     * @brief Forget loaded page - call it whenever the view is loaded w/ different HTML.
+     */
+    void reset();
+
+    unsigned getTranscodedBlocks() const { return transcodedBlocks; }
+
+private:
+    bool to(
+        const std::string& basePath,
+        std::string& headerHtml,
+        const std::vector<std::string*>& description,
+        std::string& html,
+        std::string& js,
+        int yScrollTo);
+    void transcode(const std::string& block, std::string& html);
+};
+
+}
+#endif // M8R_HTML_LIVE_PREVIEW_H
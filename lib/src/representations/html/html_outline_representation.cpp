@@ -22,13 +22,17 @@ namespace m8r {
 
 using namespace std;
 
+constexpr size_t HtmlOutlineRepresentation::FRAGMENT_CACHE_CAPACITY;
+
 HtmlOutlineRepresentation::HtmlOutlineRepresentation(
         Ontology& ontology,
         RepresentationInterceptor* descriptionInterceptor)
     : config(Configuration::getInstance()),
       exportColors{},
       lf{exportColors},
-      markdownRepresentation(ontology, descriptionInterceptor)
+      markdownRepresentation(ontology, descriptionInterceptor),
+      fragmentHits{0},
+      fragmentMisses{0}
 {
 #if defined MF_MD_2_HTML_CMARK
     markdownTranscoder = new CmarkGfmMarkdownTranscoder{};
@@ -137,6 +141,91 @@ void HtmlOutlineRepresentation::outlineMetadataToHtml(const Outline* outline, st
     }
 }
 
+void HtmlOutlineRepresentation::outlineHeaderToHtml(const Outline* outline, string& html)
+{
+    // table
+    html +=
+            "<table style='width: 100%; border-collapse: collapse; border: none;'>"
+            "<tr style='border-collapse: collapse; border: none;'>"
+            "<td style='border-collapse: collapse; border: none;'>"
+            "<h2>";
+    html += outline->getName();
+    html += "</h2>";
+
+    // O type
+    outlineTypeToHtml(outline->getType(), html);
+
+    // tags, reads/writes and timestamps
+    // IMPROVE show rs/ws/... only if it's MF repository (hide it otherwise) + configuration allows to hide it in all cases
+    outlineMetadataToHtml(outline, html);
+    html +=
+            "</td>"
+            "<td style='width: 50px; border-collapse: collapse; border: none;'>";
+    if(outline->getProgress()) {
+        html += "<h1>";
+        html += std::to_string(outline->getProgress());
+        html += "%&nbsp;&nbsp;</h1>";
+    }
+    html +=
+            "</td>"
+            "<td style='width: 50px; border-collapse: collapse; border: none;'>"
+            "<table style='font-size: 100%; border-collapse: collapse; border: none;'>"
+            "<tr style='border-collapse: collapse; border: none;'>";
+    if(outline->getImportance() || outline->getUrgency()) {
+        if(outline->getImportance() > 0) {
+            for(int i=0; i<=4; i++) {
+                html += "<td style='border-collapse: collapse; border: none;'>";
+                if(outline->getImportance()>i) {
+                    html += "&#"+std::to_string(U_CODE_IMPORTANCE_ON)+";";
+                } else {
+                    html += "&#"+std::to_string(U_CODE_IMPORTANCE_OFF)+";";
+                }
+                html += "</td>";
+            }
+        } else {
+            for(int i=0; i<5; i++) {
+                html +=
+                        "<td style='border-collapse: collapse; border: none;'>"
+                        "&#"+std::to_string(U_CODE_IMPORTANCE_OFF)+";"
+                        "</td>";
+            }
+        }
+        html +=
+                "</tr>"
+                "<tr style='border-collapse: collapse; border: none;'>";
+        if(outline->getUrgency()>0) {
+            for(int i=0; i<=4; i++) {
+                if(outline->getUrgency()>i) {
+                    html +=
+                            "<td style='border-collapse: collapse; border: none;'>"
+                            "&#"+std::to_string(U_CODE_URGENCY_ON)+";"
+                            "</td>";
+                } else {
+                    html +=
+                            "<td style='border-collapse: collapse; border: none;'>"
+                            "&#"+std::to_string(U_CODE_URGENCY_OFF)+";"
+                            "</td>";
+                }
+            }
+        } else {
+            for(int i=0; i<5; i++) {
+                html +=
+                        "<td style='border-collapse: collapse; border: none;'>"
+                        "&#"+std::to_string(U_CODE_URGENCY_OFF)+";"
+                        "</td>";
+            }
+        }
+    }
+    html +=
+            "</tr></table>"
+            "</td>"
+            "</tr></table>";
+
+    // O tags
+    tagsToHtml(outline->getTags(), html);
+    html += "<br/>";
+}
+
 void HtmlOutlineRepresentation::header(string& html, string* basePath, bool standalone, int yScrollTo)
 {
     if(!config.isUiHtmlTheme()) {
@@ -280,17 +369,7 @@ string* HtmlOutlineRepresentation::to(const string* markdown, string* html, stri
     } else {
         html->clear();
         header(*html, basePath, standalone, yScrollTo);
-
-        if(markdown->size() > 0) {
-#ifdef MF_NO_MD_2_HTML
-            html->append("<pre>");
-            html->append(*markdown);
-            html->append("</pre>");
-#else
-            markdownTranscoder->to(RepresentationType::HTML, markdown, html);
-#endif
-        }
-
+        transcode(*markdown, *html);
         footer(*html);
     }
 
@@ -301,6 +380,159 @@ string* HtmlOutlineRepresentation::to(const string* markdown, string* html, stri
     return html;
 }
 
+size_t HtmlOutlineRepresentation::getConfigurationHash(bool standalone)
+{
+    // header and footer reflect HTML theme, CSS, colors and enabled JavaScript libs
+    string html{};
+    header(html, nullptr, standalone, 0);
+    footer(html);
+    html += config.getUiThemeName();
+    html += "\t";
+    html += std::to_string(config.getMd2HtmlOptions());
+    html += config.isAutolinkingCaseInsensitive()?"\ti":"\t";
+    html += config.isAutolinkingColonSplit()?"\tc":"\t";
+    return std::hash<string>{}(html);
+}
+
+void HtmlOutlineRepresentation::transcode(const string& markdown, string& html)
+{
+    if(markdown.size() > 0) {
+#ifdef MF_NO_MD_2_HTML
+        html.append("<pre>");
+        html.append(markdown);
+        html.append("</pre>");
+#else
+        markdownTranscoder->to(RepresentationType::HTML, &markdown, &html);
+#endif
+    }
+}
+
+void HtmlOutlineRepresentation::transcode(
+    const string& header,
+    const vector<string*>& lines,
+    string& html
+) {
+    if(header.size() || lines.size()) {
+#ifdef MF_NO_MD_2_HTML
+        html += "<pre>";
+        html += header;
+        for(const string* line:lines) {
+            html += *line;
+            html += "\n";
+        }
+        html += "</pre>";
+#else
+        markdownTranscoder->to(RepresentationType::HTML, header, lines, &html);
+#endif
+    }
+}
+
+size_t HtmlOutlineRepresentation::estimateHtmlSize(const Outline* outline, bool whole)
+{
+    // HTML is typically ~1.5x bigger than MD + HTML header (scripts, CSS) + O header
+    size_t size{5000};
+    for(const string* line:outline->getDescription()) {
+        size += line->size()+1;
+    }
+    if(whole) {
+        for(const Note* note:outline->getNotes()) {
+            size += note->getName().size()+200;
+            for(const string* line:note->getDescription()) {
+                size += line->size()+1;
+            }
+        }
+    }
+    return size + size/2;
+}
+
+void HtmlOutlineRepresentation::noteToHtmlFragment(
+    const Note* note,
+    string& html,
+    bool descriptionOnly,
+    bool metadata,
+    bool autolinking
+) {
+    RepresentationInterceptor* interceptor = markdownRepresentation.getDescriptionInterceptor();
+    autolinking = autolinking && interceptor;
+
+    string md{};
+    md.reserve(MarkdownOutlineRepresentation::AVG_NOTE_SIZE);
+    if(!descriptionOnly) {
+        markdownRepresentation.toHeader(note, &md, metadata);
+    }
+
+    // section header (w/ metadata) and description are hashed - cheaper than autolinking and transcoding
+    std::hash<string> hasher{};
+    size_t mdHash = hasher(md);
+    for(const string* line:note->getDescription()) {
+        mdHash = mdHash*31 + hasher(*line);
+    }
+    unsigned flags = (descriptionOnly?DESCRIPTION_ONLY:0) | (metadata?METADATA:0);
+    if(autolinking) {
+        flags |= AUTOLINKING;
+        if(config.isAutolinkingCaseInsensitive()) {
+            flags |= CASE_INSENSITIVE;
+        }
+    }
+    // O revision changes on any N change, but O header fragment (description) doesn't depend on it
+    const uint32_t revision = descriptionOnly?0:note->getRevision();
+    const uint64_t generation = autolinking?interceptor->getGeneration():0;
+    const unsigned md2HtmlOptions = config.getMd2HtmlOptions();
+
+    {
+        lock_guard<mutex> criticalSection{fragmentsMutex};
+        auto f = fragments.find(note);
+        if(f != fragments.end()
+           && f->second.revision == revision
+           && f->second.generation == generation
+           && f->second.md2HtmlOptions == md2HtmlOptions
+           && f->second.flags == flags
+           && f->second.mdHash == mdHash)
+        {
+            fragmentHits++;
+            html += f->second.html;
+            return;
+        }
+    }
+
+    MF_DEBUG("[HTML] fragment MISS: " << note->getName() << endl);
+    fragmentMisses++;
+
+    // fragment is transcoded directly to the output - header and description
+    // lines are fed to the transcoder w/o joining them to MD string
+    const size_t offset = html.size();
+    bool complete{true};
+    if(autolinking) {
+        string amd{};
+        amd.reserve(1000);
+        complete = interceptor->processDescription(note, amd);
+        transcode(md, vector<string*>{&amd}, html);
+    } else {
+        transcode(md, note->getDescription(), html);
+    }
+
+    // incomplete (partially autolinked) fragments are not cached
+    if(complete) {
+        lock_guard<mutex> criticalSection{fragmentsMutex};
+        if(fragments.size() >= FRAGMENT_CACHE_CAPACITY) {
+            fragments.clear();
+        }
+        Fragment& f = fragments[note];
+        f.revision = revision;
+        f.generation = generation;
+        f.md2HtmlOptions = md2HtmlOptions;
+        f.flags = flags;
+        f.mdHash = mdHash;
+        f.html.assign(html, offset, string::npos);
+    }
+}
+
+void HtmlOutlineRepresentation::clearFragments()
+{
+    lock_guard<mutex> criticalSection{fragmentsMutex};
+    fragments.clear();
+}
+
 string* HtmlOutlineRepresentation::toNoMeta(Outline* outline, string* html, bool standalone, int yScrollTo)
 {
     // IMPROVE markdown can be processed by Mind to be enriched with various links and relationships
@@ -334,134 +566,28 @@ string* HtmlOutlineRepresentation::to(
     } else {
         string htmlHeader{};
         htmlHeader.reserve(1000);
-
-        // table
-        htmlHeader =
-                "<body>" // body tag is later replaced in generated HTML > must be present in the header
-                "<table style='width: 100%; border-collapse: collapse; border: none;'>"
-                "<tr style='border-collapse: collapse; border: none;'>"
-                "<td style='border-collapse: collapse; border: none;'>"
-                "<h2>";
-        htmlHeader += outline->getName();
-        htmlHeader += "</h2>";
-
-        // O type
-        outlineTypeToHtml(outline->getType(), htmlHeader);
-
-        // tags, reads/writes and timestamps
-        // IMPROVE show rs/ws/... only if it's MF repository (hide it otherwise) + configuration allows to hide it in all cases
-        outlineMetadataToHtml(outline, htmlHeader);
-        htmlHeader +=
-                "</td>"
-                "<td style='width: 50px; border-collapse: collapse; border: none;'>";
-        if(outline->getProgress()) {
-            htmlHeader += "<h1>";
-            htmlHeader += std::to_string(outline->getProgress());
-            htmlHeader += "%&nbsp;&nbsp;</h1>";
-        }
-        htmlHeader +=
-                "</td>"
-                "<td style='width: 50px; border-collapse: collapse; border: none;'>"
-                "<table style='font-size: 100%; border-collapse: collapse; border: none;'>"
-                "<tr style='border-collapse: collapse; border: none;'>";
-        if(outline->getImportance() || outline->getUrgency()) {
-            if(outline->getImportance() > 0) {
-                for(int i=0; i<=4; i++) {
-                    htmlHeader += "<td style='border-collapse: collapse; border: none;'>";
-                    if(outline->getImportance()>i) {
-                        htmlHeader += "&#"+std::to_string(U_CODE_IMPORTANCE_ON)+";";
-                    } else {
-                        htmlHeader += "&#"+std::to_string(U_CODE_IMPORTANCE_OFF)+";";
-                    }
-                    htmlHeader += "</td>";
-                }
-            } else {
-                for(int i=0; i<5; i++) {
-                    htmlHeader +=
-                            "<td style='border-collapse: collapse; border: none;'>"
-                            "&#"+std::to_string(U_CODE_IMPORTANCE_OFF)+";"
-                            "</td>";
-                }
-            }
-            htmlHeader +=
-                    "</tr>"
-                    "<tr style='border-collapse: collapse; border: none;'>";
-            if(outline->getUrgency()>0) {
-                for(int i=0; i<=4; i++) {
-                    if(outline->getUrgency()>i) {
-                        htmlHeader +=
-                                "<td style='border-collapse: collapse; border: none;'>"
-                                "&#"+std::to_string(U_CODE_URGENCY_ON)+";"
-                                "</td>";
-                    } else {
-                        htmlHeader +=
-                                "<td style='border-collapse: collapse; border: none;'>"
-                                "&#"+std::to_string(U_CODE_URGENCY_OFF)+";"
-                                "</td>";
-                    }
-                }
-            } else {
-                for(int i=0; i<5; i++) {
-                    htmlHeader +=
-                            "<td style='border-collapse: collapse; border: none;'>"
-                            "&#"+std::to_string(U_CODE_URGENCY_OFF)+";"
-                            "</td>";
-                }
-            }
-        }
-        htmlHeader +=
-                "</tr></table>"
-                "</td>"
-                "</tr></table>";
-
-        // O tags
-        tagsToHtml(outline->getTags(), htmlHeader);
-        htmlHeader += "<br/>";
+        outlineHeaderToHtml(outline, htmlHeader);
 
         // HTML completion
-        string outlineMd{};
         string path, file;
         pathToDirectoryAndFile(outline->getKey(), path, file);
 
-        // O header
-        if(autolinking) {
-            markdownRepresentation.toDescription(
-                outline->getOutlineDescriptorAsNote(),
-                &outlineMd,
-                autolinking
-            );
-        } else {
-            outlineMd.append(
-                outline->getOutlineDescriptorAsNote()->getDescriptionAsString()
-            );
-        }
-        // Ns
+        // O HTML is assembled from (cached) HTML fragments of O header and Ns
+        // in a single pre-sized buffer
+        html->clear();
+        html->reserve(estimateHtmlSize(outline, whole));
+        header(*html, &path, false, yScrollTo);
+        // inject custom HTML header
+        *html += htmlHeader;
+        noteToHtmlFragment(outline->getOutlineDescriptorAsNote(), *html, true, false, autolinking);
         if(whole) {
-            const vector<Note*>& notes=outline->getNotes();
-            if(notes.size()) {
-                string noteMd{};
-                for(Note* note:notes) {
-                    outlineMd.append("\n");
-                    // TODO MD representation to render also tags as HTML injected code (under section)
-                    markdownRepresentation.to(
-                        note,
-                        &noteMd,
-                        outline->getFormat()==MarkdownDocument::Format::MINDFORGER,
-                        autolinking
-                    );
-                    outlineMd.append(noteMd);
-                    noteMd.clear();
-                }
+            const bool metadata = outline->getFormat()==MarkdownDocument::Format::MINDFORGER;
+            for(Note* note:outline->getNotes()) {
+                // TODO MD representation to render also tags as HTML injected code (under section)
+                noteToHtmlFragment(note, *html, false, metadata, autolinking);
             }
         }
-
-        // MD 2 HTML
-        to(&outlineMd, html, &path, false, yScrollTo);
-        // inject custom HTML header
-        html->replace(
-                    html->find("<body>"), // <body> element index
-                    6, // <body> element length (chars to be replaced)
-                    htmlHeader); // new string
+        footer(*html);
     }
 
 #ifdef MF_DEBUG_HTML
@@ -480,12 +606,20 @@ string* HtmlOutlineRepresentation::to(
     bool autolinking,
     int yScrollTo)
 {
+    string path, file;
+    pathToDirectoryAndFile(note->getOutlineKey(), path, file);
+
+    if(config.isUiHtmlTheme()) {
+        html->clear();
+        header(*html, &path, false, yScrollTo);
+        noteToHtmlFragment(note, *html, false, true, autolinking);
+        footer(*html);
+        return html;
+    }
+
     string* markdown = new string{};
     markdown->reserve(MarkdownOutlineRepresentation::AVG_NOTE_SIZE);
     markdownRepresentation.to(note, markdown, true, autolinking);
-
-    string path, file;
-    pathToDirectoryAndFile(note->getOutlineKey(), path, file);
     to(markdown, html, &path, false, yScrollTo);
     delete markdown;
     return html;
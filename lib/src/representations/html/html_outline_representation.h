@@ -19,7 +19,10 @@
 #ifndef M8R_HTML_OUTLINE_REPRESENTATION_H_
 #define M8R_HTML_OUTLINE_REPRESENTATION_H_
 
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../../config/configuration.h"
@@ -71,11 +74,41 @@ public:
  */
 class HtmlOutlineRepresentation
 {
+    // live preview is assembled from header, footer and transcoded blocks
+    friend class HtmlLivePreview;
+
+public:
+    // fragment cache is dropped when full
+    static constexpr size_t FRAGMENT_CACHE_CAPACITY = 1<<13;
+
 private:
     // Performance hints:
     //  - += is ~2x faster than append() (depends on cpp lib implementation)
     //  - pre-allocation of the string using reserver() is critical to avoid slow re-allocations
-    //  - IMPROVE consider caching of re-used HTML snippets
+    //  - HTML of Ns is cached as fragments > O HTML is assembled from fragments and only
+    //    changed Ns are transcoded
+
+    /**
+     * @brief HTML fragment of N.
+     *
+     * Fragment is valid while N's revision, Markdown source (hash), rendering options
+     * and autolinking generation are the same.
+     */
+    struct Fragment {
+        uint32_t revision;
+        uint64_t generation;
+        unsigned md2HtmlOptions;
+        unsigned flags;
+        size_t mdHash;
+        std::string html;
+    };
+
+    enum FragmentFlags {
+        DESCRIPTION_ONLY = 1<<0,
+        METADATA = 1<<1,
+        AUTOLINKING = 1<<2,
+        CASE_INSENSITIVE = 1<<3
+    };
 
     Configuration& config;
     HtmlExportColorsRepresentation exportColors;
@@ -83,6 +116,12 @@ private:
     MarkdownOutlineRepresentation markdownRepresentation;
     MarkdownTranscoder* markdownTranscoder;
 
+    std::mutex fragmentsMutex;
+    std::unordered_map<const Note*,Fragment> fragments;
+
+    std::atomic<unsigned> fragmentHits;
+    std::atomic<unsigned> fragmentMisses;
+
 public:
     /**
      * @brief Html O representation.
@@ -141,6 +180,14 @@ public:
         int yScrollTo=0
     );
 
+    /**
+     * @brief Hash of configuration and theme which affect rendered HTML.
+     *
+     * HTML rendered w/ different hash must be rendered again - used to invalidate
+     * (incremental) exports.
+     */
+    size_t getConfigurationHash(bool standalone=false);
+
     /**
      * @brief Append "color: 0x...; background-color: 0x...;"
      */
@@ -150,13 +197,46 @@ public:
     void organizerTypeToHtml(const Organizer* organizer, std::string& html);
     void tagsToHtml(const std::vector<const Tag*>* tags, std::string& html);
     void outlineMetadataToHtml(const Outline* outline, std::string& html);
+    /**
+     * @brief Append O header (name, type, metadata, progress, importance/urgency and tags).
+     */
+    void outlineHeaderToHtml(const Outline* outline, std::string& html);
 
     MarkdownOutlineRepresentation& getMarkdownRepresentation() { return markdownRepresentation; }
 
+    void clearFragments();
+    unsigned getFragmentHits() const { return fragmentHits; }
+    unsigned getFragmentMisses() const { return fragmentMisses; }
+    /**
+     * @brief How many times autolinking was incomplete (time limit exceeded) - compare
+     * it before/after rendering to find out whether user should be informed.
+     */
+    unsigned getAutolinkingIncompleteCount() const {
+        RepresentationInterceptor* i = markdownRepresentation.getDescriptionInterceptor();
+        return i?i->getIncompleteCount():0;
+    }
+
 private:
     void header(std::string& html, std::string* basePath, bool standalone, int yScrollTo);
     void footer(std::string& html);
 
+    /**
+     * @brief Transcode Markdown to HTML (body content only).
+     */
+    void transcode(const std::string& markdown, std::string& html);
+    void transcode(const std::string& header, const std::vector<std::string*>& lines, std::string& html);
+    static size_t estimateHtmlSize(const Outline* outline, bool whole);
+    /**
+     * @brief Append HTML fragment of N (or its description only) - cached fragment is used if valid.
+     */
+    void noteToHtmlFragment(
+        const Note* note,
+        std::string& html,
+        bool descriptionOnly,
+        bool metadata,
+        bool autolinking
+    );
+
     std::string* toNoMeta(Outline* outline, std::string* html, bool standalone, int yScrollTo);
 };
 
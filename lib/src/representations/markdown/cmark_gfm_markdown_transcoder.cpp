@@ -45,6 +45,44 @@ CmarkGfmMarkdownTranscoder::~CmarkGfmMarkdownTranscoder()
 {
 }
 
+size_t CmarkGfmMarkdownTranscoder::getSectionDepthOverflow(const string& markdown)
+{
+    const size_t CMARK_MAX_SECTION_DEPTH=6;
+    if(markdown.length()>CMARK_MAX_SECTION_DEPTH && markdown.at(CMARK_MAX_SECTION_DEPTH)=='#') {
+        size_t i=0;
+        while(markdown.at(i)=='#') {
+            i++;
+        }
+        return i>=CMARK_MAX_SECTION_DEPTH?i-CMARK_MAX_SECTION_DEPTH:0;
+    }
+    return 0;
+}
+
+#ifdef MF_MD_2_HTML_CMARK
+static cmark_parser* cmarkNewParser(cmark_llist* syntaxExtensions)
+{
+    // TODO parse options
+    cmark_parser* parser = cmark_parser_new(CMARK_OPT_DEFAULT | CMARK_OPT_UNSAFE);
+    for(cmark_llist* tmp = syntaxExtensions; tmp; tmp = tmp->next) {
+        cmark_parser_attach_syntax_extension(parser, (cmark_syntax_extension*)tmp->data);
+    }
+    return parser;
+}
+
+static void cmarkRenderHtml(cmark_parser* parser, cmark_mem* mem, string* html)
+{
+    cmark_node* doc = cmark_parser_finish(parser);
+    if(doc) {
+        char *rendered_html = cmark_render_html_with_mem(doc, CMARK_OPT_DEFAULT | CMARK_OPT_UNSAFE, parser->syntax_extensions, mem);
+        if (rendered_html) {
+            html->append(rendered_html);
+            free(rendered_html);
+        }
+        cmark_node_free(doc);
+    }
+}
+#endif
+
 string* CmarkGfmMarkdownTranscoder::to(RepresentationType format, const string* markdown, string* html)
 {
     // options
@@ -55,37 +93,17 @@ string* CmarkGfmMarkdownTranscoder::to(RepresentationType format, const string*
 #ifdef MF_MD_2_HTML_CMARK
     if(format == RepresentationType::HTML) {
         // preprocessing: cmark-gfm is NOT able to render sections w/ depth > 6 (###### at most)
-        size_t CMARK_MAX_SECTION_DEPTH=6;
-        int overflow=0;
-        if(markdown && markdown->length()>CMARK_MAX_SECTION_DEPTH && markdown->at(CMARK_MAX_SECTION_DEPTH)=='#') {
-            size_t i=0;
-            while(markdown->at(i)=='#') {
-                i++;
-            }
-            overflow=i>=CMARK_MAX_SECTION_DEPTH?i-CMARK_MAX_SECTION_DEPTH:0;
-        }
+        const size_t overflow = markdown?getSectionDepthOverflow(*markdown):0;
 
         // TODO make this method which takes input and provides output: cmark_to_html()
         cmark_mem* mem = cmark_get_default_mem_allocator();
         // TODO control which extensions to use in MindForger config
         cmark_llist* syntax_extensions = cmark_list_syntax_extensions(mem);
-        // TODO parse options
-        cmark_parser* parser = cmark_parser_new(CMARK_OPT_DEFAULT | CMARK_OPT_UNSAFE);
-        for (cmark_llist* tmp = syntax_extensions; tmp; tmp = tmp->next) {
-            cmark_parser_attach_syntax_extension(parser, (cmark_syntax_extension*)tmp->data);
-        }
+        cmark_parser* parser = cmarkNewParser(syntax_extensions);
         cmark_parser_feed(parser, markdown->c_str()+overflow, markdown->size()-overflow);
 
         //cmark_node* doc = cmark_parse_document (markdown->c_str(), markdown->size(), CMARK_OPT_DEFAULT | CMARK_OPT_UNSAFE);
-        cmark_node* doc = cmark_parser_finish(parser);
-        if(doc) {
-            char *rendered_html = cmark_render_html_with_mem(doc, CMARK_OPT_DEFAULT | CMARK_OPT_UNSAFE, parser->syntax_extensions, mem);
-            if (rendered_html) {
-                html->append(rendered_html);
-                free(rendered_html);
-            }
-            cmark_node_free(doc);
-        }
+        cmarkRenderHtml(parser, mem, html);
         cmark_llist_free(mem, syntax_extensions);
         cmark_parser_free(parser);
     }
@@ -98,4 +116,33 @@ string* CmarkGfmMarkdownTranscoder::to(RepresentationType format, const string*
     return html;
 }
 
+string* CmarkGfmMarkdownTranscoder::to(
+    RepresentationType format,
+    const string& header,
+    const vector<string*>& lines,
+    string* html
+) {
+#ifdef MF_MD_2_HTML_CMARK
+    if(format == RepresentationType::HTML) {
+        const size_t overflow = getSectionDepthOverflow(header);
+
+        cmark_mem* mem = cmark_get_default_mem_allocator();
+        cmark_llist* syntax_extensions = cmark_list_syntax_extensions(mem);
+        cmark_parser* parser = cmarkNewParser(syntax_extensions);
+        // parser is fed by line views - lines are NOT joined (copied) to Markdown string
+        cmark_parser_feed(parser, header.c_str()+overflow, header.size()-overflow);
+        for(const string* line:lines) {
+            cmark_parser_feed(parser, line->c_str(), line->size());
+            cmark_parser_feed(parser, "\n", 1);
+        }
+
+        cmarkRenderHtml(parser, mem, html);
+        cmark_llist_free(mem, syntax_extensions);
+        cmark_parser_free(parser);
+        return html;
+    }
+#endif
+    return MarkdownTranscoder::to(format, header, lines, html);
+}
+
 } // m8r namespace
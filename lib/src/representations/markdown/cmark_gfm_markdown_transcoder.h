@@ -63,7 +63,24 @@ public:
     virtual std::string* to(
             RepresentationType format,
             const std::string* markdown,
-            std::string* html);
+            std::string* html) override;
+
+    /**
+     * @brief Feed header and lines to cmark parser w/o joining them to Markdown string.
+     */
+    virtual std::string* to(
+            RepresentationType format,
+            const std::string& header,
+            const std::vector<std::string*>& lines,
+            std::string* html) override;
+
+private:
+    /**
+     * @brief Number of leading #s which cannot be rendered by cmark-gfm.
+     *
+     * cmark-gfm is NOT able to render sections w/ depth > 6 (###### at most).
+     */
+    static size_t getSectionDepthOverflow(const std::string& markdown);
 };
 
 }
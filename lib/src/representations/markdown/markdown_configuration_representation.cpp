@@ -34,6 +34,10 @@ constexpr const auto CONFIG_SETTING_MIND_TIME_SCOPE_LABEL = "* Time scope: ";
 constexpr const auto CONFIG_SETTING_MIND_TAGS_SCOPE_LABEL = "* Tags scope: ";
 constexpr const auto CONFIG_SETTING_MIND_DISTRIBUTOR_INTERVAL = "* Async refresh interval (ms): ";
 constexpr const auto CONFIG_SETTING_MIND_AUTOLINKING = "* Autolinking: ";
+constexpr const auto CONFIG_SETTING_MIND_AUTOLINKING_TIME_LIMIT = "* Autolinking time limit (ms): ";
+constexpr const auto CONFIG_SETTING_MIND_AA_WORKERS = "* AI worker threads: ";
+constexpr const auto CONFIG_SETTING_MIND_AA_LSH_BANDS = "* AI candidate hash bands: ";
+constexpr const auto CONFIG_SETTING_MIND_AA_LSH_NOTES_THRESHOLD = "* AI candidate hash threshold (Notes): ";
 
 // application
 constexpr const auto CONFIG_SETTING_STARTUP_VIEW_LABEL = "* Startup view: ";
@@ -379,6 +383,62 @@ void MarkdownConfigurationRepresentation::configurationSection(
                         }
                         i %= 10000;
                         c.setDistributorSleepInterval(i);
+                    } else if(line->find(CONFIG_SETTING_MIND_AA_WORKERS) != std::string::npos) {
+                        string t = line->substr(strlen(CONFIG_SETTING_MIND_AA_WORKERS));
+                        std::string::size_type st;
+                        int i;
+                        try {
+                          i = std::stoi (t,&st);
+                        }
+                        catch(...) {
+                          i = Configuration::DEFAULT_AA_WORKERS;
+                        }
+                        if(i<0 || i>Configuration::MAX_AA_WORKERS) {
+                            i=Configuration::DEFAULT_AA_WORKERS;
+                        }
+                        c.setAaWorkers(i);
+                    } else if(line->find(CONFIG_SETTING_MIND_AA_LSH_BANDS) != std::string::npos) {
+                        string t = line->substr(strlen(CONFIG_SETTING_MIND_AA_LSH_BANDS));
+                        std::string::size_type st;
+                        int i;
+                        try {
+                          i = std::stoi (t,&st);
+                        }
+                        catch(...) {
+                          i = Configuration::DEFAULT_AA_LSH_BANDS;
+                        }
+                        if(i<0 || i>Configuration::MAX_AA_LSH_BANDS) {
+                            i=Configuration::DEFAULT_AA_LSH_BANDS;
+                        }
+                        c.setAaLshBands(i);
+                    } else if(line->find(CONFIG_SETTING_MIND_AA_LSH_NOTES_THRESHOLD) != std::string::npos) {
+                        string t = line->substr(strlen(CONFIG_SETTING_MIND_AA_LSH_NOTES_THRESHOLD));
+                        std::string::size_type st;
+                        int i;
+                        try {
+                          i = std::stoi (t,&st);
+                        }
+                        catch(...) {
+                          i = Configuration::DEFAULT_AA_LSH_NOTES_THRESHOLD;
+                        }
+                        if(i<0 || i>Configuration::MAX_AA_LSH_NOTES_THRESHOLD) {
+                            i=Configuration::DEFAULT_AA_LSH_NOTES_THRESHOLD;
+                        }
+                        c.setAaLshNotesThreshold(i);
+                    } else if(line->find(CONFIG_SETTING_MIND_AUTOLINKING_TIME_LIMIT) != std::string::npos) {
+                        string t = line->substr(strlen(CONFIG_SETTING_MIND_AUTOLINKING_TIME_LIMIT));
+                        std::string::size_type st;
+                        int i;
+                        try {
+                          i = std::stoi (t,&st);
+                        }
+                        catch(...) {
+                          i = Configuration::DEFAULT_AUTOLINKING_TIME_LIMIT;
+                        }
+                        if(i<0 || i>Configuration::MAX_AUTOLINKING_TIME_LIMIT) {
+                            i=Configuration::DEFAULT_AUTOLINKING_TIME_LIMIT;
+                        }
+                        c.setAutolinkingTimeLimit(i);
                     } else if(line->find(CONFIG_SETTING_MIND_AUTOLINKING) != std::string::npos) {
                         if(line->find("yes") != std::string::npos) {
                             c.setAutolinking(true);
@@ -474,8 +534,20 @@ string& MarkdownConfigurationRepresentation::to(Configuration* c, string& md)
          CONFIG_SETTING_MIND_DISTRIBUTOR_INTERVAL << (c?c->getDistributorSleepInterval():Configuration::DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL+1) << endl <<
          "    * Sleep interval (miliseconds) between asynchronous mind-related evaluations (associations, ...)" << endl <<
          "    * Examples: 500, 1000, 3000, 5000" << endl <<
+         CONFIG_SETTING_MIND_AA_WORKERS << (c?c->getAaWorkers():Configuration::DEFAULT_AA_WORKERS) << endl <<
+         "    * Number of threads used to assess associations (0 ~ derived from number of CPUs)" << endl <<
+         "    * Examples: 0, 2, 4" << endl <<
+         CONFIG_SETTING_MIND_AA_LSH_BANDS << (c?c->getAaLshBands():Configuration::DEFAULT_AA_LSH_BANDS) << endl <<
+         "    * Associations of big repositories are assessed for candidate Notes only - more bands find more candidates (0 ~ assess all Notes)" << endl <<
+         "    * Examples: 0, 8, 16, 32" << endl <<
+         CONFIG_SETTING_MIND_AA_LSH_NOTES_THRESHOLD << (c?c->getAaLshNotesThreshold():Configuration::DEFAULT_AA_LSH_NOTES_THRESHOLD) << endl <<
+         "    * Candidate Notes are used by repositories with more Notes than the threshold" << endl <<
+         "    * Examples: 0, 2000, 10000" << endl <<
          CONFIG_SETTING_MIND_AUTOLINKING << (c?(c->isAutolinking()?"yes":"no"):(Configuration::DEFAULT_AUTOLINKING?"yes":"no")) << endl <<
          "    * Examples: yes, no" << endl <<
+         CONFIG_SETTING_MIND_AUTOLINKING_TIME_LIMIT << (c?c->getAutolinkingTimeLimit():Configuration::DEFAULT_AUTOLINKING_TIME_LIMIT) << endl <<
+         "    * Links are not injected to the rest of the Note once the limit is exceeded (0 ~ unlimited)" << endl <<
+         "    * Examples: 0, 100, 250, 1000" << endl <<
          endl <<
 
          "# " << CONFIG_SECTION_APP << endl <<
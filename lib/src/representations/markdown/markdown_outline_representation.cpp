@@ -487,6 +487,17 @@ string* MarkdownOutlineRepresentation::to(const Note* note, string* md, bool inc
 {
     md->clear();
 
+    toHeader(note, md, includeMetadata);
+
+    MF_DEBUG("= BEFORE autolinking =============================" << endl << md << endl);
+    toDescription(note, md, autolinking);
+    MF_DEBUG("= AFTER autolinking ==============================" << endl << md << endl);
+
+    return md;
+}
+
+string* MarkdownOutlineRepresentation::toHeader(const Note* note, string* md, bool includeMetadata)
+{
     if(!note->isPostDeclaredSection()) {
         for(int i=0; i<=note->getDepth(); i++) {
             md->append("#");
@@ -537,10 +548,6 @@ string* MarkdownOutlineRepresentation::to(const Note* note, string* md, bool inc
         md->append("\n");
     }
 
-    MF_DEBUG("= BEFORE autolinking =============================" << endl << md << endl);
-    toDescription(note, md, autolinking);
-    MF_DEBUG("= AFTER autolinking ==============================" << endl << md << endl);
-
     return md;
 }
 
@@ -549,7 +556,7 @@ string* MarkdownOutlineRepresentation::toDescription(const Note* note, string* m
     if(descriptionInterceptor && autolinking) {
         string amd{};
         amd.reserve(1000);
-        descriptionInterceptor->process(note->getDescription(), amd);
+        descriptionInterceptor->processDescription(note, amd);
         if(md) {
             md->append(amd);
         }
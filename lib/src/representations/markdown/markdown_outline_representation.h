@@ -91,6 +91,10 @@ public:
     virtual std::string* toHeader(Outline* outline);
     virtual std::string* to(const Note* note);
     virtual std::string* to(const Note* note, std::string* md, bool includeMetadata=true, bool autolinking=false);
+    /**
+     * @brief Append N's section header (name, metadata and underline) i.e. N w/o description.
+     */
+    virtual std::string* toHeader(const Note* note, std::string* md, bool includeMetadata=true);
     virtual std::string* toDescription(const Note* note, std::string* md, bool autolinking=false);
 
     static std::string to(const std::vector<const Tag*>* tags);
@@ -102,6 +106,7 @@ public:
     virtual std::string* toc(const Outline* outline, bool tags=true, bool links=true);
 
     Ontology& getOntology() { return ontology; }
+    RepresentationInterceptor* getDescriptionInterceptor() const { return descriptionInterceptor; }
 
 private:
     Outline* outline(std::vector<MarkdownAstNodeSection*>* ast);
@@ -20,6 +20,7 @@
 #define M8R_MARKDOWN_TRANSCODER_H
 
 #include <string>
+#include <vector>
 
 #include "../representation_type.h"
 
@@ -78,6 +79,27 @@ public:
             const std::string* markdown,
             std::string* representation) = 0;
 
+    /**
+     * @brief Convert Markdown section to given representation.
+     *
+     * Section is given as header (section name and metadata) and (description)
+     * lines - transcoders which can consume input incrementally should avoid
+     * joining lines to a Markdown string. Result is appended to representation.
+     */
+    virtual std::string* to(
+            const RepresentationType representationType,
+            const std::string& header,
+            const std::vector<std::string*>& lines,
+            std::string* representation)
+    {
+        std::string markdown{header};
+        for(const std::string* line:lines) {
+            markdown += *line;
+            markdown += "\n";
+        }
+        return to(representationType, &markdown, representation);
+    }
+
 };
 
 }
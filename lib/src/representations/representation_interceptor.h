@@ -19,9 +19,12 @@
 #ifndef M8R_REPRESENTATION_INTERCEPTOR_H
 #define M8R_REPRESENTATION_INTERCEPTOR_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#include "../model/note.h"
+
 namespace m8r {
 
 class RepresentationInterceptor
@@ -30,6 +33,29 @@ public:
     virtual ~RepresentationInterceptor() {}
 
     virtual void process(const std::vector<std::string*>& in, std::string& out) = 0;
+
+    /**
+     * @brief Process N's description - interceptors may memoize the result per N.
+     *
+     * @return false if the output is incomplete (e.g. processing time limit was
+     *         exceeded) and it must not be cached.
+     */
+    virtual bool processDescription(const Note* note, std::string& out) {
+        process(note->getDescription(), out);
+        return true;
+    }
+
+    /**
+     * @brief Generation of the data used by interceptor - output cached by callers
+     * is stale once the generation changes.
+     */
+    virtual uint64_t getGeneration() const { return 0; }
+
+    /**
+     * @brief How many times the output was incomplete (e.g. processing time limit
+     * was exceeded) - callers compare it before/after processing to inform user.
+     */
+    virtual unsigned getIncompleteCount() const { return 0; }
 };
 
 }
@@ -19,10 +19,17 @@
 
 #include <string>
 #include <iostream>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <map>
 
 #include <gtest/gtest.h>
 
 #include "../../src/mind/mind.h"
+#include "../../src/mind/ai/aa_minhash_lsh.h"
+#include "../../src/mind/ai/nlp/markdown_tokenizer.h"
+#include "../../src/mind/ai/nlp/note_char_provider.h"
 
 using namespace std;
 using namespace m8r;
@@ -84,3 +91,254 @@ TEST(AiBenchmark, DISABLED_AaMatrix)
     // TODO to be rewritten mind.getAssociationsLeaderboard(n, lb);
     // TODO to be rewritten m8r::Ai::print(n,lb);
 }
+
+/*
+ * MinHash LSH AA candidates recall: AA.BoW leaderboards w/ LSH candidates vs. exact AA.BoW
+ * leaderboards (all Ns assessed) of the same Ns - recall@k, where k is the leaderboard size.
+ */
+static string toNoteId(const m8r::Note* n)
+{
+    return n->getOutline()->getKey() + "#" + std::to_string(n->getOutline()->getNoteOffset(n));
+}
+
+// AA.BoW leaderboards of (at most) given number of Ns evenly picked from repository, returns time in ms
+static double getAaLeaderboards(
+        const string& repositoryPath,
+        int bands,
+        size_t queries,
+        map<string,vector<string>>& leaderboards)
+{
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-aib-mhlr.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)), repositoryConfigRepresentation);
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+    config.setAaLshBands(bands);
+    // LSH candidates also for small repositories
+    config.setAaLshNotesThreshold(0);
+
+    m8r::Mind mind(config);
+    mind.learn();
+    mind.think().get();
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+    // Os order differs across learnings
+    std::sort(notes.begin(), notes.end(), [](const m8r::Note* n1, const m8r::Note* n2) {
+        int c = n1->getOutline()->getKey().compare(n2->getOutline()->getKey());
+        return c<0 || (c==0 && n1->getOutline()->getNoteOffset(n1)<n2->getOutline()->getNoteOffset(n2));
+    });
+    size_t step = notes.size()>queries?notes.size()/queries:1;
+
+    leaderboards.clear();
+    auto begin = chrono::high_resolution_clock::now();
+    for(size_t i=0; i<notes.size() && leaderboards.size()<queries; i+=step) {
+        // leaderboard is calculated async > cached leaderboard is copied by the second call
+        m8r::AssociatedNotes associations{m8r::ResourceType::NOTE, notes[i]};
+        mind.getAssociatedNotes(associations).get();
+        mind.getAssociatedNotes(associations).get();
+        vector<string>& leaderboard = leaderboards[toNoteId(notes[i])];
+        for(auto& a:*associations.getAssociations()) {
+            leaderboard.push_back(toNoteId(a.first));
+        }
+    }
+    auto end = chrono::high_resolution_clock::now();
+    return chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+}
+
+// recall@k of the default LSH setting, best recall@k of LSH settings
+static float measureMinHashLshRecall(const string& repository, size_t queries, float& bestRecall)
+{
+    string repositoryPath{repository};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+
+    map<string,vector<string>> exact{};
+    double exactTime = getAaLeaderboards(repositoryPath, 0, queries, exact);
+    cout << repository << ": exact leaderboards of " << exact.size() << " Ns: " << exactTime << "ms" << endl;
+
+    // AA leaderboard size
+    static const size_t K = 10;
+
+    // default bands must be among settings
+    int settings[] = {4,8,16,32,64};
+    float defaultRecall = 0;
+    bestRecall = 0;
+    for(int bands:settings) {
+        map<string,vector<string>> lsh{};
+        double lshTime = getAaLeaderboards(repositoryPath, bands, queries, lsh);
+
+        size_t found=0, relevant=0;
+        for(auto& e:exact) {
+            const vector<string>& candidates = lsh[e.first];
+            for(const string& n:e.second) {
+                relevant++;
+                if(std::find(candidates.begin(), candidates.end(), n) != candidates.end()) found++;
+            }
+        }
+
+        float recall = relevant?static_cast<float>(found)/relevant:1.f;
+        if(bands == m8r::Configuration::DEFAULT_AA_LSH_BANDS) {
+            defaultRecall = recall;
+        }
+        bestRecall = std::max(bestRecall, recall);
+        cout << "  LSH " << bands << " bands x " << m8r::MinHashLsh::DEFAULT_ROWS << " rows: recall@"
+             << K << " " << recall
+             << " (" << found << "/" << relevant << "), leaderboards " << lshTime << "ms" << endl;
+    }
+    return defaultRecall;
+}
+
+TEST(AiBenchmark, DISABLED_MinHashLshRecall)
+{
+    float bestRecall;
+
+    // small corpus: AA of its Ns w/ disjoint words is driven by the same O bonus - Ns of
+    // the same O are always candidates (recall was ~0.04 w/o O groups even w/ 64 bands)
+    EXPECT_LT(0.95f, measureMinHashLshRecall("/lib/test/resources/universe-repository", 1000, bestRecall));
+    // big corpus (above AA LSH threshold): recall@10 ~0.96 w/ 16 bands, ~0.98 w/ 64 bands
+    EXPECT_LT(0.9f, measureMinHashLshRecall("/lib/test/resources/benchmark-repository", 200, bestRecall));
+    EXPECT_LT(0.95f, bestRecall);
+}
+
+/*
+ * Tokenization of Ns (BoW learning) and N titles: narrowed N chars streamed via CharProvider
+ * vs. N name/description spans tokenized in place.
+ */
+TEST(AiBenchmark, DISABLED_Tokenizer)
+{
+    static const int ROUNDS = 5;
+
+    string repositoryPath{"/lib/test/resources/benchmark-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-aib-t.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)), repositoryConfigRepresentation);
+    m8r::Mind mind(config);
+    mind.learn();
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+    cout << "Tokenizing " << notes.size() << " Ns " << ROUNDS << "x" << endl;
+    ASSERT_LT(0, notes.size());
+
+    m8r::CommonWordsBlacklist blacklist{};
+    size_t charsWords = 0, spanWords = 0;
+
+    auto begin = chrono::high_resolution_clock::now();
+    for(int r=0; r<ROUNDS; r++) {
+        m8r::Lexicon lexicon{};
+        m8r::MarkdownTokenizer tokenizer{lexicon, blacklist};
+        for(m8r::Note* n:notes) {
+            m8r::NoteCharProvider chars{n};
+            m8r::WordFrequencyList wfl{&lexicon};
+            tokenizer.tokenize(chars, wfl);
+            charsWords += wfl.size();
+        }
+    }
+    auto charsEnd = chrono::high_resolution_clock::now();
+    for(int r=0; r<ROUNDS; r++) {
+        m8r::Lexicon lexicon{};
+        m8r::MarkdownTokenizer tokenizer{lexicon, blacklist};
+        for(m8r::Note* n:notes) {
+            m8r::WordFrequencyList wfl{&lexicon};
+            tokenizer.tokenize(n, wfl);
+            spanWords += wfl.size();
+        }
+    }
+    auto spanEnd = chrono::high_resolution_clock::now();
+
+    // titles: lowercase, no stemming, no blacklist
+    for(int r=0; r<ROUNDS; r++) {
+        m8r::Lexicon lexicon{};
+        m8r::MarkdownTokenizer tokenizer{lexicon, blacklist};
+        for(m8r::Note* n:notes) {
+            m8r::StringCharProvider chars{n->getName()};
+            m8r::WordFrequencyList wfl{&lexicon};
+            tokenizer.tokenize(chars, wfl, false, true, false);
+        }
+    }
+    auto charsTitlesEnd = chrono::high_resolution_clock::now();
+    for(int r=0; r<ROUNDS; r++) {
+        m8r::Lexicon lexicon{};
+        m8r::MarkdownTokenizer tokenizer{lexicon, blacklist};
+        for(m8r::Note* n:notes) {
+            m8r::WordFrequencyList wfl{&lexicon};
+            tokenizer.tokenize(n->getName(), wfl, false, true, false);
+        }
+    }
+    auto spanTitlesEnd = chrono::high_resolution_clock::now();
+
+    cout << "Ns     chars: " << chrono::duration_cast<chrono::microseconds>(charsEnd-begin).count()/1000.0 << "ms" << endl
+         << "Ns     spans: " << chrono::duration_cast<chrono::microseconds>(spanEnd-charsEnd).count()/1000.0 << "ms" << endl
+         << "titles chars: " << chrono::duration_cast<chrono::microseconds>(charsTitlesEnd-spanEnd).count()/1000.0 << "ms" << endl
+         << "titles spans: " << chrono::duration_cast<chrono::microseconds>(spanTitlesEnd-charsTitlesEnd).count()/1000.0 << "ms" << endl;
+
+    EXPECT_EQ(charsWords, spanWords);
+}
+
+/*
+ * BoW learning (tokenization to doc vectors) throughput w/o and w/ stems and word IDs memo caches
+ * on synthetic Zipfian corpus of 100k Ns.
+ *
+ * Results vary by tens of percent between runs on shared VMs - compare min-max of several runs
+ * of the same (-O2 w/o DO_MF_DEBUG) build.
+ */
+TEST(AiBenchmark, DISABLED_StemmerCache)
+{
+    static const size_t NOTES = 100000;
+    static const size_t WORDS_PER_NOTE = 60;
+    static const size_t VOCABULARY = 20000;
+
+    // vocabulary ~ random stems w/ English suffixes
+    std::mt19937 random{42};
+    std::uniform_int_distribution<int> letters('a', 'z');
+    std::uniform_int_distribution<int> lengths(3, 9);
+    const char* suffixes[] = {"", "s", "ing", "ed", "ation", "ly", "ness", "er"};
+    std::uniform_int_distribution<int> suffix(0, 7);
+    vector<string> vocabulary{};
+    for(size_t i=0; i<VOCABULARY; i++) {
+        string w{};
+        for(int l=lengths(random); l>0; l--) w += static_cast<char>(letters(random));
+        vocabulary.push_back(w+suffixes[suffix(random)]);
+    }
+    // Zipf: word rank r has probability ~ 1/r
+    vector<double> ranks{};
+    for(size_t r=1; r<=VOCABULARY; r++) ranks.push_back(1.0/r);
+    std::discrete_distribution<size_t> zipf(ranks.begin(), ranks.end());
+    vector<string> corpus{};
+    size_t bytes = 0;
+    for(size_t n=0; n<NOTES; n++) {
+        string text{};
+        for(size_t w=0; w<WORDS_PER_NOTE; w++) {
+            text += vocabulary[zipf(random)];
+            text += w%12==11 ? ".\n" : " ";
+        }
+        bytes += text.size();
+        corpus.push_back(text);
+    }
+    cout << "Corpus: " << NOTES << " Ns, " << bytes/1024/1024 << "MB" << endl;
+
+    m8r::CommonWordsBlacklist blacklist{};
+    size_t cacheCapacities[] = {0, m8r::Stemmer::DEFAULT_CACHE_CAPACITY};
+    size_t words[2] = {0, 0};
+    for(int c=0; c<2; c++) {
+        m8r::Lexicon lexicon{};
+        m8r::MarkdownTokenizer tokenizer{lexicon, blacklist};
+        tokenizer.getStemmer().setCacheCapacity(cacheCapacities[c]);
+        tokenizer.setWordIdsCacheCapacity(cacheCapacities[c]);
+
+        auto begin = chrono::high_resolution_clock::now();
+        for(const string& text:corpus) {
+            m8r::WordFrequencyList wfl{&lexicon};
+            tokenizer.tokenize(text, wfl);
+            words[c] += wfl.size();
+        }
+        auto end = chrono::high_resolution_clock::now();
+        auto ms = chrono::duration_cast<chrono::milliseconds>(end-begin).count();
+        cout << "Stems cache " << cacheCapacities[c] << ": " << ms << "ms ~ "
+             << (ms?NOTES*1000/ms:0) << " Ns/s, lexicon " << lexicon.size() << " words" << endl;
+    }
+
+    EXPECT_EQ(words[0], words[1]);
+}
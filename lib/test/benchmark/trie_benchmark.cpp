@@ -20,7 +20,14 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <set>
 #include <string>
+#include <chrono>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+#include <malloc.h>
+#define M8R_HEAP_USAGE
+#endif
 
 #include <gtest/gtest.h>
 
@@ -118,3 +125,199 @@ TEST(TrieBenchmark, DISABLED_TrieVsMap)
     MF_DEBUG(words.size() << " words SEARCHED in " << chrono::duration_cast<chrono::microseconds>(endTrieSearch-beginTrieSearch).count()/1000.0 << "ms" << endl);
     cout << "TRIE done" << endl;
 }
+
+#ifdef M8R_HEAP_USAGE
+static size_t heapUsage() { return mallinfo2().uordblks; }
+#else
+static size_t heapUsage() { return 0; }
+#endif
+
+namespace {
+
+/**
+ * @brief Trie layout before compaction (node per heap allocation, children vector
+ * of pointers searched linearly) - baseline for the compact trie.
+ */
+class NodePerAllocationTrie
+{
+private:
+    struct Node {
+        char content;
+        int refCount;
+        std::vector<Node*> children;
+
+        explicit Node(char c) : content(c), refCount(0), children{} {}
+        Node* findChild(char c) const {
+            for(Node* n:children) {
+                if(n->content==c) {
+                    return n;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    Node* root;
+
+public:
+    explicit NodePerAllocationTrie() : root(new Node(' ')) {}
+    NodePerAllocationTrie(const NodePerAllocationTrie&) = delete;
+    NodePerAllocationTrie(const NodePerAllocationTrie&&) = delete;
+    NodePerAllocationTrie& operator=(const NodePerAllocationTrie&) = delete;
+    NodePerAllocationTrie& operator=(const NodePerAllocationTrie&&) = delete;
+    ~NodePerAllocationTrie() { destroy(root); }
+
+    void addWord(const string& s) {
+        Node* current = root;
+        for(char c:s) {
+            Node* child = current->findChild(c);
+            if(!child) {
+                child = new Node(c);
+                current->children.push_back(child);
+            }
+            current = child;
+        }
+        if(s.size()) {
+            current->refCount++;
+        }
+    }
+    bool findWord(const string& s) const {
+        const Node* current = root;
+        for(char c:s) {
+            if(!(current = current->findChild(c))) {
+                return false;
+            }
+        }
+        return current->refCount>0;
+    }
+    bool findLongestPrefixWord(const string& s, string& r) const {
+        size_t longestWordSize{0};
+        const Node* current = root;
+        for(size_t i=0; i<s.size(); i++) {
+            if(!(current = current->findChild(s[i]))) {
+                break;
+            }
+            r += s[i];
+            if(current->refCount>0) {
+                longestWordSize = r.size();
+            }
+        }
+        if(longestWordSize) {
+            r = r.substr(0, longestWordSize);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    void destroy(Node* n) {
+        for(Node* c:n->children) {
+            destroy(c);
+        }
+        delete n;
+    }
+};
+
+template<class T> void benchmarkTrie(
+    const char* name,
+    const vector<string>& words,
+    const vector<string>& misses,
+    const string& text)
+{
+    size_t heapBefore = heapUsage();
+    auto beginBuild = chrono::high_resolution_clock::now();
+    T* trie = new T{};
+    for(const string& u:words) {
+        trie->addWord(u);
+    }
+    auto endBuild = chrono::high_resolution_clock::now();
+    size_t trieHeap = heapUsage()-heapBefore;
+
+    auto beginFind = chrono::high_resolution_clock::now();
+    size_t found = 0;
+    for(int r=0; r<10; r++) {
+        for(const string& u:words) found += trie->findWord(u);
+        for(const string& m:misses) found += trie->findWord(m);
+    }
+    auto endFind = chrono::high_resolution_clock::now();
+    ASSERT_EQ(10*words.size(), found);
+
+    auto beginPrefix = chrono::high_resolution_clock::now();
+    size_t prefixes = 0;
+    string r{};
+    for(size_t i=0; i+64<text.size(); i+=7) {
+        r.clear();
+        prefixes += trie->findLongestPrefixWord(text.substr(i, 64), r);
+    }
+    auto endPrefix = chrono::high_resolution_clock::now();
+
+    cout << name << " heap: " << trieHeap/1024 << "kB" << endl
+         << name << " build: " << chrono::duration_cast<chrono::microseconds>(endBuild-beginBuild).count()/1000.0 << "ms" << endl
+         << name << " find (10x): " << chrono::duration_cast<chrono::microseconds>(endFind-beginFind).count()/1000.0 << "ms" << endl
+         << name << " longest prefix: " << chrono::duration_cast<chrono::microseconds>(endPrefix-beginPrefix).count()/1000.0 << "ms"
+         << " (" << prefixes << " found)" << endl;
+
+    delete trie;
+}
+
+}
+
+/*
+ * Trie memory and lookups: unique words of 1.1M file - exact lookups of all words,
+ * longest prefix lookups of text suffixes (autolinking) and blacklist like misses.
+
+RESULT: node per heap allocation trie vs. compact trie (17320 unique words) - test
+build (g++ 12, -O1 -g, DO_MF_DEBUG, glibc malloc), x86_64 VM, single core - median of 3 runs,
+timings vary by +/-30% between runs:
+
+  heap              6156kB ->  2247kB (set 1451kB)
+  build             10.4ms  ->  7.2ms
+  find (10x)        77.5ms  -> 49.3ms (set ~56ms)
+  longest prefix    25.4ms  -> 15.8ms
+ */
+TEST(TrieBenchmark, DISABLED_TrieFootprintAndLookups)
+{
+    string fileName{"/lib/test/resources/benchmark-repository/memory/meta.md"};
+    fileName.insert(0, getMindforgerGitHomePath());
+    unique_ptr<string> text{m8r::fileToString(fileName)};
+    set<string> unique{};
+    string w{};
+    for(char c:*text) {
+        if(c==' ' || c=='\n' || c=='\t') {
+            if(w.size()) unique.insert(w);
+            w.clear();
+        } else {
+            w += c;
+        }
+    }
+    vector<string> words{unique.begin(), unique.end()};
+    vector<string> misses{};
+    for(string& u:words) misses.push_back(u+"~");
+    size_t chars = 0;
+    for(string& u:words) chars += u.size();
+    cout << "Words: " << words.size() << " unique, " << chars << " chars" << endl;
+
+    // set (reference)
+    size_t heapBefore = heapUsage();
+    set<string>* stringSet = new set<string>{words.begin(), words.end()};
+    size_t setHeap = heapUsage()-heapBefore;
+    auto beginSet = chrono::high_resolution_clock::now();
+    size_t found = 0;
+    for(int r=0; r<10; r++) {
+        for(string& u:words) found += stringSet->count(u);
+        for(string& m:misses) found += stringSet->count(m);
+    }
+    auto endSet = chrono::high_resolution_clock::now();
+    cout << "Set heap: " << setHeap/1024 << "kB" << endl
+         << "Set find (10x): " << chrono::duration_cast<chrono::microseconds>(endSet-beginSet).count()/1000.0 << "ms" << endl;
+    delete stringSet;
+
+    benchmarkTrie<NodePerAllocationTrie>("Node per allocation trie", words, misses, *text);
+    benchmarkTrie<Trie>("Compact trie", words, misses, *text);
+
+    Trie trie{};
+    for(string& u:words) {
+        trie.addWord(u);
+    }
+    cout << "Compact trie footprint: " << trie.getFootprint()/1024 << "kB, " << trie.size() << " nodes" << endl;
+}
@@ -32,6 +32,7 @@
 #include <cmark-gfm.h>
 
 #include "../../../src/gear/file_utils.h"
+#include "../../../src/mind/ai/autolinking/autolinking_index.h"
 #include "../../../src/mind/ai/autolinking/cmark_aho_corasick_block_autolinking_preprocessor.h"
 
 using namespace std;
@@ -380,6 +381,7 @@ TEST(AutolinkingCmarkTestCase, NanoRepo)
     m8r::Mind mind(config);
     mind.learn();
     mind.think().get();
+    mind.autolinkWaitForIndex();
     cout << endl << "Statistics:";
     cout << endl << "  Outlines: " << mind.remind().getOutlinesCount();
     cout << endl << "  Bytes   : " << mind.remind().getOutlineMarkdownsSize();
@@ -414,6 +416,7 @@ TEST(AutolinkingCmarkTestCase, MicroRepo)
     m8r::Mind mind(config);
     mind.learn();
     mind.think().get();
+    mind.autolinkWaitForIndex();
     cout << endl << "Statistics:";
     cout << endl << "  Outlines: " << mind.remind().getOutlinesCount();
     cout << endl << "  Bytes   : " << mind.remind().getOutlineMarkdownsSize();
@@ -443,6 +446,7 @@ TEST(AutolinkingCmarkTestCase, BasicRepo)
     m8r::Mind mind(config);
     mind.learn();
     mind.think().get();
+    mind.autolinkWaitForIndex();
     cout << endl << "Statistics:";
     cout << endl << "  Outlines: " << mind.remind().getOutlinesCount();
     cout << endl << "  Bytes   : " << mind.remind().getOutlineMarkdownsSize();
@@ -473,6 +477,7 @@ TEST(AutolinkingCmarkTestCase, Monster)
         m8r::Mind mind(config);
         mind.learn();
         mind.think().get();
+        mind.autolinkWaitForIndex();
         cout << endl << "Statistics:";
         cout << endl << "  Outlines: " << mind.remind().getOutlinesCount();
         cout << endl << "  Bytes   : " << mind.remind().getOutlineMarkdownsSize();
@@ -493,5 +498,145 @@ TEST(AutolinkingCmarkTestCase, Monster)
     }
 }
 
+TEST(AutolinkingCmarkTestCase, MemoAndTimeLimit)
+{
+    // GIVEN
+    string repositoryDir{"/tmp/mf-unit-repository-autolinking-memo"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string oKey{repositoryDir+"/memory/memo.md"};
+    string bigDescription{};
+    for(int i=0; i<20000; i++) {
+        bigDescription += "Apple and Banana text.\n\n";
+    }
+    m8r::stringToFile(oKey, "# Memo\n\nO.\n\n## Apple\nText of Banana.\n\n## Banana\nB.\n\n## Big\n"+bigDescription);
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-act-mtl.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)), repositoryConfigRepresentation);
+    config.setAutolinking(true);
+    config.setAutolinkingTimeLimit(0);
+    m8r::Mind mind(config);
+    mind.learn();
+    mind.think().get();
+    mind.autolinkWaitForIndex();
+    ASSERT_EQ(1, mind.remind().getOutlinesCount());
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    m8r::Note* apple = o->getNotes()[0];
+    m8r::Note* big = o->getNotes()[2];
+    ASSERT_EQ("Apple", apple->getName());
+    m8r::CmarkAhoCorasickBlockAutolinkingPreprocessor autolinker{mind};
+
+    // WHEN N is autolinked twice
+    string autolinkedMd{};
+    EXPECT_TRUE(autolinker.processDescription(apple, autolinkedMd));
+    const string expectedMd{autolinkedMd};
+    EXPECT_NE(string::npos, expectedMd.find("[Banana](mindforger://"));
+    EXPECT_EQ(0, autolinker.getMemoHits());
+    autolinkedMd.clear();
+    EXPECT_TRUE(autolinker.processDescription(apple, autolinkedMd));
+    // THEN memo is hit
+    EXPECT_EQ(1, autolinker.getMemoHits());
+    EXPECT_EQ(expectedMd, autolinkedMd);
+
+    // WHEN N revision changes
+    apple->incRevision();
+    EXPECT_TRUE(autolinker.processDescription(apple, autolinkedMd));
+    // THEN memo is missed (and refreshed)
+    EXPECT_EQ(1, autolinker.getMemoHits());
+    EXPECT_TRUE(autolinker.processDescription(apple, autolinkedMd));
+    EXPECT_EQ(2, autolinker.getMemoHits());
+
+    // WHEN autolinking index generation changes (new name)
+    const uint64_t generation = mind.autolinkGetIndex()->getGeneration();
+    o->setName("Cherry");
+    mind.remember(oKey);
+    mind.autolinkWaitForIndex();
+    ASSERT_NE(generation, mind.autolinkGetIndex()->getGeneration());
+    EXPECT_TRUE(autolinker.processDescription(apple, autolinkedMd));
+    // THEN memo is missed
+    EXPECT_EQ(2, autolinker.getMemoHits());
+
+    // WHEN big N is autolinked w/ tiny time limit
+    config.setAutolinkingTimeLimit(1);
+    autolinkedMd.clear();
+    // THEN autolinking is incomplete (text is kept), reported and not memoized
+    EXPECT_FALSE(autolinker.processDescription(big, autolinkedMd));
+    EXPECT_EQ(1, autolinker.getTimeLimitExceeded());
+    EXPECT_EQ(1, autolinker.getIncompleteCount());
+    EXPECT_NE(string::npos, autolinkedMd.rfind("Apple and Banana text."));
+    EXPECT_FALSE(autolinker.processDescription(big, autolinkedMd));
+    EXPECT_EQ(2, autolinker.getMemoHits());
+    EXPECT_EQ(2, autolinker.getIncompleteCount());
+
+    // WHEN time limit is disabled
+    config.setAutolinkingTimeLimit(0);
+    // THEN whole N is autolinked
+    EXPECT_TRUE(autolinker.processDescription(big, autolinkedMd));
+    EXPECT_EQ(2, autolinker.getIncompleteCount());
+}
+
+TEST(AutolinkingCmarkTestCase, WholeWordsTabsAndCase)
+{
+    // GIVEN
+    string repositoryDir{"/tmp/mf-unit-repository-autolinking-words"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    m8r::stringToFile(
+        repositoryDir+"/memory/fruit.md",
+        "# Fruit\n\nF.\n\n## Apple\nA.\n\n## Rust\nR.\n\n## Rust.Lang\nRL.\n");
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-act-wwtc.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)), repositoryConfigRepresentation);
+    config.setAutolinking(true);
+    config.setAutolinkingCaseInsensitive(false);
+    m8r::Mind mind(config);
+    mind.learn();
+    mind.think().get();
+    mind.autolinkWaitForIndex();
+    ASSERT_EQ(1, mind.remind().getOutlinesCount());
+    m8r::CmarkAhoCorasickBlockAutolinkingPreprocessor autolinker{mind};
+
+    string md{}, autolinkedMd{};
+    vector<string*> lines{&md};
+
+    // WHEN text w/ tab is autolinked THEN text between links is kept verbatim
+    md.assign("Text\tof Apple.");
+    autolinker.process(lines, autolinkedMd);
+    EXPECT_EQ("Text\tof [Apple](mindforger://links.mindforger.com/Apple).", autolinkedMd);
+
+    // WHEN the longest name is not a whole word THEN shorter whole word name is linked
+    md.assign("Rust.Langs and Rust.Lang.");
+    autolinker.process(lines, autolinkedMd);
+    EXPECT_EQ(
+        "[Rust](mindforger://links.mindforger.com/Rust).Langs and "
+        "[Rust.Lang](mindforger://links.mindforger.com/Rust.Lang).",
+        autolinkedMd);
+
+    // WHEN name is a prefix/suffix of a word THEN it's not linked
+    md.assign("Apples and Pineapple.");
+    autolinker.process(lines, autolinkedMd);
+    EXPECT_EQ("Apples and Pineapple.", autolinkedMd);
+
+    // WHEN autolinking is case sensitive THEN differently cased names are not linked
+    md.assign("apple and APPLE.");
+    autolinker.process(lines, autolinkedMd);
+    EXPECT_EQ("apple and APPLE.", autolinkedMd);
+
+    // WHEN autolinking is case insensitive THEN they are linked as written
+    config.setAutolinkingCaseInsensitive(true);
+    autolinker.process(lines, autolinkedMd);
+    EXPECT_EQ(
+        "[apple](mindforger://links.mindforger.com/apple) and "
+        "[APPLE](mindforger://links.mindforger.com/APPLE).",
+        autolinkedMd);
+    config.setAutolinkingCaseInsensitive(false);
+}
+
 #endif // MF_MD_2_HTML_CMARK
 #endif // !WINDOWS
@@ -0,0 +1,79 @@
+/*
+ autolinking_index_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../../src/mind/ai/autolinking/autolinking_index.h"
+
+using namespace std;
+
+static string toMatchedNames(const m8r::AutolinkingIndex& index, const string& text, bool caseInsensitive)
+{
+    vector<pair<size_t,size_t>> matches{};
+    index.findMatches(text, matches, caseInsensitive);
+    sort(matches.begin(), matches.end());
+    string r{};
+    for(const pair<size_t,size_t>& m:matches) {
+        r += "[" + text.substr(m.first, m.second-m.first) + "]";
+    }
+    return r;
+}
+
+TEST(AutolinkingIndexTestCase, Snapshots)
+{
+    // GIVEN base names
+    shared_ptr<const m8r::AutolinkingIndex::Names> base
+        = make_shared<const m8r::AutolinkingIndex::Names>(
+            vector<string>{"Machine Learning", "machine Learning", "ML", "Mind", "mind", ""});
+    ASSERT_EQ(6, base->size());
+
+    // WHEN
+    m8r::AutolinkingIndex index{base, nullptr, unordered_set<string>{}, 1};
+
+    // THEN case sensitive matches must be spelled like names, insensitive not
+    string text{"MIND and Machine learning: ML w/ machine Learning"};
+    EXPECT_EQ("[ML][machine Learning]", toMatchedNames(index, text, false));
+    EXPECT_EQ("[MIND][Machine learning][ML][machine Learning]", toMatchedNames(index, text, true));
+    EXPECT_EQ(1, index.getGeneration());
+
+    string r{};
+    EXPECT_TRUE(index.findLongestPrefixWord("Mindforger", r));
+    EXPECT_EQ("Mind", r);
+    r.clear();
+    EXPECT_FALSE(index.findLongestPrefixWord("a Mind", r));
+    EXPECT_TRUE(r.empty());
+
+    // WHEN name is removed and other added (base is shared by snapshots)
+    shared_ptr<const m8r::AutolinkingIndex::Names> delta
+        = make_shared<const m8r::AutolinkingIndex::Names>(vector<string>{"MIND", "learning"});
+    m8r::AutolinkingIndex next{base, delta, unordered_set<string>{"ML", "Mind"}, 2};
+
+    // THEN
+    EXPECT_EQ("[MIND][learning][machine Learning]", toMatchedNames(next, text, false));
+    EXPECT_EQ("[MIND][MIND][Machine learning][learning][machine Learning][Learning]", toMatchedNames(next, text, true));
+    // previous snapshot is not affected
+    EXPECT_EQ("[ML][machine Learning]", toMatchedNames(index, text, false));
+}
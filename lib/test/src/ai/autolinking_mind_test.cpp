@@ -0,0 +1,124 @@
+/*
+ autolinking_mind_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../test_utils.h"
+
+// autolinking indices are maintained only if MD is rendered by cmark-gfm
+#ifdef MF_MD_2_HTML_CMARK
+
+#include "../../../src/mind/mind.h"
+#include "../../../src/mind/ai/autolinking/autolinking_index.h"
+
+using namespace std;
+
+static string toIndexedNames(m8r::Mind& mind, const string& text)
+{
+    mind.autolinkWaitForIndex();
+
+    vector<pair<size_t,size_t>> matches{};
+    mind.autolinkGetIndex()->findMatches(text, matches, false);
+    sort(matches.begin(), matches.end());
+    string r{};
+    for(const pair<size_t,size_t>& m:matches) {
+        r += "[" + text.substr(m.first, m.second-m.first) + "]";
+    }
+    return r;
+}
+
+TEST(AutolinkingMindTestCase, RememberForgetRename)
+{
+    string repositoryDir{"/tmp/mf-unit-repository-autolinking-mind"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string alphaKey{repositoryDir+"/memory/alpha.md"};
+    string gammaKey{repositoryDir+"/memory/gamma.md"};
+    string deltaKey{repositoryDir+"/memory/delta.md"};
+    m8r::stringToFile(alphaKey, "# Alpha\n\nA.\n\n## Machine Learning\nML.\n\n## Beta Note\nB.\n");
+    // N name shared by two Os
+    m8r::stringToFile(gammaKey, "# Gamma\n\nG.\n\n## Machine Learning\nML.\n");
+    m8r::stringToFile(deltaKey, "# Delta\n\nD.\n\n## Epsilon\nE.\n");
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-amtc-rfr.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    config.setAutolinking(true);
+    m8r::Mind mind{config};
+    mind.learn();
+    mind.think().get();
+    ASSERT_EQ(3, mind.remind().getOutlinesCount());
+
+    const string text{"Alpha, Gamma, Delta, Machine Learning, Beta Note, Deep Learning, Epsilon."};
+    EXPECT_EQ("[Alpha][Gamma][Delta][Machine Learning][Beta Note][Epsilon]", toIndexedNames(mind, text));
+
+    // WHEN O w/ N name shared w/ other O is forgotten
+    mind.outlineForget(gammaKey);
+    // THEN shared name is still indexed (refcount)
+    EXPECT_EQ("[Alpha][Delta][Machine Learning][Beta Note][Epsilon]", toIndexedNames(mind, text));
+
+    // WHEN N is renamed and its O remembered
+    m8r::Outline* alpha = mind.remind().getOutline(alphaKey);
+    ASSERT_NE(nullptr, alpha);
+    alpha->getNotes()[0]->setName("Deep Learning");
+    mind.remember(alphaKey);
+    // THEN old name is dropped and new one indexed
+    EXPECT_EQ("[Alpha][Delta][Beta Note][Deep Learning][Epsilon]", toIndexedNames(mind, text));
+
+    // WHEN O is cloned and the original O is forgotten
+    m8r::Outline* clone = mind.outlineClone(alphaKey);
+    ASSERT_NE(nullptr, clone);
+    string cloneKey{clone->getKey()};
+    mind.outlineForget(alphaKey);
+    // THEN names of the clone are indexed (clone is named "Copy of Alpha")
+    EXPECT_EQ("[Delta][Beta Note][Deep Learning][Epsilon]", toIndexedNames(mind, text));
+    EXPECT_EQ("[Copy of Alpha]", toIndexedNames(mind, "Copy of Alpha"));
+
+    // WHEN N is refactored to other O and the source O is forgotten
+    m8r::Note* beta = clone->getNotes()[1];
+    ASSERT_EQ("Beta Note", beta->getName());
+    mind.noteRefactor(beta, deltaKey);
+    mind.outlineForget(cloneKey);
+    // THEN refactored N name is indexed w/ target O
+    EXPECT_EQ("[Delta][Beta Note][Epsilon]", toIndexedNames(mind, text));
+
+    // WHEN autolinking is off, N is renamed and its O remembered
+    config.setAutolinking(false);
+    m8r::Outline* delta = mind.remind().getOutline(deltaKey);
+    ASSERT_NE(nullptr, delta);
+    delta->getNotes()[0]->setName("Machine Learning");
+    mind.remember(deltaKey);
+    config.setAutolinking(true);
+    // THEN index is maintained - old name is not linked after autolinking is switched on
+    EXPECT_EQ("[Delta][Machine Learning][Beta Note]", toIndexedNames(mind, text));
+}
+
+#endif
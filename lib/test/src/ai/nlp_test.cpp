@@ -22,6 +22,10 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <sys/stat.h>
 
 #include "../../../src/config/configuration.h"
 #include "../../../src/mind/mind.h"
@@ -33,6 +37,9 @@
 #include "../../../src/mind/ai/nlp/lexicon.h"
 #include "../../../src/mind/ai/nlp/word_frequency_list.h"
 #include "../../../src/mind/ai/nlp/bag_of_words.h"
+#include "../../../src/mind/ai/aa_neighbor_store.h"
+#include "../../../src/mind/ai/aa_minhash_lsh.h"
+#include "../../../src/gear/file_utils.h"
 
 #include <gtest/gtest.h>
 
@@ -64,6 +71,23 @@ TEST(AiNlpTestCase, DISABLED_Stemmer)
     }
 }
 
+TEST(AiNlpTestCase, StemmerCache)
+{
+    vector<string> words{"informational", "machines", "learning", "learning", "eclipse", "machines", "ai"};
+    m8r::Stemmer uncached{0};
+    m8r::Stemmer cached{4};
+
+    // cached stems are the same as computed stems (also when cache is full and dropped)
+    for(int round=0; round<2; round++) {
+        for(string& w:words) {
+            EXPECT_EQ(uncached.stem(w), cached.stem(w));
+            EXPECT_LE(cached.getCacheSize(), 4);
+        }
+    }
+    EXPECT_EQ(0, uncached.getCacheSize());
+    EXPECT_EQ("learn", cached.stem("learning"));
+}
+
 TEST(AiNlpTestCase, Lexicon)
 {
     m8r::Lexicon lexicon{};
@@ -100,6 +124,27 @@ TEST(AiNlpTestCase, Lexicon)
     ASSERT_FLOAT_EQ(0.4, lexicon.get("a3")->weight);
     ASSERT_FLOAT_EQ(0.6, lexicon.get("a2")->weight);
 
+    // interned word IDs and flat weights array
+    ASSERT_EQ(0, lexicon.get("a5")->id);
+    ASSERT_EQ(1, lexicon.get("a3")->id);
+    ASSERT_EQ(2, lexicon.get("a2")->id);
+    ASSERT_EQ("a3", lexicon.get(1)->word);
+    ASSERT_EQ(3, lexicon.getWeights().size());
+    ASSERT_FLOAT_EQ(0.4, lexicon.getWeight(1));
+
+    // max frequency is kept when frequencies of words are decreased (5/3/2)
+    EXPECT_EQ(5, lexicon.getMaxFrequency());
+    EXPECT_FALSE(lexicon.remove(1, 1));
+    EXPECT_TRUE(lexicon.remove(0, 3));
+    EXPECT_EQ(2, lexicon.getMaxFrequency());
+    EXPECT_FALSE(lexicon.remove(0, 10));
+    EXPECT_EQ(0, lexicon.get("a5")->frequency);
+    EXPECT_FALSE(lexicon.remove(1, 2));
+    EXPECT_TRUE(lexicon.remove(2, 2));
+    EXPECT_EQ(1, lexicon.getMaxFrequency());
+    lexicon.add(1, 4);
+    EXPECT_EQ(4, lexicon.getMaxFrequency());
+
     // TODO weights: increase scale
 
 }
@@ -203,6 +248,82 @@ TEST(AiNlpTestCase, Tokenizer)
     ASSERT_EQ(146, narrowed.size());
 }
 
+TEST(AiNlpTestCase, TokenizerSpan)
+{
+    string repositoryPath{"/lib/test/resources/universe-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-ts.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)), repositoryConfigRepresentation);
+    m8r::Mind mind(config);
+    mind.learn();
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+    ASSERT_LT(0, notes.size());
+
+    // N spans are tokenized to the same words as narrowed N chars
+    m8r::CommonWordsBlacklist blacklist{};
+    m8r::Lexicon charsLexicon{};
+    m8r::MarkdownTokenizer charsTokenizer{charsLexicon, blacklist};
+    m8r::Lexicon spanLexicon{};
+    m8r::MarkdownTokenizer spanTokenizer{spanLexicon, blacklist};
+    for(m8r::Note* n:notes) {
+        m8r::NoteCharProvider chars{n};
+        m8r::WordFrequencyList charsWords{&charsLexicon};
+        charsTokenizer.tokenize(chars, charsWords);
+        m8r::WordFrequencyList spanWords{&spanLexicon};
+        spanTokenizer.tokenize(n, spanWords);
+
+        ASSERT_EQ(charsWords.size(), spanWords.size());
+        for(size_t i=0; i<charsWords.size(); i++) {
+            EXPECT_EQ(charsWords.iterable()[i].id, spanWords.iterable()[i].id);
+            EXPECT_EQ(charsWords.iterable()[i].frequency, spanWords.iterable()[i].frequency);
+        }
+    }
+    ASSERT_EQ(charsLexicon.size(), spanLexicon.size());
+    for(auto& w:charsLexicon.get()) {
+        ASSERT_NE(nullptr, spanLexicon.get(w.first));
+        EXPECT_EQ(w.second.id, spanLexicon.get(w.first)->id);
+        EXPECT_EQ(w.second.frequency, spanLexicon.get(w.first)->frequency);
+    }
+
+    // dashes, delimiters, HIGH Unicode, whitespace runs and the last word of span
+    m8r::Lexicon lexicon{};
+    m8r::MarkdownTokenizer tokenizer{lexicon, blacklist};
+    vector<int> ids{};
+    string text{"Self-Awareness -- x--yz [link](url)                                 \n\n\tna\xc3\xafve a- Last"};
+    tokenizer.tokenize(text.data(), text.size(), ids, false, true, false);
+    vector<string> words{};
+    for(int id:ids) {
+        words.push_back(lexicon.get(id)->word);
+    }
+    EXPECT_EQ((vector<string>{"self-awareness", "-yz", "link", "url", "na", "ve", "a-", "last"}), words);
+
+    // word IDs memo: options don't share memo, tiny memo is dropped, cleared lexicon drops memo
+    tokenizer.setWordIdsCacheCapacity(3);
+    for(int round=0; round<3; round++) {
+        if(round == 2) {
+            lexicon.clear();
+        }
+        ids.clear();
+        string repeated{"The running dogs and the running Dogs."};
+        tokenizer.tokenize(repeated.data(), repeated.size(), ids, true, true, true);
+        words.clear();
+        for(int id:ids) {
+            words.push_back(lexicon.get(id)->word);
+        }
+        EXPECT_EQ((vector<string>{"run", "dog", "run", "dog"}), words);
+
+        ids.clear();
+        tokenizer.tokenize(repeated.data(), repeated.size(), ids, false, false, false);
+        EXPECT_EQ(7, ids.size());
+        EXPECT_EQ("Dogs", lexicon.get(ids[6])->word);
+        EXPECT_EQ(round<2?2*(round+1):2, lexicon.get("run")->frequency);
+    }
+}
+
 // IMPROVE disabled as AA API changed - it will be re-enable once BoW becomes main AA algorithm again
 TEST(AiNlpTestCase, DISABLED_AaRepositoryBow)
 {
@@ -297,16 +418,826 @@ TEST(AiNlpTestCase, DISABLED_AaUniverseBow)
     ASSERT_EQ("Alternative Universe", (*leaderboard)[1].first->getOutline()->getName());
 }
 
+TEST(AiNlpTestCase, AaBowRemember)
+{
+    string repositoryPath{"/tmp/mf-unit-aa-remember"};
+    m8r::removeDirectoryRecursively(repositoryPath.c_str());
+    ASSERT_TRUE(m8r::createDirectory(repositoryPath));
+    m8r::stringToFile(
+        repositoryPath+"/1.md",
+        "# Fruits"
+        "\n"
+        "\n## Apples"
+        "\nApples grow in orchard. Apples are red and sweet fruit."
+        "\n"
+        "\n## Rockets"
+        "\nRockets launch satellites to orbit. Rocket engines burn fuel."
+        "\n");
+    m8r::stringToFile(
+        repositoryPath+"/2.md",
+        "# Topics"
+        "\n"
+        "\n## Orchard"
+        "\nOrchard trees bear apples and pears. Sweet fruit harvest."
+        "\n"
+        "\n## Space"
+        "\nSpace launch puts satellites to orbit. Engines burn fuel."
+        "\n");
+
+    m8r::Repository* repository = new m8r::Repository(
+        repositoryPath,
+        m8r::Repository::RepositoryType::MARKDOWN,
+        m8r::Repository::RepositoryMode::REPOSITORY,
+        "",
+        false);
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-abr.md");
+    config.setActiveRepository(config.addRepository(repository), repositoryConfigRepresentation);
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_TRUE(mind.think().get());
+    ASSERT_EQ(m8r::Configuration::MindState::THINKING, config.getMindState());
+
+    // leaderboard is calculated asynchronously and then served from cache
+    auto getLeaderboard = [&mind](m8r::Note* n, vector<pair<m8r::Note*,float>>& leaderboard) {
+        for(int i=0; i<100; i++) {
+            while(!mind.isActiveProcesses()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            m8r::AssociatedNotes associations{m8r::ResourceType::NOTE, n};
+            if(mind.getAssociatedNotes(associations).get() && associations.getAssociations()->size()) {
+                leaderboard = *associations.getAssociations();
+                return;
+            }
+        }
+    };
+
+    m8r::Outline* o = mind.remind().getOutlines()[0]->getName()=="Fruits"
+        ? mind.remind().getOutlines()[0]
+        : mind.remind().getOutlines()[1];
+    m8r::Note* rockets = o->getNotes()[1];
+    ASSERT_EQ("Rockets", rockets->getName());
+
+    vector<pair<m8r::Note*,float>> leaderboard{};
+    getLeaderboard(rockets, leaderboard);
+    ASSERT_LE(1, leaderboard.size());
+    EXPECT_EQ("Space", leaderboard[0].first->getName());
+    float spaceAa = leaderboard[0].second;
+
+    // edit N > remember > only N is learned again
+    vector<string*> description{};
+    description.push_back(new string{"Apples grow on orchard trees. Sweet fruit apples harvest."});
+    rockets->setDescription(description);
+    rockets->makeModified();
+    mind.remember(o->getKey());
+    // N modified by UI (w/o remember) while O is learned > remembered N is learned
+    description.clear();
+    rockets->moveDescription(description);
+    for(string* d:description) {
+        delete d;
+    }
+    description.clear();
+    description.push_back(new string{"Rockets launch satellites to orbit. Rocket engines burn fuel."});
+    rockets->setDescription(description);
+
+    leaderboard.clear();
+    getLeaderboard(rockets, leaderboard);
+    ASSERT_LE(1, leaderboard.size());
+    EXPECT_NE("Space", leaderboard[0].first->getName());
+    for(auto& l:leaderboard) {
+        if(l.first->getName() == "Space") {
+            EXPECT_GT(spaceAa, l.second);
+        }
+    }
+
+    // new N
+    m8r::Note* comets = new m8r::Note{rockets->getType(), o};
+    comets->setName("Comets");
+    description.clear();
+    description.push_back(new string{"Comets orbit. Satellites orbit. Engines burn fuel to launch."});
+    comets->setDescription(description);
+    o->addNote(comets);
+    comets->makeModified();
+    mind.remember(o->getKey());
+
+    m8r::Note* space = mind.remind().getOutlines()[0]==o
+        ? mind.remind().getOutlines()[1]->getNotes()[1]
+        : mind.remind().getOutlines()[0]->getNotes()[1];
+    ASSERT_EQ("Space", space->getName());
+    leaderboard.clear();
+    getLeaderboard(space, leaderboard);
+    ASSERT_LE(1, leaderboard.size());
+    EXPECT_EQ("Comets", leaderboard[0].first->getName());
+}
+
+TEST(AiNlpTestCase, AaBowGeneration)
+{
+    string repositoryPath{"/tmp/mf-unit-aa-generation"};
+    m8r::removeDirectoryRecursively(repositoryPath.c_str());
+    ASSERT_TRUE(m8r::createDirectory(repositoryPath));
+    m8r::stringToFile(
+        repositoryPath+"/1.md",
+        "# Fruits"
+        "\n"
+        "\n## Apples"
+        "\nApples grow in orchard. Apples are red and sweet fruit."
+        "\n"
+        "\n## Rockets"
+        "\nRockets launch satellites to orbit. Rocket engines burn fuel."
+        "\n");
+    m8r::stringToFile(
+        repositoryPath+"/2.md",
+        "# Topics"
+        "\n"
+        "\n## Orchard"
+        "\nOrchard trees bear apples and pears. Sweet fruit harvest."
+        "\n"
+        "\n## Space"
+        "\nSpace launch puts satellites to orbit. Engines burn fuel."
+        "\n");
+
+    m8r::Repository* repository = new m8r::Repository(
+        repositoryPath,
+        m8r::Repository::RepositoryType::MARKDOWN,
+        m8r::Repository::RepositoryMode::REPOSITORY,
+        "",
+        false);
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-abg.md");
+    config.setActiveRepository(config.addRepository(repository), repositoryConfigRepresentation);
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_TRUE(mind.think().get());
+
+    auto getLeaderboard = [&mind](m8r::Note* n, vector<pair<m8r::Note*,float>>& leaderboard) {
+        for(int i=0; i<100; i++) {
+            while(!mind.isActiveProcesses()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            m8r::AssociatedNotes associations{m8r::ResourceType::NOTE, n};
+            if(mind.getAssociatedNotes(associations).get() && associations.getAssociations()->size()) {
+                leaderboard = *associations.getAssociations();
+                return;
+            }
+        }
+    };
+
+    m8r::Outline* fruits = mind.remind().getOutlines()[0]->getName()=="Fruits"
+        ? mind.remind().getOutlines()[0]
+        : mind.remind().getOutlines()[1];
+    m8r::Outline* topics = mind.remind().getOutlines()[0]==fruits
+        ? mind.remind().getOutlines()[1]
+        : mind.remind().getOutlines()[0];
+    m8r::Note* rockets = fruits->getNotes()[1];
+    m8r::Note* space = topics->getNotes()[1];
+    ASSERT_EQ("Rockets", rockets->getName());
+    ASSERT_EQ("Space", space->getName());
+
+    vector<pair<m8r::Note*,float>> leaderboard{};
+    getLeaderboard(rockets, leaderboard);
+    ASSERT_LE(1, leaderboard.size());
+    EXPECT_EQ(space, leaderboard[0].first);
+
+    // Mind didn't change > leaderboard is served from cache (ready immediately)
+    {
+        m8r::AssociatedNotes associations{m8r::ResourceType::NOTE, rockets};
+        auto future = mind.getAssociatedNotes(associations);
+        ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(0)));
+        EXPECT_TRUE(future.get());
+        EXPECT_EQ(leaderboard.size(), associations.getAssociations()->size());
+    }
+
+    // Mind changed, but Ns didn't > cached leaderboard stays valid (keyed by N revision)
+    u_int32_t generation = mind.getGeneration();
+    mind.remember(fruits->getKey());
+    EXPECT_LT(generation, mind.getGeneration());
+    {
+        m8r::AssociatedNotes associations{m8r::ResourceType::NOTE, rockets};
+        auto future = mind.getAssociatedNotes(associations);
+        ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(0)));
+        EXPECT_TRUE(future.get());
+        EXPECT_EQ(leaderboard.size(), associations.getAssociations()->size());
+    }
+
+    // move N to other O > it's learned w/ new O (same O AA bonus)
+    generation = mind.getGeneration();
+    m8r::Note* orchard = topics->getNotes()[0];
+    ASSERT_EQ("Orchard", orchard->getName());
+    vector<pair<m8r::Note*,float>> before{};
+    getLeaderboard(orchard, before);
+    mind.noteRefactor(orchard, fruits->getKey());
+    EXPECT_LT(generation, mind.getGeneration());
+    vector<pair<m8r::Note*,float>> after{};
+    getLeaderboard(orchard, after);
+    ASSERT_LE(1, before.size());
+    ASSERT_LE(1, after.size());
+    float apples = 0.f, applesBefore = 0.f;
+    for(auto& a:after) if(a.first->getName()=="Apples") apples = a.second;
+    for(auto& b:before) if(b.first->getName()=="Apples") applesBefore = b.second;
+    EXPECT_LT(applesBefore, apples);
+
+    // delete N > leaderboards which contained it are evicted
+    generation = mind.getGeneration();
+    mind.noteForget(space);
+    EXPECT_LT(generation, mind.getGeneration());
+    leaderboard.clear();
+    getLeaderboard(rockets, leaderboard);
+    for(auto& l:leaderboard) {
+        EXPECT_NE(space, l.first);
+    }
+}
+
+TEST(AiNlpTestCase, AaBowParallel)
+{
+    // GIVEN repository w/ enough Ns to split AA row among workers (directory w/o MF
+    // repository structure - AA model is not persisted, the second Mind learns from scratch)
+    static const int OUTLINES = 12;
+    static const int NOTES = 50;
+    static const int VOCABULARY = 150;
+    string repositoryPath{"/tmp/mf-unit-aa-parallel"};
+    m8r::removeDirectoryRecursively(repositoryPath.c_str());
+    ASSERT_TRUE(m8r::createDirectory(repositoryPath));
+    unsigned seed = 42;
+    auto word = [&seed]() {
+        seed = seed*1103515245 + 12345;
+        return "word" + std::to_string((seed>>16) % VOCABULARY);
+    };
+    for(int o=0; o<OUTLINES; o++) {
+        string md{"# Outline " + std::to_string(o) + "\n\nO.\n"};
+        for(int n=0; n<NOTES; n++) {
+            md += "\n## " + word() + " " + word() + "\n";
+            for(int w=0; w<20; w++) {
+                md += word() + " ";
+            }
+            md += "\n";
+        }
+        m8r::stringToFile(repositoryPath+"/"+std::to_string(o)+".md", md);
+    }
+
+    m8r::Repository* repository = new m8r::Repository(
+        repositoryPath,
+        m8r::Repository::RepositoryType::MARKDOWN,
+        m8r::Repository::RepositoryMode::REPOSITORY,
+        "",
+        false);
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-abp.md");
+    config.setActiveRepository(config.addRepository(repository), repositoryConfigRepresentation);
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+    // Os order (word IDs) differs across learnings > AA is compared w/in the same memory
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+    ASSERT_EQ(OUTLINES*NOTES, notes.size());
+
+    // N # -> leaderboard of every 10th N
+    auto getLeaderboards = [&](int workers, map<size_t,vector<pair<m8r::Note*,float>>>& leaderboards) {
+        mind.sleep();
+        config.setAaWorkers(workers);
+        ASSERT_TRUE(mind.think().get());
+        for(size_t i=0; i<notes.size(); i+=10) {
+            // leaderboard is calculated async > cached leaderboard is copied by the second call
+            m8r::AssociatedNotes associations{m8r::ResourceType::NOTE, notes[i]};
+            ASSERT_TRUE(mind.getAssociatedNotes(associations).get());
+            ASSERT_TRUE(mind.getAssociatedNotes(associations).get());
+            leaderboards[i] = *associations.getAssociations();
+        }
+    };
+
+    // WHEN AA is calculated by single worker and by multiple workers
+    map<size_t,vector<pair<m8r::Note*,float>>> serial{}, parallel{};
+    getLeaderboards(1, serial);
+    getLeaderboards(4, parallel);
+
+    // THEN leaderboards are the same
+    ASSERT_EQ(OUTLINES*NOTES/10, serial.size());
+    size_t associations = 0;
+    for(auto& l:serial) {
+        associations += l.second.size();
+    }
+    EXPECT_LT(0, associations);
+    EXPECT_EQ(serial, parallel);
+}
+
+TEST(AiNlpTestCase, AaBowModel)
+{
+    string repositoryPath{"/tmp/mf-unit-aa-model"};
+    m8r::removeDirectoryRecursively(repositoryPath.c_str());
+    ASSERT_TRUE(m8r::createDirectory(repositoryPath));
+    ASSERT_TRUE(m8r::createDirectory(repositoryPath+"/memory"));
+    ASSERT_TRUE(m8r::createDirectory(repositoryPath+"/mind"));
+    m8r::stringToFile(
+        repositoryPath+"/memory/1.md",
+        "# Fruits"
+        "\n"
+        "\n## Apples"
+        "\nApples grow in orchard. Apples are red and sweet fruit."
+        "\n"
+        "\n## Rockets"
+        "\nRockets launch satellites to orbit. Rocket engines burn fuel."
+        "\n");
+    m8r::stringToFile(
+        repositoryPath+"/memory/2.md",
+        "# Topics"
+        "\n"
+        "\n## Orchard"
+        "\nOrchard trees bear apples and pears. Sweet fruit harvest."
+        "\n"
+        "\n## Space"
+        "\nSpace launch puts satellites to orbit. Engines burn fuel."
+        "\n");
+    string modelPath{repositoryPath+"/"+m8r::DIRNAME_M8R_CACHE+"/"+m8r::FILENAME_AA_BOW_MODEL};
+    // model is saved to a new file (rename) > inode indicates whether model was saved
+    auto getModelInode = [&]() {
+        struct stat s;
+        return stat(modelPath.c_str(), &s)?0:s.st_ino;
+    };
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+
+    // think, get leaderboard of 'Rockets' and shutdown (model is saved)
+    auto getRocketsLeaderboard = [&](vector<pair<string,float>>& leaderboard) {
+        config.clear();
+        config.setConfigFilePath("/tmp/cfg-antc-abm.md");
+        config.setActiveRepository(
+            config.addRepository(new m8r::Repository(
+                repositoryPath,
+                m8r::Repository::RepositoryType::MINDFORGER,
+                m8r::Repository::RepositoryMode::REPOSITORY,
+                "",
+                false)),
+            repositoryConfigRepresentation);
+        config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+        m8r::Mind mind(config);
+        ASSERT_TRUE(mind.learn());
+        ASSERT_TRUE(mind.think().get());
+        ASSERT_EQ(m8r::Configuration::MindState::THINKING, config.getMindState());
+
+        m8r::Outline* o = mind.remind().getOutlines()[0]->getName()=="Fruits"
+            ? mind.remind().getOutlines()[0]
+            : mind.remind().getOutlines()[1];
+        m8r::Note* rockets = o->getNotes()[1];
+        ASSERT_EQ("Rockets", rockets->getName());
+
+        for(int i=0; i<100 && leaderboard.empty(); i++) {
+            while(!mind.isActiveProcesses()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            m8r::AssociatedNotes associations{m8r::ResourceType::NOTE, rockets};
+            if(mind.getAssociatedNotes(associations).get()) {
+                for(auto& a:*associations.getAssociations()) {
+                    leaderboard.push_back(make_pair(a.first->getName(), a.second));
+                }
+            }
+        }
+    };
+
+    vector<pair<string,float>> learned{};
+    getRocketsLeaderboard(learned);
+    ASSERT_LE(1, learned.size());
+    EXPECT_EQ("Space", learned[0].first);
+
+    m8r::AaBowModel model{};
+    ASSERT_TRUE(model.load(modelPath));
+    EXPECT_EQ(4, model.getNotesCount());
+    EXPECT_LT(0, model.getWordsCount());
+    model.unload();
+
+    // restart > Ns are restored from model - the same leaderboard, model is not saved again
+    auto savedInode = getModelInode();
+    vector<pair<string,float>> restored{};
+    getRocketsLeaderboard(restored);
+    EXPECT_EQ(savedInode, getModelInode());
+    ASSERT_EQ(learned.size(), restored.size());
+    for(size_t i=0; i<learned.size(); i++) {
+        EXPECT_EQ(learned[i].first, restored[i].first);
+        EXPECT_FLOAT_EQ(learned[i].second, restored[i].second);
+    }
+
+    // N changed while MF was not running > it's learned again
+    m8r::stringToFile(
+        repositoryPath+"/memory/2.md",
+        "# Topics"
+        "\n"
+        "\n## Orchard"
+        "\nOrchard trees bear apples and pears. Sweet fruit harvest."
+        "\n"
+        "\n## Space"
+        "\nApples grow on orchard trees. Sweet fruit apples harvest."
+        "\n");
+    vector<pair<string,float>> changed{};
+    getRocketsLeaderboard(changed);
+    EXPECT_NE(savedInode, getModelInode());
+    for(auto& c:changed) {
+        if(c.first == "Space") {
+            EXPECT_GT(learned[0].second, c.second);
+        }
+    }
+
+    // corrupted model is rejected > memory is learned from scratch
+    m8r::stringToFile(modelPath, "M8RAABOW corrupted");
+    EXPECT_FALSE(model.load(modelPath));
+    vector<pair<string,float>> relearned{};
+    getRocketsLeaderboard(relearned);
+    ASSERT_EQ(changed.size(), relearned.size());
+    for(size_t i=0; i<changed.size(); i++) {
+        EXPECT_EQ(changed[i].first, relearned[i].first);
+        EXPECT_FLOAT_EQ(changed[i].second, relearned[i].second);
+    }
+}
+
+/*
+ * AA: TF-IDF
+ */
+
+TEST(AiNlpTestCase, AaUniverseTfIdf)
+{
+    string repositoryPath{"/lib/test/resources/aa-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-aut.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)), repositoryConfigRepresentation);
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::TF_IDF);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_LE(1, mind.remind().getOutlinesCount());
+    shared_future<bool> readyToThink = mind.think();
+    ASSERT_TRUE(readyToThink.get());
+    ASSERT_EQ(m8r::Configuration::MindState::THINKING, config.getMindState());
+
+    m8r::Outline* u;
+    m8r::Outline* a;
+    if(mind.remind().getOutlines()[0]->getName().find("Alternative") != string::npos) {
+        u = mind.remind().getOutlines()[1];
+        a = mind.remind().getOutlines()[0];
+    } else {
+        u = mind.remind().getOutlines()[0];
+        a = mind.remind().getOutlines()[1];
+    }
+
+    // N > Ns: 'Albert Einstein' ~ its copies are the most similar (SYNC - result is ready)
+    m8r::Note* n=u->getNotes()[0];
+    m8r::AssociatedNotes nAssociations{m8r::ResourceType::NOTE, n};
+    auto future = mind.getAssociatedNotes(nAssociations);
+    ASSERT_TRUE(future.get());
+    vector<pair<m8r::Note*,float>>* leaderboard = nAssociations.getAssociations();
+    m8r::Ai::print(n,*leaderboard);
+    ASSERT_LE(2, leaderboard->size());
+    EXPECT_GE(10, leaderboard->size());
+    EXPECT_EQ("Same Albert Einstein", (*leaderboard)[0].first->getName());
+    EXPECT_EQ("Same Albert Einstein", (*leaderboard)[1].first->getName());
+    for(size_t i=0; i<leaderboard->size(); i++) {
+        EXPECT_NE(n, (*leaderboard)[i].first);
+        EXPECT_GE(1.0001f, (*leaderboard)[i].second);
+        if(i) { EXPECT_GE((*leaderboard)[i-1].second, (*leaderboard)[i].second); }
+    }
+
+    // O > Ns: alternative universe is associated w/ the universe
+    m8r::AssociatedNotes oAssociations{m8r::ResourceType::OUTLINE, a};
+    ASSERT_TRUE(mind.getAssociatedNotes(oAssociations).get());
+    ASSERT_LE(1, oAssociations.getAssociations()->size());
+    EXPECT_EQ(u->getOutlineDescriptorAsNote(), (*oAssociations.getAssociations())[0].first);
+
+    // words > Ns
+    m8r::AssociatedNotes wAssociations{m8r::ResourceType::WORD, "Einstein relativity", n};
+    ASSERT_TRUE(mind.getAssociatedNotes(wAssociations).get());
+    ASSERT_LE(1, wAssociations.getAssociations()->size());
+    EXPECT_NE(string::npos, (*wAssociations.getAssociations())[0].first->getName().find("Einstein"));
+
+    // unknown words
+    m8r::AssociatedNotes uAssociations{m8r::ResourceType::WORD, "xyzzy", n};
+    ASSERT_TRUE(mind.getAssociatedNotes(uAssociations).get());
+    EXPECT_EQ(0, uAssociations.getAssociations()->size());
+}
+
+TEST(AiNlpTestCase, AaRepositoryTfIdfRefresh)
+{
+    string repositoryDir{"/tmp/mf-unit-repository-aa-tf-idf"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    // enough Ns to patch rows rather than learn memory again
+    string md{"# Topics\n\nVarious topics.\n"};
+    for(int i=0; i<60; i++) {
+        md += "\n## Topic " + std::to_string(i) + "\nTopic text w/ common words and word" + std::to_string(i) + ".\n";
+    }
+    string oKey{repositoryDir+"/memory/topics.md"};
+    m8r::stringToFile(oKey, md);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-artir.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::TF_IDF);
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_TRUE(mind.think().get());
+    m8r::Outline* o = mind.remind().getOutline(oKey);
+    ASSERT_NE(nullptr, o);
+    ASSERT_EQ(60, o->getNotesCount());
+
+    auto getBest = [&mind](const string& words) -> string {
+        m8r::AssociatedNotes associations{m8r::ResourceType::WORD, words, nullptr};
+        mind.getAssociatedNotes(associations).get();
+        return associations.getAssociations()->size()
+            ? (*associations.getAssociations())[0].first->getName()
+            : string{};
+    };
+    EXPECT_EQ("Topic 7", getBest("word7"));
+    EXPECT_EQ("", getBest("quagga"));
+
+    // WHEN N is modified after learning
+    m8r::Note* n = o->getNotes()[7];
+    n->clearDescription();
+    n->addDescriptionLine(new string{"Zebra quagga stripes."});
+    n->makeModified();
+    mind.remember(o);
+    // THEN its row is patched - new words are found, old words are forgotten
+    EXPECT_EQ("Topic 7", getBest("quagga"));
+    EXPECT_EQ("", getBest("word7"));
+
+    // WHEN N is created after learning
+    string name{"Okapi"};
+    m8r::Note* created = mind.noteNew(oKey, 0, &name);
+    created->addDescriptionLine(new string{"Okapi giraffe forest."});
+    created->makeModified();
+    mind.remember(o);
+    // THEN it gets row
+    EXPECT_EQ("Okapi", getBest("giraffe"));
+    m8r::AssociatedNotes zAssociations{m8r::ResourceType::WORD, "okapi zebra", nullptr};
+    ASSERT_TRUE(mind.getAssociatedNotes(zAssociations).get());
+    ASSERT_EQ(2, zAssociations.getAssociations()->size());
+}
+
 /*
  * AA: FTS
  */
 
 TEST(AiNlpTestCase, AaRepositoryFts)
 {
-    // TODO AaRepositoryFts
+    string repositoryPath{"/tmp/mf-unit-aa-fts"};
+    m8r::removeDirectoryRecursively(repositoryPath.c_str());
+    ASSERT_TRUE(m8r::createDirectory(repositoryPath));
+    m8r::stringToFile(
+        repositoryPath+"/1.md",
+        "# Fruits"
+        "\n"
+        "\n## Apples"
+        "\nApples grow in orchard. APPLES are red."
+        "\n"
+        "\n## Rockets"
+        "\nRockets launch satellites to orbit."
+        "\n"
+        "\n## Pears"
+        "\nPears and apples."
+        "\n");
+
+    m8r::Repository* repository = new m8r::Repository(
+        repositoryPath,
+        m8r::Repository::RepositoryType::MARKDOWN,
+        m8r::Repository::RepositoryMode::REPOSITORY,
+        "",
+        false);
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-arf.md");
+    config.setActiveRepository(config.addRepository(repository), repositoryConfigRepresentation);
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_TRUE(mind.think().get());
+
+    m8r::Outline* fruits = mind.remind().getOutlines()[0];
+    m8r::Note* apples = fruits->getNotes()[0];
+    m8r::Note* rockets = fruits->getNotes()[1];
+    m8r::Note* pears = fruits->getNotes()[2];
+    ASSERT_EQ("Apples", apples->getName());
+
+    // WHEN words are associated (case is ignored, all matches are counted)
+    m8r::AssociatedNotes associations{m8r::ResourceType::WORD, "apples", nullptr};
+    ASSERT_TRUE(mind.getAssociatedNotes(associations).get());
+
+    // THEN title match wins, description matches contribute
+    vector<pair<m8r::Note*,float>>& leaderboard = *associations.getAssociations();
+    ASSERT_EQ(2, leaderboard.size());
+    EXPECT_EQ(apples, leaderboard[0].first);
+    EXPECT_EQ(pears, leaderboard[1].first);
+    EXPECT_FLOAT_EQ(10.f/120.f, leaderboard[1].second);
+
+    // WHEN N is modified
+    vector<string*> description{};
+    description.push_back(new string{"Apples on rockets."});
+    rockets->setDescription(description);
+    rockets->makeModified();
+
+    // THEN modified N text is assessed
+    associations.getAssociations()->clear();
+    ASSERT_TRUE(mind.getAssociatedNotes(associations).get());
+    ASSERT_EQ(3, leaderboard.size());
+    EXPECT_EQ(apples, leaderboard[0].first);
+
+    // WHEN multi-word fallback is used (more words than threshold)
+    m8r::AssociatedNotes fallback{m8r::ResourceType::WORD, "orbit pears satellites rockets", nullptr};
+    ASSERT_TRUE(mind.getAssociatedNotes(fallback).get());
+
+    // THEN only first words are searched (no empty words padding which would match everything)
+    ASSERT_EQ(1, fallback.getAssociations()->size());
+    EXPECT_EQ(pears, (*fallback.getAssociations())[0].first);
 }
 
 TEST(AiNlpTestCase, AaUniverseFts)
 {
     // TODO AaUniverseFts
 }
+
+TEST(AiNlpTestCase, WordFrequencyList)
+{
+    m8r::Lexicon lexicon{};
+    m8r::WordFrequencyList wfl{&lexicon};
+
+    // frequencies: z 3, y 2, x 1 ~ weights: z 0.01, y 0.33, x 0.66
+    const char* words[] = {"z", "y", "z", "x", "z", "y"};
+    for(const char* w:words) {
+        wfl.add(lexicon.add(w));
+    }
+    lexicon.recalculateWeights();
+
+    // vector is sorted by word ID
+    ASSERT_EQ(3, wfl.size());
+    ASSERT_EQ(0, wfl.iterable()[0].id);
+    ASSERT_EQ(3, wfl.iterable()[0].frequency);
+    ASSERT_EQ(2, wfl.iterable()[2].id);
+    ASSERT_TRUE(wfl.contains(lexicon.get("x")->id));
+    ASSERT_FALSE(wfl.contains(3));
+
+    // relevant words ~ words w/ the highest weight sorted by ID
+    wfl.sort(2);
+    ASSERT_EQ(2, wfl.getRelevantWords().size());
+    ASSERT_EQ(lexicon.get("y")->id, wfl.getRelevantWords()[0].id);
+    ASSERT_EQ(lexicon.get("x")->id, wfl.getRelevantWords()[1].id);
+
+    m8r::WordFrequencyList other{&lexicon};
+    other.add(lexicon.add("w"));
+    other.add(lexicon.get("y"));
+    m8r::WordFrequencyList intersection{&lexicon};
+    m8r::WordFrequencyList::evalIntersection(wfl, other, intersection);
+    ASSERT_EQ(1, intersection.size());
+    m8r::WordFrequencyList u{&lexicon};
+    m8r::WordFrequencyList::evalUnion(wfl, other, u);
+    ASSERT_EQ(4, u.size());
+}
+
+TEST(AiNlpTestCase, AaNeighborStore)
+{
+    m8r::AaNeighborStore store{3};
+    store.reset(5);
+    EXPECT_EQ(5, store.size());
+    EXPECT_FALSE(store.isRowComputed(0));
+
+    // symmetric updates
+    store.add(0, 1, 0.5f);
+    store.add(0, 2, 0.9f);
+    store.add(0, 3, 0.1f);
+    store.add(0, 4, 0.7f);
+    store.setRowComputed(0);
+    EXPECT_TRUE(store.isRowComputed(0));
+
+    // top-k only, sorted by AA
+    ASSERT_EQ(3, store.getRowSize(0));
+    const m8r::AaNeighborStore::Neighbor* row = store.getRow(0);
+    EXPECT_EQ(2, row[0].note);
+    EXPECT_EQ(4, row[1].note);
+    EXPECT_EQ(1, row[2].note);
+    EXPECT_FLOAT_EQ(0.5f, row[2].aa);
+
+    ASSERT_EQ(1, store.getRowSize(3));
+    EXPECT_EQ(0, store.getRow(3)[0].note);
+    EXPECT_FLOAT_EQ(0.1f, store.getRow(3)[0].aa);
+
+    // tie: lower N index wins
+    store.add(3, 4, 0.1f);
+    store.add(3, 2, 0.1f);
+    store.add(3, 1, 0.1f);
+    ASSERT_EQ(3, store.getRowSize(3));
+    EXPECT_EQ(0, store.getRow(3)[0].note);
+    EXPECT_EQ(1, store.getRow(3)[1].note);
+    EXPECT_EQ(2, store.getRow(3)[2].note);
+
+    // offers are idempotent
+    store.add(3, 1, 0.1f);
+    EXPECT_EQ(3, store.getRowSize(3));
+
+    // invalidation: N's row dropped, N removed from other rows, full rows which lost N dropped
+    store.setRowComputed(3);
+    store.invalidate(2);
+    EXPECT_FALSE(store.isRowComputed(2));
+    EXPECT_EQ(0, store.getRowSize(2));
+    EXPECT_EQ(0, store.getRowSize(0));
+    EXPECT_FALSE(store.isRowComputed(0));
+    EXPECT_FALSE(store.isRowComputed(3));
+    EXPECT_FALSE(store.isAaOffered(1, 2));
+    // row w/o N is kept
+    ASSERT_EQ(2, store.getRowSize(4));
+    EXPECT_EQ(0, store.getRow(4)[0].note);
+
+    // grow
+    store.resize(7);
+    EXPECT_EQ(7, store.size());
+    EXPECT_EQ(2, store.getRowSize(4));
+    EXPECT_FALSE(store.isRowComputed(6));
+
+    store.clear();
+    EXPECT_EQ(0, store.size());
+
+    // invalidation finds rows w/ N using reverse index: no row refers to N after churn
+    m8r::AaNeighborStore churn{3};
+    churn.reset(50);
+    unsigned seed{7};
+    for(int i=0; i<5000; i++) {
+        seed = seed*1103515245u + 12345u;
+        size_t x = (seed>>8)%50;
+        size_t y = (seed>>16)%50;
+        if(i%10 == 9) {
+            churn.invalidate(x);
+            for(size_t r=0; r<churn.size(); r++) {
+                for(size_t j=0; j<churn.getRowSize(r); j++) {
+                    ASSERT_NE(static_cast<int32_t>(x), churn.getRow(r)[j].note);
+                }
+            }
+        } else if(x != y) {
+            churn.add(x, y, static_cast<float>((seed>>4)%1000)/1000.f);
+            if(i%7 == 0) {
+                churn.setRowComputed(x);
+            }
+        }
+    }
+}
+
+TEST(AiNlpTestCase, MinHashLsh)
+{
+    m8r::MinHashLsh lsh{16, 4};
+    lsh.reset(4);
+
+    vector<m8r::MinHashLsh::WeightedTerm> terms{};
+    for(uint64_t t=1; t<=8; t++) {
+        terms.push_back(make_pair(t, 1.f));
+    }
+    vector<m8r::MinHashLsh::WeightedTerm> disjointTerms{};
+    for(uint64_t t=101; t<=108; t++) {
+        disjointTerms.push_back(make_pair(t, 1.f));
+    }
+    lsh.add(0, terms);
+    // identical Ns share all buckets
+    lsh.add(1, terms);
+    // disjoint terms
+    lsh.add(2, disjointTerms);
+    // N w/o terms is not indexed
+    lsh.add(3, vector<m8r::MinHashLsh::WeightedTerm>{});
+
+    vector<int32_t> candidates{};
+    lsh.getCandidates(0, candidates);
+    ASSERT_EQ(1, candidates.size());
+    EXPECT_EQ(1, candidates[0]);
+
+    lsh.getCandidates(3, candidates);
+    EXPECT_EQ(0, candidates.size());
+
+    // Ns of the same group are candidates regardless their terms
+    lsh.remove(2);
+    lsh.remove(3);
+    lsh.add(2, disjointTerms, 7);
+    lsh.add(3, vector<m8r::MinHashLsh::WeightedTerm>{}, 7);
+    lsh.getCandidates(3, candidates);
+    ASSERT_EQ(1, candidates.size());
+    EXPECT_EQ(2, candidates[0]);
+    lsh.getCandidates(0, candidates);
+    ASSERT_EQ(1, candidates.size());
+    EXPECT_EQ(1, candidates[0]);
+
+    // removed N leaves its group
+    lsh.remove(2);
+    lsh.getCandidates(3, candidates);
+    EXPECT_EQ(0, candidates.size());
+}
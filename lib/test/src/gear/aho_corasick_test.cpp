@@ -0,0 +1,141 @@
+/*
+ aho_corasick_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "gear/aho_corasick.h"
+
+using namespace std;
+
+static int countByFind(const string& s, const string& pattern)
+{
+    int count = 0;
+    size_t m = s.find(pattern, 0);
+    while(m != string::npos) {
+        count++;
+        m = s.find(pattern, m+1);
+    }
+    return count;
+}
+
+TEST(AhoCorasickTestCase, CountMatches)
+{
+    // GIVEN
+    vector<string> patterns{"he", "she", "his", "hers", "he", "a"};
+    m8r::AhoCorasick automaton{};
+    for(string& p:patterns) {
+        automaton.addPattern(p);
+    }
+    ASSERT_EQ(-1, automaton.addPattern(""));
+    automaton.build();
+    ASSERT_EQ(patterns.size(), automaton.size());
+
+    // WHEN
+    string text{"ushers said his sheep\nhehehe aaa - h\xc3\xa9"};
+    vector<int> counts(automaton.size(), 0);
+    automaton.count(text, counts);
+
+    // THEN overlapping matches are counted like w/ find() loop (duplicate patterns included)
+    for(size_t i=0; i<patterns.size(); i++) {
+        cout << "  " << patterns[i] << ": " << counts[i] << endl;
+        EXPECT_EQ(countByFind(text, patterns[i]), counts[i]);
+    }
+    EXPECT_EQ(5, counts[0]);
+    EXPECT_EQ(5, counts[4]);
+    EXPECT_EQ(4, counts[5]);
+}
+
+TEST(AhoCorasickTestCase, MatchPositions)
+{
+    // GIVEN
+    m8r::AhoCorasick automaton{};
+    automaton.addPattern("mind");
+    automaton.addPattern("forger");
+    automaton.addPattern("mindforger");
+    automaton.build();
+
+    // WHEN
+    vector<pair<int,size_t>> matches{};
+    automaton.match("a mindforger", [&matches](int id, size_t end) {
+        matches.push_back(make_pair(id, end));
+    });
+
+    // THEN
+    ASSERT_EQ(3, matches.size());
+    EXPECT_EQ(0, matches[0].first);
+    EXPECT_EQ(6, matches[0].second);
+    EXPECT_EQ(2, matches[1].first);
+    EXPECT_EQ(12, matches[1].second);
+    EXPECT_EQ(1, matches[2].first);
+    EXPECT_EQ(12, matches[2].second);
+    EXPECT_EQ(10, automaton.getPatternLength(2));
+
+    // empty automaton matches nothing
+    m8r::AhoCorasick empty{};
+    empty.build();
+    vector<int> counts{};
+    empty.count("text", counts);
+    EXPECT_TRUE(counts.empty());
+}
+
+TEST(AhoCorasickTestCase, ManyPatterns)
+{
+    // GIVEN thousands of short patterns over small alphabet (many shared prefixes/suffixes)
+    srand(7);
+    m8r::AhoCorasick automaton{};
+    vector<string> patterns{};
+    for(int i=0; i<3000; i++) {
+        string p{};
+        for(int l=1+rand()%6; l>0; l--) {
+            p += static_cast<char>('a'+rand()%4);
+        }
+        patterns.push_back(p);
+        ASSERT_EQ(i, automaton.addPattern(p));
+    }
+    automaton.build();
+    ASSERT_EQ(-1, automaton.addPattern("abc"));
+
+    string text{};
+    for(int i=0; i<2000; i++) {
+        text += static_cast<char>('a'+rand()%5);
+    }
+
+    // WHEN
+    vector<int> counts(automaton.size(), 0);
+    size_t wrongPositions = 0;
+    automaton.match(text, [&](int id, size_t end) {
+        counts[id]++;
+        const string& p = patterns[id];
+        if(end < p.size() || text.compare(end-p.size(), p.size(), p)) {
+            wrongPositions++;
+        }
+    });
+
+    // THEN
+    EXPECT_EQ(0, wrongPositions);
+    for(size_t i=0; i<patterns.size(); i++) {
+        ASSERT_EQ(countByFind(text, patterns[i]), counts[i]) << patterns[i];
+    }
+    cout << "  footprint: " << automaton.getFootprint() << "B" << endl;
+}
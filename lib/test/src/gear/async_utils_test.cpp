@@ -0,0 +1,112 @@
+/*
+ async_utils_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gear/async_utils.h"
+#include "gear/worker_pool.h"
+
+using namespace std;
+
+TEST(AsyncUtilsTestCase, ParallelForBlocks)
+{
+    EXPECT_GE(m8r::getDefaultWorkersCount(), 1u);
+
+    // GIVEN
+    const size_t size = 1000;
+    const unsigned int workers = 4;
+    vector<int> visits(size, 0);
+    vector<long> sums(workers, 0);
+
+    // WHEN
+    m8r::parallelForBlocks(
+        size,
+        7,
+        workers,
+        [&visits,&sums](unsigned int w, size_t begin, size_t end) {
+            for(size_t i=begin; i<end; i++) {
+                visits[i]++;
+                sums[w] += static_cast<long>(i);
+            }
+        });
+
+    // THEN every index processed exactly once
+    long sum = 0;
+    for(long s:sums) sum += s;
+    EXPECT_EQ(static_cast<long>(size*(size-1)/2), sum);
+    for(size_t i=0; i<size; i++) {
+        ASSERT_EQ(1, visits[i]);
+    }
+
+    // empty interval and single worker
+    int calls = 0;
+    m8r::parallelForBlocks(0, 7, workers, [&calls](unsigned int, size_t, size_t) { calls++; });
+    EXPECT_EQ(0, calls);
+    m8r::parallelForBlocks(10, 3, 1, [&calls](unsigned int w, size_t begin, size_t end) {
+        EXPECT_EQ(0u, w);
+        EXPECT_EQ(0u, begin);
+        EXPECT_EQ(10u, end);
+        calls++;
+    });
+    EXPECT_EQ(1, calls);
+}
+
+TEST(AsyncUtilsTestCase, WorkerPool)
+{
+    m8r::WorkerPool pool{};
+    const unsigned int workers = 4;
+
+    // WHEN many short jobs are run
+    for(int j=0; j<1000; j++) {
+        atomic<size_t> sum{0};
+        pool.run(100, 10, workers, [&sum,workers](unsigned int w, size_t begin, size_t end) {
+            EXPECT_LT(w, workers);
+            for(size_t i=begin; i<end; i++) sum += i;
+        });
+        ASSERT_EQ(4950u, sum.load());
+    }
+    // THEN threads are reused
+    EXPECT_EQ(workers-1, pool.getThreadsCount());
+
+    // WHEN jobs are run by concurrent callers and a job runs nested job
+    atomic<size_t> total{0};
+    auto caller = [&pool,&total,workers]() {
+        for(int j=0; j<100; j++) {
+            pool.run(8, 1, workers, [&pool,&total,workers](unsigned int, size_t begin, size_t end) {
+                for(size_t i=begin; i<end; i++) {
+                    pool.run(10, 2, workers, [&total](unsigned int w, size_t b, size_t e) {
+                        EXPECT_EQ(0u, w);
+                        total += e-b;
+                    });
+                }
+            });
+        }
+    };
+    thread other{caller};
+    caller();
+    other.join();
+    // THEN jobs are serialized and nested jobs run by the calling thread
+    EXPECT_EQ(2u*100u*8u*10u, total.load());
+    EXPECT_EQ(workers-1, pool.getThreadsCount());
+}
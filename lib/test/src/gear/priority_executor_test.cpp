@@ -0,0 +1,101 @@
+/*
+ priority_executor_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <mutex>
+
+#include <gtest/gtest.h>
+
+#include "gear/priority_executor.h"
+
+using namespace std;
+
+TEST(PriorityExecutorTestCase, PriorityDeduplicationCancellation)
+{
+    m8r::PriorityExecutor executor{1};
+    EXPECT_EQ(1u, executor.getThreadsCount());
+
+    int keys[5];
+    vector<int> order{};
+    mutex orderMutex;
+
+    // GIVEN blocked executor thread
+    promise<void> started{};
+    promise<void> gate{};
+    shared_future<void> gateFuture = gate.get_future().share();
+    shared_future<bool> blocker = executor.submit(
+        &keys[0],
+        m8r::PriorityExecutor::PRIORITY_NORMAL,
+        [&started,gateFuture]() { started.set_value(); gateFuture.wait(); return true; });
+    started.get_future().wait();
+    // running task can NOT be cancelled
+    EXPECT_FALSE(executor.cancel(&keys[0]));
+    EXPECT_TRUE(executor.isInFlight(&keys[0]));
+
+    auto record = [&order,&orderMutex](int i) {
+        return [&order,&orderMutex,i]() { lock_guard<mutex> l{orderMutex}; order.push_back(i); return true; };
+    };
+
+    // WHEN tasks are queued w/ different priorities
+    bool isNew;
+    shared_future<bool> low = executor.submit(&keys[1], m8r::PriorityExecutor::PRIORITY_LOW, record(1), &isNew);
+    EXPECT_TRUE(isNew);
+    shared_future<bool> normal = executor.submit(&keys[2], m8r::PriorityExecutor::PRIORITY_NORMAL, record(2));
+    shared_future<bool> high = executor.submit(&keys[3], m8r::PriorityExecutor::PRIORITY_HIGH, record(3));
+    shared_future<bool> cancelled = executor.submit(&keys[4], m8r::PriorityExecutor::PRIORITY_NORMAL, record(4));
+
+    // THEN duplicate request joins in-flight task and raises its priority
+    shared_future<bool> lowDuplicate = executor.submit(&keys[1], m8r::PriorityExecutor::PRIORITY_HIGH, record(100), &isNew);
+    EXPECT_FALSE(isNew);
+
+    // THEN queued task can be cancelled
+    EXPECT_TRUE(executor.cancel(&keys[4]));
+    EXPECT_FALSE(executor.cancel(&keys[4]));
+    EXPECT_FALSE(cancelled.get());
+
+    gate.set_value();
+    EXPECT_TRUE(blocker.get());
+    EXPECT_TRUE(low.get());
+    EXPECT_TRUE(lowDuplicate.get());
+    EXPECT_TRUE(normal.get());
+    EXPECT_TRUE(high.get());
+
+    ASSERT_EQ(3u, order.size());
+    EXPECT_EQ(1, order[0]); // raised to HIGH before 3 was submitted
+    EXPECT_EQ(3, order[1]);
+    EXPECT_EQ(2, order[2]);
+    EXPECT_FALSE(executor.isInFlight(&keys[1]));
+
+    // cancel pending by priority
+    promise<void> gate2{};
+    shared_future<void> gate2Future = gate2.get_future().share();
+    executor.submit(&keys[0], m8r::PriorityExecutor::PRIORITY_HIGH, [gate2Future]() { gate2Future.wait(); return true; });
+    executor.submit(&keys[1], m8r::PriorityExecutor::PRIORITY_NORMAL, record(1));
+    executor.submit(&keys[2], m8r::PriorityExecutor::PRIORITY_NORMAL, record(2));
+    shared_future<bool> kept = executor.submit(&keys[3], m8r::PriorityExecutor::PRIORITY_HIGH, record(3));
+    EXPECT_EQ(1u, executor.cancelPending(m8r::PriorityExecutor::PRIORITY_NORMAL, &keys[2]));
+    gate2.set_value();
+    EXPECT_TRUE(kept.get());
+
+    // shutdown cancels pending and joins threads, futures stay valid
+    executor.shutdown();
+    shared_future<bool> afterShutdown = executor.submit(&keys[4], m8r::PriorityExecutor::PRIORITY_HIGH, record(4));
+    EXPECT_FALSE(afterShutdown.get());
+}
@@ -102,3 +102,36 @@ TEST(TrieTestCase, AddAndRemove)
     ASSERT_FALSE(trie.findWord(word));
     ASSERT_EQ(13, count);
 }
+
+TEST(TrieTestCase, ManyChildrenAndPrefixes)
+{
+    // GIVEN words w/ all byte labels (nodes w/ many children are searched by binary search)
+    m8r::Trie trie{};
+    vector<string> words{};
+    for(int c=255; c>0; c--) {
+        words.push_back(string{"x"}+static_cast<char>(c)+"yz");
+        words.push_back(string(1, static_cast<char>(c)));
+    }
+    for(string& w:words) {
+        trie.addWord(w);
+    }
+
+    // THEN
+    for(string& w:words) {
+        ASSERT_TRUE(trie.findWord(w));
+    }
+    ASSERT_FALSE(trie.findWord("xayzz"));
+    ASSERT_FALSE(trie.findWord("xay"));
+    ASSERT_EQ(1+255+255*3, trie.size());
+
+    // longest prefix word
+    string r{};
+    ASSERT_TRUE(trie.findLongestPrefixWord("xbyzw", r));
+    ASSERT_EQ("xbyz", r);
+    r.clear();
+    ASSERT_TRUE(trie.findLongestPrefixWord("xbyw", r));
+    ASSERT_EQ("x", r);
+    trie.removeWord("x");
+    r.clear();
+    ASSERT_FALSE(trie.findLongestPrefixWord("xby", r));
+}
@@ -17,10 +17,13 @@
  along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <cstdio>
+#include <thread>
+#include <vector>
 #ifndef _WIN32
 #  include <unistd.h>
 #endif //_WIN32
@@ -29,8 +32,10 @@
 
 #include "../test_utils.h"
 #include "representations/html/html_outline_representation.h"
+#include "representations/html/html_live_preview.h"
 #include "mind/mind.h"
 #include "persistence/filesystem_persistence.h"
+#include "representations/markdown/cmark_gfm_markdown_transcoder.h"
 
 using namespace std;
 
@@ -74,6 +79,234 @@ TEST(HtmlTestCase, Outline)
     EXPECT_NE(std::string::npos, html.find("Stroustrup"));
 }
 
+TEST(HtmlTestCase, OutlineFragments)
+{
+    string fileName{"/lib/test/resources/markdown-repository/memory/feature-md-2-html-extensions.md"};
+    fileName.insert(0, getMindforgerGitHomePath());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-htc-of.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(fileName)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    m8r::HtmlColorsMock dummyColors{};
+    m8r::HtmlOutlineRepresentation htmlRepresentation{mind.remind().getOntology(),dummyColors,nullptr};
+    mind.learn();
+    mind.think().get();
+
+    ASSERT_EQ(1, mind.remind().getOutlinesCount());
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    const size_t ns = o->getNotesCount();
+    ASSERT_GE(ns, 2);
+
+    // WHEN O is rendered for the first time
+    string html{};
+    htmlRepresentation.to(o, &html, false, false, true, true);
+    // THEN O header and all Ns are transcoded
+    EXPECT_NE(std::string::npos, html.find("<body><table"));
+    EXPECT_EQ(0, html.find("<!DOCTYPE html>"));
+    EXPECT_EQ(html.size()-14, html.rfind("</body></html>"));
+    EXPECT_EQ(0, htmlRepresentation.getFragmentHits());
+    EXPECT_EQ(ns+1, htmlRepresentation.getFragmentMisses());
+
+    // WHEN O is rendered again
+    string cachedHtml{};
+    htmlRepresentation.to(o, &cachedHtml, false, false, true, true);
+    // THEN O is assembled from fragments only
+    EXPECT_EQ(ns+1, htmlRepresentation.getFragmentHits());
+    EXPECT_EQ(ns+1, htmlRepresentation.getFragmentMisses());
+    EXPECT_EQ(html, cachedHtml);
+
+    // WHEN one N is changed
+    m8r::Note* n = o->getNotes()[1];
+    n->addDescriptionLine(new string{"Fragment cache canary."});
+    n->makeModified();
+    string changedHtml{};
+    htmlRepresentation.to(o, &changedHtml, false, false, true, true);
+    // THEN only the changed N is transcoded
+    EXPECT_EQ(2*ns+1, htmlRepresentation.getFragmentHits());
+    EXPECT_EQ(ns+2, htmlRepresentation.getFragmentMisses());
+    EXPECT_NE(std::string::npos, changedHtml.find("Fragment cache canary."));
+
+    // THEN assembled HTML is the same as HTML rendered from scratch
+    m8r::HtmlOutlineRepresentation freshRepresentation{mind.remind().getOntology(),dummyColors,nullptr};
+    string freshHtml{};
+    freshRepresentation.to(o, &freshHtml, false, false, true, true);
+    EXPECT_EQ(freshHtml, changedHtml);
+
+    // WHEN autolinking is requested, but there is no autolinking interceptor
+    htmlRepresentation.to(o, &html, false, true, true, true);
+    // THEN fragments are reused
+    EXPECT_EQ(3*ns+2, htmlRepresentation.getFragmentHits());
+
+    // WHEN fragments are dropped
+    htmlRepresentation.clearFragments();
+    htmlRepresentation.to(o, &html, false, false, true, true);
+    EXPECT_EQ(2*ns+3, htmlRepresentation.getFragmentMisses());
+}
+
+TEST(HtmlTestCase, LivePreviewBlocks)
+{
+    vector<string*> lines{};
+    for(const char* l: {
+            "Paragraph",
+            "continued.",
+            "",
+            "```",
+            "code",
+            "",
+            "more code",
+            "```",
+            "",
+            "- item",
+            "",
+            "  continuation",
+            "",
+            "- loose item",
+            "",
+            "<!-- comment",
+            "",
+            "-->",
+            "$$",
+            "",
+            "x^2",
+            "$$",
+            "",
+            "",
+            "Last."})
+    {
+        lines.push_back(new string{l});
+    }
+
+    // WHEN MD is split to blocks
+    vector<string> blocks{};
+    m8r::HtmlLivePreview::splitBlocks(lines, blocks);
+    // THEN code, list and HTML/math blocks are not split on blank lines
+    ASSERT_EQ(5, blocks.size());
+    EXPECT_EQ("Paragraph\ncontinued.\n", blocks[0]);
+    EXPECT_EQ("```\ncode\n\nmore code\n```\n", blocks[1]);
+    EXPECT_EQ("- item\n\n  continuation\n\n- loose item\n", blocks[2]);
+    EXPECT_EQ("<!-- comment\n\n-->\n$$\n\nx^2\n$$\n", blocks[3]);
+    EXPECT_EQ("Last.\n", blocks[4]);
+
+    // WHEN MD has link reference definitions
+    lines.push_back(new string{""});
+    lines.push_back(new string{"[mf]: https://www.mindforger.com"});
+    blocks.clear();
+    m8r::HtmlLivePreview::splitBlocks(lines, blocks);
+    // THEN it is not split
+    EXPECT_EQ(1, blocks.size());
+
+    for(string* l:lines) {
+        delete l;
+    }
+
+    // JavaScript string literal
+    string js{};
+    m8r::HtmlLivePreview::toJavaScriptString("a'b\\c\nd\x01</p>\xE2\x80\xA8", js);
+    EXPECT_EQ("'a\\'b\\\\c\\nd\\x01</p>\\u2028'", js);
+}
+
+TEST(HtmlTestCase, LivePreview)
+{
+    string fileName{"/lib/test/resources/markdown-repository/memory/feature-md-2-html-extensions.md"};
+    fileName.insert(0, getMindforgerGitHomePath());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-htc-lp.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(fileName)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    m8r::HtmlColorsMock dummyColors{};
+    m8r::HtmlOutlineRepresentation htmlRepresentation{mind.remind().getOntology(),dummyColors,nullptr};
+    m8r::HtmlLivePreview livePreview{htmlRepresentation};
+    mind.learn();
+    mind.think().get();
+
+    ASSERT_EQ(1, mind.remind().getOutlinesCount());
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    m8r::Note note{o->getNotes()[0]->getType(), o};
+    note.setName("Live preview");
+    for(const char* l: {"First.", "", "Second.", "", "Third."}) {
+        note.addDescriptionLine(new string{l});
+    }
+
+    // WHEN N is previewed for the first time
+    string html{}, js{};
+    EXPECT_FALSE(livePreview.to(&note, html, js));
+    // THEN whole page w/ blocks is created
+    EXPECT_EQ(0, html.find("<!DOCTYPE html>"));
+    EXPECT_NE(std::string::npos, html.find("<div id=\"mf-live-preview\" data-mf-token=\"1\">"));
+    EXPECT_NE(std::string::npos, html.find("Second."));
+    EXPECT_TRUE(js.empty());
+    EXPECT_EQ(3, livePreview.getTranscodedBlocks());
+
+    // WHEN nothing is changed
+    html.clear();
+    EXPECT_TRUE(livePreview.to(&note, html, js));
+    // THEN there is nothing to do
+    EXPECT_TRUE(html.empty());
+    EXPECT_TRUE(js.empty());
+    EXPECT_EQ(3, livePreview.getTranscodedBlocks());
+
+    // WHEN one block is changed
+    note.getDescription()[2]->assign("Second (edited).");
+    EXPECT_TRUE(livePreview.to(&note, html, js));
+    // THEN only changed block is transcoded and patched
+    EXPECT_TRUE(html.empty());
+    EXPECT_EQ(4, livePreview.getTranscodedBlocks());
+    EXPECT_NE(std::string::npos, js.find("Second (edited)."));
+    EXPECT_EQ(std::string::npos, js.find("First."));
+    EXPECT_EQ(std::string::npos, js.find("Third."));
+    EXPECT_NE(std::string::npos, js.find("data-mf-token')!='1'"));
+    EXPECT_NE(std::string::npos, js.find("i<1;i++)c.removeChild(c.children[2])"));
+
+    // WHEN block is inserted
+    note.addDescriptionLine(new string{""});
+    note.addDescriptionLine(new string{"Fourth."});
+    EXPECT_TRUE(livePreview.to(&note, html, js));
+    // THEN nothing is removed and only the new block is transcoded
+    EXPECT_EQ(5, livePreview.getTranscodedBlocks());
+    EXPECT_NE(std::string::npos, js.find("i<0;i++)c.removeChild(c.children[4])"));
+    EXPECT_EQ(std::string::npos, js.find("window.scrollTo"));
+
+    // WHEN block is changed while editor is scrolled
+    note.getDescription()[4]->assign("Third (edited).");
+    EXPECT_TRUE(livePreview.to(&note, html, js, 50));
+    // THEN patched page is scrolled as well
+    EXPECT_EQ(6, livePreview.getTranscodedBlocks());
+    EXPECT_NE(std::string::npos, js.find("window.scrollTo(0,(document.body.scrollHeight/100)*50);return true;"));
+
+    // WHEN N name is changed
+    note.setName("Live preview (renamed)");
+    EXPECT_TRUE(livePreview.to(&note, html, js));
+    // THEN only header is patched
+    EXPECT_EQ(6, livePreview.getTranscodedBlocks());
+    EXPECT_NE(std::string::npos, js.find("renamed"));
+    EXPECT_NE(std::string::npos, js.find("c.removeChild(c.children[0])"));
+
+    // WHEN view was loaded w/ different HTML
+    livePreview.reset();
+    EXPECT_FALSE(livePreview.to(&note, html, js));
+    // THEN whole page is created again
+    EXPECT_NE(std::string::npos, html.find("data-mf-token=\"2\""));
+    EXPECT_EQ(10, livePreview.getTranscodedBlocks());
+    EXPECT_TRUE(js.empty());
+
+    // WHEN O header is previewed in the same view
+    EXPECT_TRUE(livePreview.to(o, html, js));
+    // THEN O header replaces N header and description blocks are patched
+    EXPECT_NE(std::string::npos, js.find("var h=['<table"));
+}
+
 TEST(HtmlTestCase, Note)
 {
     string fileName{"/lib/test/resources/benchmark-repository/memory/meta.md"};
@@ -161,3 +394,69 @@ TEST(HtmlTestCase, TaskList)
     cout << "= BEGIN N HTML =" << endl << html << endl << "= END N HTML =" << endl;
     EXPECT_NE(std::string::npos, html.find("input"));
 }
+
+#ifdef MF_MD_2_HTML_CMARK
+TEST(HtmlTestCase, CmarkRender)
+{
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    m8r::CmarkGfmMarkdownTranscoder transcoder{};
+
+    // GIVEN Markdown w/ GFM extensions
+    const string md{
+        "# Title\n\nText *emphasis* and ~~strike~~.\n\n"
+        "| a | b |\n|---|---|\n| 1 | 2 |\n\n"
+        "- [x] done\n"};
+    string expected{};
+    transcoder.to(m8r::RepresentationType::HTML, &md, &expected);
+    EXPECT_NE(string::npos, expected.find("<table>"));
+    EXPECT_NE(string::npos, expected.find("<del>strike</del>"));
+    EXPECT_NE(string::npos, expected.find("<em>emphasis</em>"));
+
+    // WHEN the same Markdown is rendered repeatedly
+    for(int i=0; i<100; i++) {
+        string html{};
+        transcoder.to(m8r::RepresentationType::HTML, &md, &html);
+        ASSERT_EQ(expected, html);
+    }
+
+    // WHEN big Markdown is rendered as string and as lines
+    string big{};
+    vector<string*> lines{};
+    for(int i=0; i<20000; i++) {
+        const string line{"Paragraph " + std::to_string(i) + " w/ [link](http://example.com/" + std::to_string(i) + ")."};
+        big += line + "\n\n";
+        lines.push_back(new string{line});
+        lines.push_back(new string{});
+    }
+    string bigHtml{}, linesHtml{};
+    transcoder.to(m8r::RepresentationType::HTML, &big, &bigHtml);
+    transcoder.to(m8r::RepresentationType::HTML, "", lines, &linesHtml);
+    for(string* l:lines) {
+        delete l;
+    }
+    // THEN whole Markdown is rendered and both APIs give the same HTML
+    EXPECT_NE(string::npos, bigHtml.find("<a href=\"http://example.com/19999\">"));
+    EXPECT_EQ(bigHtml, linesHtml);
+
+    // WHEN Markdown is rendered by more threads concurrently (HTML export workers)
+    atomic<int> mismatches{0};
+    vector<thread> threads{};
+    for(int t=0; t<16; t++) {
+        threads.emplace_back([&transcoder,&md,&expected,&mismatches]() {
+            for(int i=0; i<20; i++) {
+                string h{};
+                transcoder.to(m8r::RepresentationType::HTML, &md, &h);
+                if(h != expected) {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for(thread& t:threads) {
+        t.join();
+    }
+    // THEN every render is correct
+    EXPECT_EQ(0, mismatches.load());
+}
+#endif
@@ -178,6 +178,8 @@ TEST(RepositoryIndexerTestCase, MindForgerRepository)
     delete outlineAsString;
 
     mind.remind().remember(outline);
+    // O is written in background
+    EXPECT_TRUE(mind.remind().getPersistence().flush());
 
     outlineAsString = m8r::fileToString(outline->getKey());
     EXPECT_NE(std::string::npos, outlineAsString->find("Metadata"));
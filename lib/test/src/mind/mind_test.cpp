@@ -313,3 +313,106 @@ TEST(MindTestCase, CommonWordsBlacklist) {
     ASSERT_TRUE(blacklist.findWord("you"));
     ASSERT_TRUE(blacklist.findWord("the"));
 }
+
+TEST(MindTestCase, ThingsCompletionIndex) {
+    string repositoryPath{"/tmp/mf-unit-things"};
+    string path, content;
+    m8r::removeDirectoryRecursively(repositoryPath.c_str());
+#ifdef _WIN32
+    int e = _mkdir(repositoryPath.c_str());
+#else
+    int e = mkdir(repositoryPath.c_str(), S_IRUSR | S_IWUSR | S_IXUSR);
+#endif // _WIN32
+    ASSERT_EQ(e, 0);
+    path.assign(repositoryPath+"/1.md");
+    content.assign(
+        "# First Markdown"
+        "\n"
+        "\n## Note 1"
+        "\nNote 1 text."
+        "\n"
+        "\n## Nothing"
+        "\nNothing text."
+        "\n");
+    m8r::stringToFile(path, content);
+    path.assign(repositoryPath+"/2.md");
+    content.assign(
+        "# Second Markdown"
+        "\n"
+        "\n## Note 2"
+        "\nNote 2 text."
+        "\n");
+    m8r::stringToFile(path, content);
+
+    m8r::Repository* repository = new m8r::Repository(
+        repositoryPath,
+        m8r::Repository::RepositoryType::MARKDOWN,
+        m8r::Repository::RepositoryMode::REPOSITORY,
+        "",
+        false);
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-tci.md");
+    config.setActiveRepository(config.addRepository(repository), repositoryConfigRepresentation);
+    m8r::Mind mind(config);
+    mind.learn();
+
+    // all things
+    vector<m8r::Thing*> things{};
+    vector<string> names{};
+    mind.getAllThings(things, &names);
+    EXPECT_EQ(5, things.size());
+    EXPECT_EQ(5, names.size());
+
+    // prefix ~ sorted by name
+    string prefix{"Not"};
+    things.clear(); names.clear();
+    mind.getAllThings(things, &names, &prefix);
+    ASSERT_EQ(3, things.size());
+    EXPECT_EQ("Note 1 (First Markdown)", names[0]);
+    EXPECT_EQ("Note 2 (Second Markdown)", names[1]);
+    EXPECT_EQ("Nothing (First Markdown)", names[2]);
+
+    // limit
+    things.clear(); names.clear();
+    mind.getAllThings(things, &names, &prefix, m8r::ThingNameSerialization::NAME, nullptr, 1);
+    ASSERT_EQ(1, things.size());
+    EXPECT_EQ("Note 1", names[0]);
+
+    // links
+    things.clear(); names.clear();
+    prefix.assign("Second");
+    mind.getAllThings(things, &names, &prefix, m8r::ThingNameSerialization::LINK);
+    ASSERT_EQ(1, things.size());
+    EXPECT_EQ("[Second Markdown](2.md)", names[0]);
+
+    // rename & remember
+    m8r::Outline* o = static_cast<m8r::Outline*>(things[0]);
+    o->getNotes()[0]->setName("Renamed");
+    mind.remember(o->getKey());
+    prefix.assign("Not");
+    things.clear(); names.clear();
+    mind.getAllThings(things, &names, &prefix);
+    EXPECT_EQ(2, things.size());
+    prefix.assign("Renamed");
+    things.clear(); names.clear();
+    mind.getAllThings(things, &names, &prefix);
+    EXPECT_EQ(1, things.size());
+
+    // forget N
+    prefix.assign("Nothing");
+    things.clear(); names.clear();
+    mind.getAllThings(things, &names, &prefix);
+    ASSERT_EQ(1, things.size());
+    mind.noteForget(static_cast<m8r::Note*>(things[0]));
+    things.clear(); names.clear();
+    mind.getAllThings(things, &names, &prefix);
+    EXPECT_EQ(0, things.size());
+
+    // forget O
+    mind.outlineForget(o->getKey());
+    things.clear(); names.clear();
+    mind.getAllThings(things, &names);
+    EXPECT_EQ(2, things.size());
+}
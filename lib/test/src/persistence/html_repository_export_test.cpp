@@ -0,0 +1,163 @@
+/*
+ html_repository_export_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../test_utils.h"
+#include "persistence/html_repository_export.h"
+#include "mind/mind.h"
+
+using namespace std;
+
+extern char* getMindforgerGitHomePath();
+
+class ExportProgressCallbackCtx : public m8r::ProgressCallbackCtx
+{
+public:
+    int updates;
+    float last;
+
+    explicit ExportProgressCallbackCtx() : updates{0}, last{0.0} {}
+    virtual void updateProgress(float progress) override {
+        updates++;
+        last = progress;
+    }
+};
+
+TEST(HtmlRepositoryExportTestCase, RewriteLinks)
+{
+    // GIVEN
+    map<string,string> exported{
+        {"/m/memory/a.md", "a.html"},
+        {"/m/memory/sub/b.md", "sub/b.html"},
+        {"/m/memory/c d.md", "c d.html"}
+    };
+    string html{
+        "<a href=\"sub/b.md\">1</a>"
+        "<a href=\"./a.md#n2\">2</a>"
+        "<a href=\"/m/memory/sub/b.md\">3</a>"
+        "<a href=\"https://www.mindforger.com/a.md\">4</a>"
+        "<a href=\"#a.md\">5</a>"
+        "<a href=\"missing.md\">6</a>"
+        "<a href=\"c%20d.md\">7</a>"
+        "<img src=\"a.md\"/>"
+    };
+    vector<pair<string,bool>> dependencies{};
+
+    // WHEN
+    m8r::HtmlRepositoryExport::rewriteLinks(html, "/m/memory", "a.html", exported, dependencies);
+
+    // THEN
+    cout << html << endl;
+    EXPECT_EQ(
+        "<a href=\"sub/b.html\">1</a>"
+        "<a href=\"a.html#n2\">2</a>"
+        "<a href=\"sub/b.html\">3</a>"
+        "<a href=\"https://www.mindforger.com/a.md\">4</a>"
+        "<a href=\"#a.md\">5</a>"
+        "<a href=\"missing.md\">6</a>"
+        "<a href=\"c d.html\">7</a>"
+        "<img src=\"a.md\"/>",
+        html);
+    ASSERT_EQ(5, dependencies.size());
+    EXPECT_EQ("/m/memory/missing.md", dependencies[3].first);
+    EXPECT_FALSE(dependencies[3].second);
+    EXPECT_TRUE(dependencies[4].second);
+
+    // links from subdirectory
+    html.assign("<a href=\"../a.md\">1</a><a href=\"b.md\">2</a>");
+    m8r::HtmlRepositoryExport::rewriteLinks(html, "/m/memory/sub", "sub/b.html", exported, dependencies);
+    EXPECT_EQ("<a href=\"../a.html\">1</a><a href=\"b.html\">2</a>", html);
+
+    EXPECT_EQ("/m/a.md", m8r::HtmlRepositoryExport::normalizePath("/m/./x/../y/.././a.md"));
+    EXPECT_EQ("../x/y.html", m8r::HtmlRepositoryExport::relativePath("a/b.html", "x/y.html"));
+}
+
+TEST(HtmlRepositoryExportTestCase, IncrementalExport)
+{
+    string repositoryPath{"/lib/test/resources/links-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    string exportPath{"/tmp/mf-unit-html-export"};
+    m8r::removeDirectoryRecursively(exportPath.c_str());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-hretc-ie.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    mind.learn();
+    mind.think().get();
+
+    const vector<m8r::Outline*>& outlines = mind.remind().getOutlines();
+    ASSERT_EQ(5, outlines.size());
+    m8r::HtmlRepositoryExport htmlExport{*mind.getHtmlRepresentation()};
+
+    // WHEN whole repository is exported
+    ExportProgressCallbackCtx progress{};
+    ASSERT_TRUE(htmlExport.to(outlines, config.getMemoryPath(), exportPath, true, &progress));
+
+    // THEN memory directory structure is kept
+    EXPECT_EQ(5, htmlExport.getExportedCount());
+    EXPECT_EQ(0, htmlExport.getSkippedCount());
+    EXPECT_TRUE(m8r::isFile((exportPath+"/links-src.html").c_str()));
+    EXPECT_TRUE(m8r::isFile((exportPath+"/dst-subdir/links-dst.html").c_str()));
+    EXPECT_TRUE(m8r::isFile((exportPath+"/src-subdir/links-subdir-src.html").c_str()));
+    EXPECT_TRUE(m8r::isFile((exportPath+"/"+m8r::HtmlRepositoryExport::MANIFEST_FILE_NAME).c_str()));
+    EXPECT_LT(0, progress.updates);
+    EXPECT_FLOAT_EQ(1.0, progress.last);
+
+    // WHEN nothing changed
+    ASSERT_TRUE(htmlExport.to(outlines, config.getMemoryPath(), exportPath, true));
+    // THEN all Os are skipped
+    EXPECT_EQ(0, htmlExport.getExportedCount());
+    EXPECT_EQ(5, htmlExport.getSkippedCount());
+
+    // WHEN one O is changed
+    outlines[0]->makeModified();
+    ASSERT_TRUE(htmlExport.to(outlines, config.getMemoryPath(), exportPath, true));
+    // THEN only the changed O is exported
+    EXPECT_EQ(1, htmlExport.getExportedCount());
+    EXPECT_EQ(4, htmlExport.getSkippedCount());
+
+    // WHEN theme is changed
+    const string themeName{config.getUiThemeName()};
+    config.setUiThemeName(themeName+"-changed");
+    ASSERT_TRUE(htmlExport.to(outlines, config.getMemoryPath(), exportPath, true));
+    // THEN all Os are exported again
+    EXPECT_EQ(5, htmlExport.getExportedCount());
+    EXPECT_EQ(0, htmlExport.getSkippedCount());
+    config.setUiThemeName(themeName);
+
+    // WHEN export is NOT incremental
+    ASSERT_TRUE(mind.remind().exportToHtml(exportPath));
+    // THEN no O is skipped
+    ASSERT_TRUE(htmlExport.to(outlines, config.getMemoryPath(), exportPath, false));
+    EXPECT_EQ(5, htmlExport.getExportedCount());
+
+    m8r::removeDirectoryRecursively(exportPath.c_str());
+}
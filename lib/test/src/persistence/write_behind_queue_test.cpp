@@ -0,0 +1,217 @@
+/*
+ write_behind_queue_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2022 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <gtest/gtest.h>
+
+#include "../test_utils.h"
+#include "persistence/write_behind_queue.h"
+#include "mind/mind.h"
+
+using namespace std;
+
+extern char* getMindforgerGitHomePath();
+
+namespace {
+
+unsigned countFiles(const string& directory)
+{
+    unsigned count{0};
+    DIR* dir = opendir(directory.c_str());
+    if(dir) {
+        struct dirent* entry;
+        while((entry = readdir(dir)) != nullptr) {
+            if(string{"."} != entry->d_name && string{".."} != entry->d_name) {
+                count++;
+            }
+        }
+        closedir(dir);
+    }
+    return count;
+}
+
+}
+
+TEST(WriteBehindQueueTestCase, AtomicWrite)
+{
+    string directory{"/tmp/mf-unit-write-behind-atomic"};
+    m8r::removeDirectoryRecursively(directory.c_str());
+    m8r::createDirectory(directory);
+    string fileName{directory+"/o.md"};
+    m8r::stringToFile(fileName, "# Original\n");
+    chmod(fileName.c_str(), 0640);
+
+    // WHEN file is replaced
+    EXPECT_TRUE(m8r::WriteBehindQueue::writeAtomically(fileName, "# Replaced\n\nText.\n"));
+
+    // THEN content is replaced, permissions are kept and no temporary file is left
+    string* content = m8r::fileToString(fileName);
+    EXPECT_EQ("# Replaced\n\nText.\n", *content);
+    delete content;
+    struct stat attrs{};
+    ASSERT_EQ(0, stat(fileName.c_str(), &attrs));
+    EXPECT_EQ(0640, attrs.st_mode & 07777);
+    EXPECT_EQ(1, countFiles(directory));
+
+    // WHEN file cannot be written
+    EXPECT_FALSE(m8r::WriteBehindQueue::writeAtomically(directory+"/missing/o.md", "# Lost\n"));
+}
+
+TEST(WriteBehindQueueTestCase, CoalesceAndFlush)
+{
+    string directory{"/tmp/mf-unit-write-behind-queue"};
+    m8r::removeDirectoryRecursively(directory.c_str());
+    m8r::createDirectory(directory);
+    string a{directory+"/a.md"};
+    string b{directory+"/b.md"};
+
+    m8r::WriteBehindQueue queue{};
+
+    // WHEN the same file is saved repeatedly
+    const unsigned saves{100};
+    for(unsigned i=0; i<saves; i++) {
+        queue.write(a, new string{"# A "+std::to_string(i)+"\n"});
+    }
+    queue.write(b, new string{"# B\n"});
+    EXPECT_TRUE(queue.flush());
+
+    // THEN saves which weren't written yet are coalesced and the last content wins
+    EXPECT_EQ(saves+1, queue.getWrittenCount()+queue.getCoalescedCount());
+    EXPECT_EQ(0, queue.getFailedCount());
+    string* content = m8r::fileToString(a);
+    EXPECT_EQ("# A 99\n", *content);
+    delete content;
+    content = m8r::fileToString(b);
+    EXPECT_EQ("# B\n", *content);
+    delete content;
+    EXPECT_EQ(2, countFiles(directory));
+
+    // WHEN file cannot be written
+    queue.write(directory+"/missing/c.md", new string{"# C\n"});
+    // THEN wait doesn't consume the failure and flush reports it just once
+    queue.wait();
+    vector<string> failedFiles{};
+    EXPECT_FALSE(queue.flush(&failedFiles));
+    ASSERT_EQ(1, failedFiles.size());
+    EXPECT_EQ(directory+"/missing/c.md", failedFiles[0]);
+    EXPECT_TRUE(queue.flush());
+    EXPECT_EQ(1, queue.getFailedCount());
+
+    // WHEN file cannot be written and its later write succeeds
+    queue.write(directory+"/missing/d.md", new string{"# D\n"});
+    queue.wait();
+    m8r::createDirectory(directory+"/missing");
+    queue.write(directory+"/missing/d.md", new string{"# D 2\n"});
+    // THEN file is not reported as failed
+    failedFiles.clear();
+    EXPECT_TRUE(queue.flush(&failedFiles));
+    EXPECT_TRUE(failedFiles.empty());
+    EXPECT_EQ(2, queue.getFailedCount());
+    content = m8r::fileToString(directory+"/missing/d.md");
+    EXPECT_EQ("# D 2\n", *content);
+    delete content;
+
+    // WHEN queue is destroyed w/o flush
+    {
+        m8r::WriteBehindQueue q{};
+        q.write(b, new string{"# B 2\n"});
+    }
+    // THEN pending files are written
+    content = m8r::fileToString(b);
+    EXPECT_EQ("# B 2\n", *content);
+    delete content;
+}
+
+TEST(WriteBehindQueueTestCase, RememberAndLearn)
+{
+    string repositoryDir{"/tmp/mf-unit-repository-write-behind"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string oFile{repositoryDir+"/memory/o.md"};
+    m8r::stringToFile(oFile, "# Outline\n\nText.\n\n## Note\nNote text.\n");
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-wbqtc-ral.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind{config};
+    mind.learn();
+    mind.think().get();
+    ASSERT_EQ(1, mind.remind().getOutlinesCount());
+
+    // WHEN O is changed and saved in background
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    o->setName("Renamed Outline");
+    mind.remind().remember(o->getKey());
+
+    // THEN learning (barrier) loads the saved O
+    mind.learn();
+    ASSERT_EQ(1, mind.remind().getOutlinesCount());
+    EXPECT_EQ("Renamed Outline", mind.remind().getOutlines()[0]->getName());
+}
+
+TEST(WriteBehindQueueTestCase, RememberFailure)
+{
+    string repositoryDir{"/tmp/mf-unit-repository-write-behind-failure"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    m8r::stringToFile(repositoryDir+"/memory/o.md", "# Outline\n\nText.\n\n## Note\nNote text.\n");
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-wbqtc-rf.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind{config};
+    mind.learn();
+    mind.think().get();
+    ASSERT_EQ(1, mind.remind().getOutlinesCount());
+
+    // WHEN O is saved to a file which cannot be written (replaced by directory)
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    string key{o->getKey()};
+    remove(key.c_str());
+    m8r::createDirectory(key);
+    o->setName("Lost Outline");
+    mind.remind().remember(key);
+    EXPECT_FALSE(o->isDirty());
+
+    // THEN barrier reports it and O is unsaved (dirty) again
+    vector<string> failed{};
+    EXPECT_FALSE(mind.remind().flush(&failed));
+    ASSERT_EQ(1, failed.size());
+    EXPECT_EQ(key, failed[0]);
+    EXPECT_TRUE(o->isDirty());
+    EXPECT_TRUE(mind.remind().flush());
+}
@@ -126,8 +126,15 @@ SOURCES += \
     ../benchmark/ai_benchmark.cpp \
     ./gear/file_utils_test.cpp \
     ./gear/trie_test.cpp \
+    ./gear/aho_corasick_test.cpp \
+    ./gear/async_utils_test.cpp \
+    ./gear/priority_executor_test.cpp \
     ./ai/autolinking_test.cpp \
     ./ai/autolinking_cmark_test.cpp \
+    ./ai/autolinking_index_test.cpp \
+    ./ai/autolinking_mind_test.cpp \
+    ./persistence/html_repository_export_test.cpp \
+    ./persistence/write_behind_queue_test.cpp \
     ./mind/filesystem_information_test.cpp
 
 HEADERS += \